@@ -3,6 +3,10 @@
 #include "GACharacter.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "GameAI/Combat/GAProjectile.h"
+#include "GameAI/Combat/GAProjectilePool.h"
+#include "GameAI/Spatial/GAInfluenceMap.h"
+#include "GameAI/Spatial/GAPerception.h"
 
 DEFINE_LOG_CATEGORY(LogTemplateAICharacter);
 
@@ -37,6 +41,13 @@ AGACharacter::AGACharacter()
 	MoveFrequency = 1.5f;
 	MoveAmplitude = 1.0f;
 
+	ProjectileClass = AGAProjectile::StaticClass();
+	MuzzleOffset = FVector(80.0f, 0.0f, 40.0f);
+	ProjectilePrewarmCount = 8;
+
+	SightRadius = 3000.0f;
+	InfluenceStrength = 1.0f;
+
 }
 
 void AGACharacter::BeginPlay()
@@ -44,6 +55,47 @@ void AGACharacter::BeginPlay()
 	// Call the base class  
 	Super::BeginPlay();
 
+	// Every robot tops the pool up a little, so it's sized for the robots actually in the level
+	if (UGAProjectilePoolSubsystem* Pool = GetWorld()->GetSubsystem<UGAProjectilePoolSubsystem>())
+	{
+		FGAProjectilePoolStats Stats;
+		Pool->GetPoolStats(ProjectileClass, Stats);
+		Pool->Prewarm(ProjectileClass, Stats.Total + ProjectilePrewarmCount);
+	}
+
+	if (UGAPerceptionSubsystem* Perception = GetWorld()->GetSubsystem<UGAPerceptionSubsystem>())
+	{
+		Perception->RegisterObserver(this, SightRadius);
+	}
+
+	if (InfluenceStrength > 0.0f)
+	{
+		if (UGAInfluenceMapSubsystem* InfluenceMap = GetWorld()->GetSubsystem<UGAInfluenceMapSubsystem>())
+		{
+			InfluenceMap->RegisterSource(this, GAIC_Robots, InfluenceStrength);
+		}
+	}
+}
+
+void AGACharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UGAPerceptionSubsystem* Perception = GetWorld()->GetSubsystem<UGAPerceptionSubsystem>())
+	{
+		Perception->UnregisterObserver(this);
+	}
+
+	if (UGAInfluenceMapSubsystem* InfluenceMap = GetWorld()->GetSubsystem<UGAInfluenceMapSubsystem>())
+	{
+		InfluenceMap->UnregisterSource(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool AGACharacter::CanSeeTarget() const
+{
+	const UGAPerceptionSubsystem* Perception = GetWorld() ? GetWorld()->GetSubsystem<UGAPerceptionSubsystem>() : nullptr;
+	return Perception && Perception->CanSeeTarget(this);
 }
 
 void AGACharacter::Tick(float DeltaSeconds)
@@ -51,4 +103,18 @@ void AGACharacter::Tick(float DeltaSeconds)
 	// Do nothing
 
 	Super::Tick(DeltaSeconds);
-}
\ No newline at end of file
+}
+
+AGAProjectile* AGACharacter::FireAt(const FVector& TargetPoint)
+{
+	UGAProjectilePoolSubsystem* Pool = GetWorld() ? GetWorld()->GetSubsystem<UGAProjectilePoolSubsystem>() : nullptr;
+	if (!Pool)
+	{
+		return nullptr;
+	}
+
+	FVector MuzzleLocation = GetActorLocation() + GetActorRotation().RotateVector(MuzzleOffset);
+	FRotator AimRotation = (TargetPoint - MuzzleLocation).Rotation();
+
+	return Pool->FireProjectile(ProjectileClass, MuzzleLocation, AimRotation, this, this);
+}
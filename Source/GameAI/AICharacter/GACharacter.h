@@ -7,6 +7,8 @@
 #include "Logging/LogMacros.h"
 #include "GACharacter.generated.h"
 
+class AGAProjectile;
+
 DECLARE_LOG_CATEGORY_EXTERN(LogTemplateAICharacter, Log, All);
 
 // The base class for our AI characters in CS 4150/5150
@@ -36,11 +38,41 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = -1.0, ClampMax = 1.0f))
 	float MoveAmplitude;
 
+	// Projectile fired by FireAt, taken from the projectile pool
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSubclassOf<AGAProjectile> ProjectileClass;
+
+	// Where shots leave from, relative to the character
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FVector MuzzleOffset;
+
+	// Projectiles this character adds to the pool at BeginPlay
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 ProjectilePrewarmCount;
+
+	// Fires one projectile from the muzzle towards TargetPoint
+	UFUNCTION(BlueprintCallable)
+	AGAProjectile* FireAt(const FVector& TargetPoint);
+
+	// How far this character can see, for the batched perception checks. 0 means unlimited
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float SightRadius;
+
+	// Whether the perception subsystem thinks we can see its target (the player, by default), as of this frame
+	UFUNCTION(BlueprintCallable)
+	bool CanSeeTarget() const;
+
+	// Strength of the Robots influence this character gives off. 0 for none
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float InfluenceStrength;
+
 protected:
 	
 	// To add mapping context
 	virtual void BeginPlay();
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	// Tick every frame
 	virtual void Tick(float DeltaSeconds);
 
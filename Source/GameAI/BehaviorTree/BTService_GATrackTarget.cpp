@@ -0,0 +1,88 @@
+#include "BTService_GATrackTarget.h"
+
+#include "GABTHelpers.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+
+UBTService_GATrackTarget::UBTService_GATrackTarget()
+{
+	NodeName = TEXT("Track Target");
+	Interval = 0.25f;
+	RandomDeviation = 0.05f;
+
+	bNotifyBecomeRelevant = true;
+
+	BlackboardKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(UBTService_GATrackTarget, BlackboardKey), AActor::StaticClass());
+	TargetLocationKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTService_GATrackTarget, TargetLocationKey));
+}
+
+void UBTService_GATrackTarget::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	if (const UBlackboardData* BlackboardAsset = GetBlackboardAsset())
+	{
+		TargetLocationKey.ResolveSelectedKey(*BlackboardAsset);
+	}
+}
+
+uint16 UBTService_GATrackTarget::GetInstanceMemorySize() const
+{
+	return sizeof(FTrackTargetMemory);
+}
+
+void UBTService_GATrackTarget::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FTrackTargetMemory>(NodeMemory, InitType);
+}
+
+void UBTService_GATrackTarget::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FTrackTargetMemory>(NodeMemory, CleanupType);
+}
+
+void UBTService_GATrackTarget::OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	Super::OnBecomeRelevant(OwnerComp, NodeMemory);
+
+	// Always write once on entry, whatever was left from last time
+	CastInstanceNodeMemory<FTrackTargetMemory>(NodeMemory)->LastCell = FCellRef::Invalid;
+	UpdateTarget(OwnerComp, NodeMemory);
+}
+
+void UBTService_GATrackTarget::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
+
+	UpdateTarget(OwnerComp, NodeMemory);
+}
+
+void UBTService_GATrackTarget::UpdateTarget(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
+{
+	FTrackTargetMemory* Memory = CastInstanceNodeMemory<FTrackTargetMemory>(NodeMemory);
+	UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+	UGAPathComponent* PathComponent = FGABTHelpers::FindPathComponent(OwnerComp);
+	const AGAGridActor* Grid = PathComponent ? PathComponent->GetGridActor() : nullptr;
+
+	FVector TargetLocation;
+	if (!Blackboard || !Grid || !FGABTHelpers::GetKeyLocation(Blackboard, BlackboardKey, TargetLocation))
+	{
+		return;
+	}
+
+	FCellRef Cell = Grid->GetCellRef(TargetLocation, true);
+	if (Cell != Memory->LastCell)
+	{
+		Memory->LastCell = Cell;
+		Blackboard->SetValueAsVector(TargetLocationKey.SelectedKeyName, TargetLocation);
+	}
+}
+
+FString UBTService_GATrackTarget::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("%s -> %s\n%s"), *BlackboardKey.SelectedKeyName.ToString(),
+		*TargetLocationKey.SelectedKeyName.ToString(), *Super::GetStaticDescription());
+}
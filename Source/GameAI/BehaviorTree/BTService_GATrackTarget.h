@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/Services/BTService_BlackboardBase.h"
+#include "GameAI/Grid/GAGridActor.h"
+#include "BTService_GATrackTarget.generated.h"
+
+
+// Copies the location of the actor in BlackboardKey into TargetLocationKey, but only when the actor moves into a
+// different grid cell. Decorators observing TargetLocationKey (and move tasks restarting on it) then only react to
+// moves the grid can tell apart, not every frame of motion.
+UCLASS()
+class UBTService_GATrackTarget : public UBTService_BlackboardBase
+{
+	GENERATED_BODY()
+
+public:
+	UBTService_GATrackTarget();
+
+	UPROPERTY(EditAnywhere, Category = Node)
+	FBlackboardKeySelector TargetLocationKey;
+
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
+	virtual FString GetStaticDescription() const override;
+
+protected:
+	virtual void OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+
+	struct FTrackTargetMemory
+	{
+		FCellRef LastCell;
+	};
+
+	void UpdateTarget(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const;
+};
@@ -0,0 +1,245 @@
+#include "BTTask_GAFindCell.h"
+
+#include "GABTHelpers.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+#include "Tasks/Task.h"
+
+
+// The query goes along with the job, so the layers the task builds can be cached once it's done
+struct FGAFindCellJob : public FGABTAsyncJob
+{
+	FGAPreparedSpatialQuery Prepared;
+};
+
+
+UBTTask_GAFindCell::UBTTask_GAFindCell()
+{
+	NodeName = TEXT("Find Cell");
+	SearchRadius = 20;
+
+	bNotifyTick = true;
+	bNotifyTaskFinished = true;
+
+	BlackboardKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_GAFindCell, BlackboardKey));
+	TargetKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_GAFindCell, TargetKey));
+	TargetKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_GAFindCell, TargetKey), AActor::StaticClass());
+}
+
+void UBTTask_GAFindCell::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	if (const UBlackboardData* BlackboardAsset = GetBlackboardAsset())
+	{
+		TargetKey.ResolveSelectedKey(*BlackboardAsset);
+	}
+}
+
+uint16 UBTTask_GAFindCell::GetInstanceMemorySize() const
+{
+	return sizeof(FGABTAsyncMemory);
+}
+
+void UBTTask_GAFindCell::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FGABTAsyncMemory>(NodeMemory, InitType);
+}
+
+void UBTTask_GAFindCell::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	FGABTAsyncMemory* Memory = CastInstanceNodeMemory<FGABTAsyncMemory>(NodeMemory);
+	Memory->Cancel();
+
+	// The scoring only reads what was prepared for it, but don't leave it running past the node
+	Memory->Task.Wait();
+
+	CleanupNodeMemory<FGABTAsyncMemory>(NodeMemory, CleanupType);
+}
+
+bool UBTTask_GAFindCell::StartQuery(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
+{
+	FGABTAsyncMemory* Memory = CastInstanceNodeMemory<FGABTAsyncMemory>(NodeMemory);
+	UGAPathComponent* PathComponent = FGABTHelpers::FindPathComponent(OwnerComp);
+	UWorld* World = OwnerComp.GetWorld();
+	UGASpatialEvaluatorSubsystem* Evaluator = World ? World->GetSubsystem<UGASpatialEvaluatorSubsystem>() : nullptr;
+	if (!PathComponent || !Evaluator)
+	{
+		return false;
+	}
+
+	FGASpatialQuery Query;
+	Query.TargetPoint = Memory->Goal;
+	Query.SearchRadius = SearchRadius;
+	BuildQuery(Query);
+
+	TSharedPtr<FGAFindCellJob, ESPMode::ThreadSafe> Job = MakeShared<FGAFindCellJob, ESPMode::ThreadSafe>();
+	if (!Evaluator->PrepareQuery(PathComponent, Query, Job->Prepared))
+	{
+		return false;
+	}
+
+	// Nothing else touches the job's query until the task is done
+	Memory->Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Job]()
+	{
+		if (!Job->bCancelled)
+		{
+			UGASpatialEvaluatorSubsystem::BuildPendingLayers(Job->Prepared);
+		}
+		if (!Job->bCancelled)
+		{
+			Job->bSuccess = UGASpatialEvaluatorSubsystem::EvaluatePreparedQuery(Job->Prepared, Job->Cell);
+		}
+	});
+
+	Memory->Job = Job;
+	return true;
+}
+
+EBTNodeResult::Type UBTTask_GAFindCell::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	FGABTAsyncMemory* Memory = CastInstanceNodeMemory<FGABTAsyncMemory>(NodeMemory);
+	Memory->Cancel();
+
+	if (!FGABTHelpers::GetKeyLocation(OwnerComp.GetBlackboardComponent(), TargetKey, Memory->Goal))
+	{
+		return EBTNodeResult::Failed;
+	}
+
+	return StartQuery(OwnerComp, NodeMemory) ? EBTNodeResult::InProgress : EBTNodeResult::Failed;
+}
+
+void UBTTask_GAFindCell::TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	FGABTAsyncMemory* Memory = CastInstanceNodeMemory<FGABTAsyncMemory>(NodeMemory);
+	if (!Memory->Task.IsCompleted())
+	{
+		return;
+	}
+
+	UGAPathComponent* PathComponent = FGABTHelpers::FindPathComponent(OwnerComp);
+	const AGAGridActor* Grid = PathComponent ? PathComponent->GetGridActor() : nullptr;
+	if (!Grid || !Memory->Job)
+	{
+		FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+		return;
+	}
+
+	// Share whatever the task built, whether or not it found anything. Only StartQuery makes our jobs
+	if (UGASpatialEvaluatorSubsystem* Evaluator = OwnerComp.GetWorld()->GetSubsystem<UGASpatialEvaluatorSubsystem>())
+	{
+		Evaluator->CacheBuiltLayers(Grid, StaticCastSharedPtr<FGAFindCellJob>(Memory->Job)->Prepared);
+	}
+
+	if (!Memory->Job->bSuccess)
+	{
+		FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+		return;
+	}
+
+	if (!Grid->IsCellTraversable(Memory->Job->Cell))
+	{
+		// Blocked since the query was prepared. Score again against the grid as it is now
+		if (!StartQuery(OwnerComp, NodeMemory))
+		{
+			FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+		}
+		return;
+	}
+
+	OwnerComp.GetBlackboardComponent()->SetValueAsVector(BlackboardKey.SelectedKeyName, Grid->GetCellPosition(Memory->Job->Cell));
+	FinishLatentTask(OwnerComp, EBTNodeResult::Succeeded);
+}
+
+EBTNodeResult::Type UBTTask_GAFindCell::AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	CastInstanceNodeMemory<FGABTAsyncMemory>(NodeMemory)->Cancel();
+	return EBTNodeResult::Aborted;
+}
+
+void UBTTask_GAFindCell::OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult)
+{
+	CastInstanceNodeMemory<FGABTAsyncMemory>(NodeMemory)->Cancel();
+
+	Super::OnTaskFinished(OwnerComp, NodeMemory, TaskResult);
+}
+
+FString UBTTask_GAFindCell::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("%s: %s -> %s"), *Super::GetStaticDescription(),
+		*TargetKey.SelectedKeyName.ToString(), *BlackboardKey.SelectedKeyName.ToString());
+}
+
+
+static FGASpatialTerm MakeTerm(EGASpatialLayer Layer, float Weight)
+{
+	FGASpatialTerm Term;
+	Term.Layer = Layer;
+	Term.Weight = Weight;
+	return Term;
+}
+
+
+UBTTask_GAFindBestHoldCell::UBTTask_GAFindBestHoldCell()
+{
+	NodeName = TEXT("Find Best Hold Cell");
+	PreferredDistance = 8.0f;
+	VisibilityWeight = 10.0f;
+	DistanceWeight = 1.0f;
+	TravelWeight = 0.2f;
+}
+
+void UBTTask_GAFindBestHoldCell::BuildQuery(FGASpatialQuery& Query) const
+{
+	Query.Terms.Add(MakeTerm(GASL_TargetLOS, VisibilityWeight));
+
+	// Peaks at PreferredDistance and falls off either side
+	FGASpatialTerm Distance = MakeTerm(GASL_TargetDistance, DistanceWeight);
+	Distance.Curve.Points.Add(FVector2D(0.0f, -PreferredDistance));
+	Distance.Curve.Points.Add(FVector2D(PreferredDistance, 0.0f));
+	Distance.Curve.Points.Add(FVector2D(PreferredDistance * 3.0f, -PreferredDistance * 2.0f));
+	Query.Terms.Add(Distance);
+
+	Query.Terms.Add(MakeTerm(GASL_AgentPathDistance, -TravelWeight));
+}
+
+
+UBTTask_GAFindHideCell::UBTTask_GAFindHideCell()
+{
+	NodeName = TEXT("Find Hide Cell");
+	VisibilityWeight = 10.0f;
+	TravelWeight = 0.5f;
+	ThreatWeight = 5.0f;
+}
+
+void UBTTask_GAFindHideCell::BuildQuery(FGASpatialQuery& Query) const
+{
+	Query.Terms.Add(MakeTerm(GASL_TargetLOS, -VisibilityWeight));
+	Query.Terms.Add(MakeTerm(GASL_AgentPathDistance, -TravelWeight));
+	if (ThreatWeight != 0.0f)
+	{
+		Query.Terms.Add(MakeTerm(GASL_Threat, -ThreatWeight));
+	}
+}
+
+
+UBTTask_GAFindFleeCell::UBTTask_GAFindFleeCell()
+{
+	NodeName = TEXT("Find Flee Cell");
+	EscapeWeight = 1.0f;
+	VisibilityWeight = 5.0f;
+	TravelWeight = 0.2f;
+	ThreatWeight = 5.0f;
+}
+
+void UBTTask_GAFindFleeCell::BuildQuery(FGASpatialQuery& Query) const
+{
+	Query.Terms.Add(MakeTerm(GASL_TargetPathDistance, EscapeWeight));
+	Query.Terms.Add(MakeTerm(GASL_TargetLOS, -VisibilityWeight));
+	Query.Terms.Add(MakeTerm(GASL_AgentPathDistance, -TravelWeight));
+	if (ThreatWeight != 0.0f)
+	{
+		Query.Terms.Add(MakeTerm(GASL_Threat, -ThreatWeight));
+	}
+}
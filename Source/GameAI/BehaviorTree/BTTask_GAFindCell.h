@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/Tasks/BTTask_BlackboardBase.h"
+#include "GameAI/Spatial/GASpatialEvaluator.h"
+#include "BTTask_GAFindCell.generated.h"
+
+
+// Picks a cell around the AI with the spatial evaluator and writes its position to BlackboardKey (a vector).
+// Cached layers are fetched on the game thread (see FGAGridMapCache). The rest are built on a background task from a
+// shared snapshot of the grid, and the scoring runs there too; what was built goes into the cache once it's back.
+// If the picked cell was blocked in the meantime, the query runs again. Subclasses just say what the query is.
+UCLASS(Abstract)
+class UBTTask_GAFindCell : public UBTTask_BlackboardBase
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_GAFindCell();
+
+	// What we're positioning against (a vector, or an actor)
+	UPROPERTY(EditAnywhere, Category = Node)
+	FBlackboardKeySelector TargetKey;
+
+	// Cells around the AI considered
+	UPROPERTY(EditAnywhere, Category = Node)
+	int32 SearchRadius;
+
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual EBTNodeResult::Type AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
+	virtual FString GetStaticDescription() const override;
+
+protected:
+	virtual void TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+
+	// Fills in the terms. TargetPoint and SearchRadius are already set
+	virtual void BuildQuery(FGASpatialQuery& Query) const {}
+
+	bool StartQuery(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const;
+};
+
+
+// A cell the target can see, around PreferredDistance from it, not too far for us to walk
+UCLASS()
+class UBTTask_GAFindBestHoldCell : public UBTTask_GAFindCell
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_GAFindBestHoldCell();
+
+	// In cells
+	UPROPERTY(EditAnywhere, Category = Node)
+	float PreferredDistance;
+
+	UPROPERTY(EditAnywhere, Category = Node)
+	float VisibilityWeight;
+
+	UPROPERTY(EditAnywhere, Category = Node)
+	float DistanceWeight;
+
+	// Per cell of path from the AI
+	UPROPERTY(EditAnywhere, Category = Node)
+	float TravelWeight;
+
+protected:
+	virtual void BuildQuery(FGASpatialQuery& Query) const override;
+};
+
+
+// The nearest cell the target can't see
+UCLASS()
+class UBTTask_GAFindHideCell : public UBTTask_GAFindCell
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_GAFindHideCell();
+
+	// Penalty for cells the target can see
+	UPROPERTY(EditAnywhere, Category = Node)
+	float VisibilityWeight;
+
+	UPROPERTY(EditAnywhere, Category = Node)
+	float TravelWeight;
+
+	// Penalty per unit of threat influence (projectiles in flight) over the cell. 0 to ignore it
+	UPROPERTY(EditAnywhere, Category = Node)
+	float ThreatWeight;
+
+protected:
+	virtual void BuildQuery(FGASpatialQuery& Query) const override;
+};
+
+
+// A cell far from the target by path, preferably out of its sight
+UCLASS()
+class UBTTask_GAFindFleeCell : public UBTTask_GAFindCell
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_GAFindFleeCell();
+
+	// Per cell of path between the target and the cell
+	UPROPERTY(EditAnywhere, Category = Node)
+	float EscapeWeight;
+
+	UPROPERTY(EditAnywhere, Category = Node)
+	float VisibilityWeight;
+
+	UPROPERTY(EditAnywhere, Category = Node)
+	float TravelWeight;
+
+	// Penalty per unit of threat influence (projectiles in flight) over the cell. 0 to ignore it
+	UPROPERTY(EditAnywhere, Category = Node)
+	float ThreatWeight;
+
+protected:
+	virtual void BuildQuery(FGASpatialQuery& Query) const override;
+};
@@ -0,0 +1,222 @@
+#include "BTTask_GAMoveToViaGrid.h"
+
+#include "GABTHelpers.h"
+#include "AIController.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+#include "Tasks/Task.h"
+#include "GameAI/GameAIStats.h"
+#include "GACoreSearch.h"
+
+
+UBTTask_GAMoveToViaGrid::UBTTask_GAMoveToViaGrid()
+{
+	NodeName = TEXT("Move To Via Grid");
+	AcceptableRadius = 100.0f;
+
+	bNotifyTick = true;
+	bNotifyTaskFinished = true;
+
+	BlackboardKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_GAMoveToViaGrid, BlackboardKey));
+	BlackboardKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_GAMoveToViaGrid, BlackboardKey), AActor::StaticClass());
+}
+
+uint16 UBTTask_GAMoveToViaGrid::GetInstanceMemorySize() const
+{
+	return sizeof(FGABTAsyncMemory);
+}
+
+void UBTTask_GAMoveToViaGrid::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FGABTAsyncMemory>(NodeMemory, InitType);
+}
+
+void UBTTask_GAMoveToViaGrid::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	FGABTAsyncMemory* Memory = CastInstanceNodeMemory<FGABTAsyncMemory>(NodeMemory);
+	Memory->Cancel();
+
+	// The search only reads its own copy of the grid, but don't leave it running past the node
+	Memory->Task.Wait();
+
+	CleanupNodeMemory<FGABTAsyncMemory>(NodeMemory, CleanupType);
+}
+
+bool UBTTask_GAMoveToViaGrid::StartSearch(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
+{
+	FGABTAsyncMemory* Memory = CastInstanceNodeMemory<FGABTAsyncMemory>(NodeMemory);
+	UGAPathComponent* PathComponent = FGABTHelpers::FindPathComponent(OwnerComp);
+	APawn* Pawn = OwnerComp.GetAIOwner() ? OwnerComp.GetAIOwner()->GetPawn() : nullptr;
+	const AGAGridActor* Grid = PathComponent ? PathComponent->GetGridActor() : nullptr;
+	if (!Pawn || !Grid)
+	{
+		return false;
+	}
+
+	FCellRef GoalCell = Grid->GetCellRef(Memory->Goal);
+	if (!GoalCell.IsValid() || !Grid->IsCellTraversable(GoalCell))
+	{
+		return false;
+	}
+
+	TSharedPtr<FGABTAsyncJob, ESPMode::ThreadSafe> Job = MakeShared<FGABTAsyncJob, ESPMode::ThreadSafe>();
+	Job->Cell = GoalCell;
+
+	FCellRef StartCell = Grid->GetCellRef(Pawn->GetActorLocation());
+	if (!StartCell.IsValid())
+	{
+		return false;
+	}
+
+	// The grid can be edited while this runs, so the search reads a copy of its cells, shared with every search
+	// started before the next edit. Cell positions go through the grid's transform, so the steps come back as cells
+	// only and TickTask fills in the points
+	Memory->Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Job, Cells = Grid->GetSharedCoreGrid(), StartCell, GoalCell]()
+	{
+		if (Job->bCancelled)
+		{
+			return;
+		}
+
+		static thread_local GACore::FSearchScratch Scratch;
+		static thread_local std::vector<int32_t> PathIndices;
+
+		GACore::FSearchStats Stats;
+		Job->bSuccess = GACore::FindPath(Cells->GetView(), StartCell.X, StartCell.Y, GoalCell.X, GoalCell.Y, Scratch, PathIndices, &Stats);
+		FGameAIStats::RecordSearch(Stats.NodesExpanded, Stats.HeapPushes);
+
+		// Empty if we're already in the goal cell
+		Job->Steps.SetNum(Job->bSuccess ? int32(PathIndices.size()) : 0);
+		for (int32 StepIndex = 0; StepIndex < Job->Steps.Num(); StepIndex++)
+		{
+			int32 Index = PathIndices[StepIndex];
+			Job->Steps[StepIndex].CellRef = FCellRef(Index % Cells->Width, Index / Cells->Width);
+		}
+	});
+
+	Memory->Job = Job;
+	Memory->bFollowing = false;
+	return true;
+}
+
+EBTNodeResult::Type UBTTask_GAMoveToViaGrid::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	FGABTAsyncMemory* Memory = CastInstanceNodeMemory<FGABTAsyncMemory>(NodeMemory);
+	Memory->Cancel();
+
+	APawn* Pawn = OwnerComp.GetAIOwner() ? OwnerComp.GetAIOwner()->GetPawn() : nullptr;
+	if (!Pawn || !FGABTHelpers::GetKeyLocation(OwnerComp.GetBlackboardComponent(), BlackboardKey, Memory->Goal))
+	{
+		return EBTNodeResult::Failed;
+	}
+
+	if (FVector::Dist2D(Pawn->GetActorLocation(), Memory->Goal) <= AcceptableRadius)
+	{
+		return EBTNodeResult::Succeeded;
+	}
+
+	return StartSearch(OwnerComp, NodeMemory) ? EBTNodeResult::InProgress : EBTNodeResult::Failed;
+}
+
+void UBTTask_GAMoveToViaGrid::TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	FGABTAsyncMemory* Memory = CastInstanceNodeMemory<FGABTAsyncMemory>(NodeMemory);
+	UGAPathComponent* PathComponent = FGABTHelpers::FindPathComponent(OwnerComp);
+	APawn* Pawn = OwnerComp.GetAIOwner() ? OwnerComp.GetAIOwner()->GetPawn() : nullptr;
+	const AGAGridActor* Grid = PathComponent ? PathComponent->GetGridActor() : nullptr;
+	if (!Pawn || !Grid)
+	{
+		FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+		return;
+	}
+
+	if (!Memory->bFollowing)
+	{
+		if (!Memory->Task.IsCompleted())
+		{
+			return;
+		}
+
+		if (!Memory->Job || !Memory->Job->bSuccess)
+		{
+			FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+			return;
+		}
+
+		TArray<FPathStep>& Steps = Memory->Job->Steps;
+		if (Steps.Num() == 0)
+		{
+			// Already in the goal cell. Don't leave the component following whatever it had before
+			PathComponent->ClearDestination();
+			Memory->Job.Reset();
+			FinishLatentTask(OwnerComp, EBTNodeResult::Succeeded);
+			return;
+		}
+
+		if (!FGABTHelpers::IsPathTraversable(Grid, Steps))
+		{
+			// Something blocked the path while it was being found. Search again from where we are now
+			if (!StartSearch(OwnerComp, NodeMemory))
+			{
+				FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+			}
+			return;
+		}
+
+		TArray<FCellRef> Cells;
+		Cells.Reserve(Steps.Num());
+		for (const FPathStep& Step : Steps)
+		{
+			Cells.Add(Step.CellRef);
+		}
+
+		TArray<FVector> Points;
+		Grid->GetCellPositions(Cells, Points);
+		for (int32 StepIndex = 0; StepIndex < Steps.Num(); StepIndex++)
+		{
+			Steps[StepIndex].Point = Points[StepIndex];
+		}
+
+		// Hand over the path first, so SetDestination finds it already in place
+		PathComponent->SetSteps(Steps);
+		PathComponent->SetDestination(Memory->Goal);
+		Memory->Job.Reset();
+		Memory->bFollowing = true;
+	}
+
+	if (FVector::Dist2D(Pawn->GetActorLocation(), Memory->Goal) <= AcceptableRadius || PathComponent->State == GAPS_Finished)
+	{
+		FinishLatentTask(OwnerComp, EBTNodeResult::Succeeded);
+	}
+	else if (PathComponent->State == GAPS_Invalid)
+	{
+		FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+	}
+}
+
+EBTNodeResult::Type UBTTask_GAMoveToViaGrid::AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	FGABTAsyncMemory* Memory = CastInstanceNodeMemory<FGABTAsyncMemory>(NodeMemory);
+	Memory->Cancel();
+
+	if (UGAPathComponent* PathComponent = FGABTHelpers::FindPathComponent(OwnerComp))
+	{
+		PathComponent->ClearDestination();
+	}
+
+	return EBTNodeResult::Aborted;
+}
+
+void UBTTask_GAMoveToViaGrid::OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult)
+{
+	// The task itself may still be running if we were cancelled. It only touches the job, which it keeps alive
+	CastInstanceNodeMemory<FGABTAsyncMemory>(NodeMemory)->Cancel();
+
+	Super::OnTaskFinished(OwnerComp, NodeMemory, TaskResult);
+}
+
+FString UBTTask_GAMoveToViaGrid::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("%s: %s (within %.0f)"), *Super::GetStaticDescription(), *BlackboardKey.SelectedKeyName.ToString(), AcceptableRadius);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/Tasks/BTTask_BlackboardBase.h"
+#include "BTTask_GAMoveToViaGrid.generated.h"
+
+
+// Moves the AI along a grid path to the location in BlackboardKey (a vector, or an actor).
+// The path search (A* to the goal cell) runs on a background task, over a copy of the grid taken when it started.
+// Once it's back, the path is handed to the controller's (or pawn's) UGAPathComponent, and the task finishes
+// when the component reports it arrived. If the grid changed in the meantime, the path is still used as long as
+// every cell on it is traversable; only a path that got cut is searched for again.
+UCLASS()
+class UBTTask_GAMoveToViaGrid : public UBTTask_BlackboardBase
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_GAMoveToViaGrid();
+
+	// Succeed as soon as we're this close (world units) to the goal
+	UPROPERTY(EditAnywhere, Category = Node)
+	float AcceptableRadius;
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual EBTNodeResult::Type AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
+	virtual FString GetStaticDescription() const override;
+
+protected:
+	virtual void TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+
+	bool StartSearch(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const;
+};
@@ -0,0 +1,69 @@
+#include "GABTHelpers.h"
+
+#include "AIController.h"
+#include "AISystem.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+
+UGAPathComponent* FGABTHelpers::FindPathComponent(const UBehaviorTreeComponent& OwnerComp)
+{
+	AAIController* Controller = OwnerComp.GetAIOwner();
+	if (!Controller)
+	{
+		return nullptr;
+	}
+
+	UGAPathComponent* PathComponent = Controller->FindComponentByClass<UGAPathComponent>();
+	if (!PathComponent && Controller->GetPawn())
+	{
+		PathComponent = Controller->GetPawn()->FindComponentByClass<UGAPathComponent>();
+	}
+
+	return PathComponent;
+}
+
+bool FGABTHelpers::IsPathTraversable(const AGAGridActor* Grid, const TArray<FPathStep>& Steps)
+{
+	if (!Grid)
+	{
+		return false;
+	}
+
+	for (const FPathStep& Step : Steps)
+	{
+		if (!Grid->IsCellTraversable(Step.CellRef))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FGABTHelpers::GetKeyLocation(const UBlackboardComponent* Blackboard, const FBlackboardKeySelector& Key, FVector& LocationOut)
+{
+	if (!Blackboard)
+	{
+		return false;
+	}
+
+	if (Key.SelectedKeyType == UBlackboardKeyType_Vector::StaticClass())
+	{
+		LocationOut = Blackboard->GetValueAsVector(Key.SelectedKeyName);
+		return FAISystem::IsValidLocation(LocationOut);
+	}
+
+	if (Key.SelectedKeyType == UBlackboardKeyType_Object::StaticClass())
+	{
+		const AActor* Actor = Cast<AActor>(Blackboard->GetValueAsObject(Key.SelectedKeyName));
+		if (Actor)
+		{
+			LocationOut = Actor->GetActorLocation();
+			return true;
+		}
+	}
+
+	return false;
+}
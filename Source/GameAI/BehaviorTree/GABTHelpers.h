@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include "GameAI/Pathfinding/GAPathComponent.h"
+
+class UBehaviorTreeComponent;
+class UBlackboardComponent;
+struct FBlackboardKeySelector;
+
+
+// Work handed off to a background task by one of our behavior tree nodes. The node and the task share it; the
+// node sets bCancelled if it's aborted, and just drops its reference -- the task sees the flag (or finishes and
+// nobody reads the result).
+// The task only reads copies of the grid data taken when it was launched, never the live grid. The grid can still
+// change before the result is back, so the node checks it against the grid as it is then before using it
+struct FGABTAsyncJob
+{
+	std::atomic<bool> bCancelled = false;
+
+	bool bSuccess = false;
+	FCellRef Cell;
+	TArray<FPathStep> Steps;
+};
+
+// Node memory for the async nodes
+struct FGABTAsyncMemory
+{
+	TSharedPtr<FGABTAsyncJob, ESPMode::ThreadSafe> Job;
+	UE::Tasks::FTask Task;
+
+	// Where we asked to go, and whether we're past the search and following the path now
+	FVector Goal = FVector::ZeroVector;
+	bool bFollowing = false;
+
+	void Cancel()
+	{
+		if (Job)
+		{
+			Job->bCancelled = true;
+			Job.Reset();
+		}
+		bFollowing = false;
+	}
+};
+
+
+struct FGABTHelpers
+{
+	// The path component lives on the controller, usually, but may be on the pawn
+	static UGAPathComponent* FindPathComponent(const UBehaviorTreeComponent& OwnerComp);
+
+	// The location of a vector key, or of the actor in an object key
+	static bool GetKeyLocation(const UBlackboardComponent* Blackboard, const FBlackboardKeySelector& Key, FVector& LocationOut);
+
+	// Are all the path's cells still traversable? A path found on a copy of the grid is checked with this once
+	// it's back, and only searched for again if a change actually cut it
+	static bool IsPathTraversable(const AGAGridActor* Grid, const TArray<FPathStep>& Steps);
+};
@@ -0,0 +1,564 @@
+#include "GAPathBenchmarkCommandlet.h"
+
+#include "GameAI/Grid/GAGridActor.h"
+#include "GameAI/Pathfinding/GAPathComponent.h"
+#include "GameAI/GameAIStats.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Math/RandomStream.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+
+
+// One grid to benchmark
+struct FGAPathBenchmarkScenario
+{
+	FString Name;
+	int32 Size = 0;
+	float Density = 0.0f;
+};
+
+struct FGAPathBenchmarkQuery
+{
+	FCellRef Start;
+	FCellRef Goal;
+};
+
+// What one query did
+struct FGAPathBenchmarkSample
+{
+	double Micros = 0.0;
+	int32 NodesExpanded = 0;
+	int32 HeapPushes = 0;
+	int32 LineTraces = 0;
+	int32 PathLength = 0;
+
+	// Size of whatever the search handed back (steps, distance map, predecessors)
+	int64 ResultBytes = 0;
+
+	bool bSuccess = false;
+};
+
+
+// Grid generation --------------------------------
+
+// Square rooms with a doorway through each wall
+static void BuildRooms(TArray<uint8>& OpenOut, int32 Size, FRandomStream& Random)
+{
+	const int32 RoomSize = 12;
+	const int32 RoomCount = FMath::Max(Size / RoomSize, 1);
+
+	for (int32 Y = 0; Y < Size; Y++)
+	{
+		for (int32 X = 0; X < Size; X++)
+		{
+			OpenOut[Y * Size + X] = (X % RoomSize != 0 && Y % RoomSize != 0) ? 1 : 0;
+		}
+	}
+
+	for (int32 RoomY = 0; RoomY < RoomCount; RoomY++)
+	{
+		for (int32 RoomX = 0; RoomX < RoomCount; RoomX++)
+		{
+			// Two cells wide, through the room's right and bottom walls
+			int32 WallX = (RoomX + 1) * RoomSize;
+			int32 WallY = (RoomY + 1) * RoomSize;
+			int32 DoorY = RoomY * RoomSize + Random.RandRange(1, RoomSize - 2);
+			int32 DoorX = RoomX * RoomSize + Random.RandRange(1, RoomSize - 2);
+
+			for (int32 Offset = 0; Offset < 2; Offset++)
+			{
+				if (WallX < Size - 1 && DoorY + Offset < Size)
+				{
+					OpenOut[(DoorY + Offset) * Size + WallX] = 1;
+				}
+				if (WallY < Size - 1 && DoorX + Offset < Size)
+				{
+					OpenOut[WallY * Size + DoorX + Offset] = 1;
+				}
+			}
+		}
+	}
+}
+
+// One-cell corridors carved by a randomized depth-first search, so there's exactly one route between any two cells
+static void BuildMaze(TArray<uint8>& OpenOut, int32 Size, FRandomStream& Random)
+{
+	FMemory::Memzero(OpenOut.GetData(), OpenOut.Num());
+
+	// Maze cells sit on odd coordinates, with the walls between them on even ones
+	const int32 MazeCount = (Size - 1) / 2;
+	if (MazeCount <= 0)
+	{
+		return;
+	}
+
+	TBitArray<> Visited(false, MazeCount * MazeCount);
+	TArray<FIntPoint> Stack;
+	Stack.Add(FIntPoint(0, 0));
+	Visited[0] = true;
+	OpenOut[1 * Size + 1] = 1;
+
+	static const FIntPoint Directions[4] = { FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1) };
+
+	while (Stack.Num() > 0)
+	{
+		FIntPoint Current = Stack.Last();
+
+		FIntPoint Candidates[4];
+		int32 CandidateCount = 0;
+		for (const FIntPoint& Direction : Directions)
+		{
+			FIntPoint Next = Current + Direction;
+			if (Next.X >= 0 && Next.Y >= 0 && Next.X < MazeCount && Next.Y < MazeCount && !Visited[Next.Y * MazeCount + Next.X])
+			{
+				Candidates[CandidateCount++] = Next;
+			}
+		}
+
+		if (CandidateCount == 0)
+		{
+			Stack.Pop(EAllowShrinking::No);
+			continue;
+		}
+
+		FIntPoint Next = Candidates[Random.RandRange(0, CandidateCount - 1)];
+		Visited[Next.Y * MazeCount + Next.X] = true;
+
+		// Open the cell and the wall between
+		OpenOut[(2 * Next.Y + 1) * Size + 2 * Next.X + 1] = 1;
+		OpenOut[(Current.Y + Next.Y + 1) * Size + Current.X + Next.X + 1] = 1;
+		Stack.Add(Next);
+	}
+}
+
+static void BuildRandom(TArray<uint8>& OpenOut, int32 Size, float Density, FRandomStream& Random)
+{
+	for (int32 Index = 0; Index < Size * Size; Index++)
+	{
+		OpenOut[Index] = (Random.GetFraction() >= Density) ? 1 : 0;
+	}
+}
+
+static bool BuildScenarioGrid(AGAGridActor* Grid, const FGAPathBenchmarkScenario& Scenario, int32 Seed)
+{
+	if (!Grid->ResizeGrid(Scenario.Size, Scenario.Size, 100.0f))
+	{
+		return false;
+	}
+
+	FRandomStream Random(Seed);
+	TArray<uint8> Open;
+	Open.SetNumZeroed(Scenario.Size * Scenario.Size);
+
+	if (Scenario.Name == TEXT("Rooms"))
+	{
+		BuildRooms(Open, Scenario.Size, Random);
+	}
+	else if (Scenario.Name == TEXT("Maze"))
+	{
+		BuildMaze(Open, Scenario.Size, Random);
+	}
+	else
+	{
+		BuildRandom(Open, Scenario.Size, Scenario.Density, Random);
+	}
+
+	for (int32 Index = 0; Index < Open.Num(); Index++)
+	{
+		Grid->Data[Index] = Open[Index] ? ECellData::CellDataTraversable : ECellData::CellDataNone;
+	}
+
+	Grid->NotifyCellsChanged(FIntRect(0, 0, Scenario.Size - 1, Scenario.Size - 1));
+	return true;
+}
+
+
+// Queries --------------------------------
+
+// Start/goal pairs drawn from the largest connected region, so every query has an answer and the numbers stay
+// comparable between grids
+static void GenerateQueries(const AGAGridActor* Grid, int32 QueryCount, int32 Seed, TArray<FGAPathBenchmarkQuery>& QueriesOut)
+{
+	QueriesOut.Reset();
+
+	const int32 CellCount = Grid->XCount * Grid->YCount;
+	TArray<int32> Labels;
+	Labels.Init(INDEX_NONE, CellCount);
+
+	TArray<int32> Largest;
+	TArray<int32> Region;
+	TArray<int32> Frontier;
+	for (int32 Seedling = 0; Seedling < CellCount; Seedling++)
+	{
+		FCellRef SeedCell(Seedling % Grid->XCount, Seedling / Grid->XCount);
+		if (Labels[Seedling] != INDEX_NONE || !Grid->IsCellTraversable(SeedCell))
+		{
+			continue;
+		}
+
+		Region.Reset();
+		Frontier.Reset();
+		Frontier.Add(Seedling);
+		Labels[Seedling] = Seedling;
+		while (Frontier.Num() > 0)
+		{
+			int32 Index = Frontier.Pop(EAllowShrinking::No);
+			Region.Add(Index);
+
+			// Same 4-neighbourhood as the searches
+			int32 X = Index % Grid->XCount;
+			int32 Y = Index / Grid->XCount;
+			const FCellRef Neighbours[4] = { FCellRef(X + 1, Y), FCellRef(X - 1, Y), FCellRef(X, Y + 1), FCellRef(X, Y - 1) };
+			for (const FCellRef& Neighbour : Neighbours)
+			{
+				if (Grid->IsCellTraversable(Neighbour) && Labels[Grid->CellRefToIndex(Neighbour)] == INDEX_NONE)
+				{
+					Labels[Grid->CellRefToIndex(Neighbour)] = Seedling;
+					Frontier.Add(Grid->CellRefToIndex(Neighbour));
+				}
+			}
+		}
+
+		if (Region.Num() > Largest.Num())
+		{
+			Swap(Region, Largest);
+		}
+	}
+
+	if (Largest.Num() < 2)
+	{
+		return;
+	}
+
+	FRandomStream Random(Seed);
+	QueriesOut.Reserve(QueryCount);
+	while (QueriesOut.Num() < QueryCount)
+	{
+		int32 Start = Largest[Random.RandRange(0, Largest.Num() - 1)];
+		int32 Goal = Largest[Random.RandRange(0, Largest.Num() - 1)];
+		if (Start != Goal)
+		{
+			FGAPathBenchmarkQuery& Query = QueriesOut.AddDefaulted_GetRef();
+			Query.Start = FCellRef(Start % Grid->XCount, Start / Grid->XCount);
+			Query.Goal = FCellRef(Goal % Grid->XCount, Goal / Grid->XCount);
+		}
+	}
+}
+
+
+// Running --------------------------------
+
+// Runs Body on every query, after Warmup untimed runs, and times each one
+template <typename BodyType>
+static void RunQueries(const TArray<FGAPathBenchmarkQuery>& Queries, int32 Warmup, TArray<FGAPathBenchmarkSample>& SamplesOut, BodyType&& Body)
+{
+	for (int32 Index = 0; Index < FMath::Min(Warmup, Queries.Num()); Index++)
+	{
+		FGAPathBenchmarkSample Ignored;
+		Body(Index, Ignored, [] {}, [] {});
+	}
+
+	SamplesOut.Reset();
+	SamplesOut.SetNum(Queries.Num());
+	for (int32 Index = 0; Index < Queries.Num(); Index++)
+	{
+		FGAPathBenchmarkSample& Sample = SamplesOut[Index];
+		FGameAIStats::LastSearch = FGameAISearchCounts();
+
+		uint64 StartCycles = 0;
+		uint64 EndCycles = 0;
+		Body(Index, Sample, [&StartCycles] { StartCycles = FPlatformTime::Cycles64(); }, [&EndCycles] { EndCycles = FPlatformTime::Cycles64(); });
+
+		Sample.Micros = 1000.0 * FPlatformTime::ToMilliseconds64(EndCycles - StartCycles);
+		Sample.NodesExpanded = FGameAIStats::LastSearch.NodesExpanded;
+		Sample.HeapPushes = FGameAIStats::LastSearch.HeapPushes;
+		Sample.LineTraces = FGameAIStats::LastSearch.LineTraces;
+	}
+}
+
+static double Percentile(const TArray<double>& Sorted, double Fraction)
+{
+	if (Sorted.Num() == 0)
+	{
+		return 0.0;
+	}
+	int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+	return Sorted[Index];
+}
+
+static FString CsvHeader()
+{
+	return TEXT("Scenario,Width,Height,Density,Seed,Algorithm,Queries,Succeeded,MeanUs,P50Us,P90Us,P99Us,MaxUs,")
+		TEXT("MeanNodes,MaxNodes,MeanHeapPushes,MeanLineTraces,MeanPathLength,MeanResultKB,GridKB,ProcessUsedMB\n");
+}
+
+static FString SummarizeSamples(const FGAPathBenchmarkScenario& Scenario, const AGAGridActor* Grid, int32 Seed, const TCHAR* Algorithm, const TArray<FGAPathBenchmarkSample>& Samples)
+{
+	TArray<double> Latencies;
+	double TotalMicros = 0.0;
+	int64 TotalNodes = 0;
+	int32 MaxNodes = 0;
+	int64 TotalPushes = 0;
+	int64 TotalTraces = 0;
+	int64 TotalPathLength = 0;
+	int64 TotalResultBytes = 0;
+	int32 Succeeded = 0;
+	for (const FGAPathBenchmarkSample& Sample : Samples)
+	{
+		Latencies.Add(Sample.Micros);
+		TotalMicros += Sample.Micros;
+		TotalNodes += Sample.NodesExpanded;
+		MaxNodes = FMath::Max(MaxNodes, Sample.NodesExpanded);
+		TotalPushes += Sample.HeapPushes;
+		TotalTraces += Sample.LineTraces;
+		TotalPathLength += Sample.PathLength;
+		TotalResultBytes += Sample.ResultBytes;
+		Succeeded += Sample.bSuccess ? 1 : 0;
+	}
+	Latencies.Sort();
+
+	double Count = FMath::Max(Samples.Num(), 1);
+	int64 GridBytes = Grid->Data.GetAllocatedSize() + Grid->HeightData.GetAllocatedSize();
+
+	FString Row = FString::Printf(TEXT("%s,%d,%d,%.2f,%d,%s,%d,%d,%.2f,%.2f,%.2f,%.2f,%.2f,%.1f,%d,%.1f,%.1f,%.1f,%.2f,%.2f,%.1f\n"),
+		*Scenario.Name, Grid->XCount, Grid->YCount, Scenario.Density, Seed, Algorithm, Samples.Num(), Succeeded,
+		TotalMicros / Count, Percentile(Latencies, 0.5), Percentile(Latencies, 0.9), Percentile(Latencies, 0.99), Percentile(Latencies, 1.0),
+		TotalNodes / Count, MaxNodes, TotalPushes / Count, TotalTraces / Count, TotalPathLength / Count,
+		TotalResultBytes / Count / 1024.0, GridBytes / 1024.0, FPlatformMemory::GetStats().UsedPhysical / (1024.0 * 1024.0));
+
+	UE_LOG(LogTemp, Display, TEXT("GAPathBenchmark: %s %dx%d (%.2f) %s: %d/%d succeeded, p50 %.1f us, p99 %.1f us, %.0f nodes"),
+		*Scenario.Name, Grid->XCount, Grid->YCount, Scenario.Density, Algorithm, Succeeded, Samples.Num(),
+		Percentile(Latencies, 0.5), Percentile(Latencies, 0.99), TotalNodes / Count);
+
+	return Row;
+}
+
+static void BenchmarkGrid(const FGAPathBenchmarkScenario& Scenario, AGAGridActor* Grid, int32 QueryCount, int32 Warmup, int32 Seed, FString& CsvOut)
+{
+	TArray<FGAPathBenchmarkQuery> Queries;
+	GenerateQueries(Grid, QueryCount, Seed, Queries);
+	if (Queries.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GAPathBenchmark: %s %dx%d has no connected cells to query, skipping"), *Scenario.Name, Grid->XCount, Grid->YCount);
+		return;
+	}
+
+	// Only used for its searches. Never registered, so it doesn't tick
+	UGAPathComponent* Pathfinder = NewObject<UGAPathComponent>(Grid);
+	Pathfinder->GridActor = Grid;
+
+	TArray<FGAPathBenchmarkSample> Samples;
+	TArray<TArray<FPathStep>> Paths;
+	Paths.SetNum(Queries.Num());
+
+	// AStar. Its paths are kept, to be smoothed below
+	RunQueries(Queries, Warmup, Samples, [&](int32 Index, FGAPathBenchmarkSample& Sample, auto&& Begin, auto&& End)
+	{
+		const FGAPathBenchmarkQuery& Query = Queries[Index];
+		Pathfinder->DestinationCell = Query.Goal;
+		Pathfinder->Destination = Grid->GetCellPosition(Query.Goal);
+		FVector StartPoint = Grid->GetCellPosition(Query.Start);
+		TArray<FPathStep>& Steps = Paths[Index];
+
+		Begin();
+		EGAPathState Result = Pathfinder->AStar(StartPoint, Steps);
+		End();
+
+		Sample.bSuccess = (Result == GAPS_Active) && Steps.Num() > 0 && Steps.Last().CellRef == Query.Goal;
+		Sample.PathLength = Steps.Num();
+		Sample.ResultBytes = Steps.GetAllocatedSize();
+	});
+	CsvOut += SummarizeSamples(Scenario, Grid, Seed, TEXT("AStar"), Samples);
+
+	RunQueries(Queries, Warmup, Samples, [&](int32 Index, FGAPathBenchmarkSample& Sample, auto&& Begin, auto&& End)
+	{
+		FVector StartPoint = Grid->GetCellPosition(Queries[Index].Start);
+		TArray<FPathStep> Smoothed;
+
+		Begin();
+		EGAPathState Result = Pathfinder->SmoothPath(StartPoint, Paths[Index], Smoothed);
+		End();
+
+		Sample.bSuccess = (Result != GAPS_Invalid) && Smoothed.Num() > 0;
+		Sample.PathLength = Smoothed.Num();
+		Sample.ResultBytes = Smoothed.GetAllocatedSize();
+	});
+	CsvOut += SummarizeSamples(Scenario, Grid, Seed, TEXT("SmoothPath"), Samples);
+
+	// Full-grid flood into a fresh map, the way the behavior tree and spatial layers call it
+	FGridBox FullBox(0, Grid->XCount - 1, 0, Grid->YCount - 1);
+	RunQueries(Queries, Warmup, Samples, [&](int32 Index, FGAPathBenchmarkSample& Sample, auto&& Begin, auto&& End)
+	{
+		const FGAPathBenchmarkQuery& Query = Queries[Index];
+		FGAGridMap DistanceMap(Grid, FullBox, INFINITY);
+		FVector StartPoint = Grid->GetCellPosition(Query.Start);
+
+		Begin();
+		bool bResult = Pathfinder->Dijkstra(StartPoint, DistanceMap, Grid);
+		End();
+
+		float GoalDistance = INFINITY;
+		DistanceMap.GetValue(Query.Goal, GoalDistance);
+		Sample.bSuccess = bResult && GoalDistance < INFINITY;
+		Sample.ResultBytes = DistanceMap.Data.GetAllocatedSize();
+	});
+	CsvOut += SummarizeSamples(Scenario, Grid, Seed, TEXT("Dijkstra"), Samples);
+
+	// Bucket-queue Dijkstra, reusing one result between queries like its callers do
+	FGADijkstraResult Bounded;
+	RunQueries(Queries, Warmup, Samples, [&](int32 Index, FGAPathBenchmarkSample& Sample, auto&& Begin, auto&& End)
+	{
+		const FGAPathBenchmarkQuery& Query = Queries[Index];
+
+		Begin();
+		bool bResult = Pathfinder->DijkstraBounded(Query.Start, Grid, Bounded);
+		End();
+
+		Sample.bSuccess = bResult && Bounded.GetDistance(Query.Goal) < INFINITY;
+		Sample.ResultBytes = Bounded.Predecessors.GetAllocatedSize() + (Bounded.DistanceMap.IsSet() ? Bounded.DistanceMap->Data.GetAllocatedSize() : 0);
+	});
+	CsvOut += SummarizeSamples(Scenario, Grid, Seed, TEXT("DijkstraBounded"), Samples);
+
+	Pathfinder->MarkAsGarbage();
+}
+
+
+// Setup --------------------------------
+
+static UWorld::InitializationValues BenchmarkWorldValues()
+{
+	// Nothing but the actors: the searches only read the grid
+	return UWorld::InitializationValues()
+		.AllowAudioPlayback(false)
+		.RequiresHitProxies(false)
+		.CreatePhysicsScene(false)
+		.CreateNavigation(false)
+		.CreateAISystem(false)
+		.ShouldSimulatePhysics(false)
+		.EnableTraceCollision(false)
+		.SetTransactional(false)
+		.CreateFXSystem(false);
+}
+
+static void DestroyBenchmarkWorld(UWorld* World)
+{
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+static void ParseList(const FString& Params, const TCHAR* Match, TArray<FString>& ValuesOut)
+{
+	FString Value;
+	if (FParse::Value(*Params, Match, Value, false))
+	{
+		ValuesOut.Reset();
+		Value.ParseIntoArray(ValuesOut, TEXT(","));
+	}
+}
+
+
+UGAPathBenchmarkCommandlet::UGAPathBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UGAPathBenchmarkCommandlet::Main(const FString& Params)
+{
+	TArray<FString> ScenarioNames = { TEXT("Rooms"), TEXT("Maze"), TEXT("Random") };
+	TArray<FString> Sizes = { TEXT("64"), TEXT("128"), TEXT("256") };
+	TArray<FString> Densities = { TEXT("0.1"), TEXT("0.2"), TEXT("0.3") };
+	ParseList(Params, TEXT("Scenarios="), ScenarioNames);
+	ParseList(Params, TEXT("Sizes="), Sizes);
+	ParseList(Params, TEXT("Densities="), Densities);
+
+	int32 QueryCount = 200;
+	int32 Warmup = 10;
+	int32 Seed = 1234;
+	FParse::Value(*Params, TEXT("Queries="), QueryCount);
+	FParse::Value(*Params, TEXT("Warmup="), Warmup);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+
+	FString OutputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"), FString::Printf(TEXT("PathBenchmark-%s.csv"), *FDateTime::Now().ToString()));
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	FString Csv = CsvHeader();
+
+	FString MapName;
+	if (FParse::Value(*Params, TEXT("Map="), MapName))
+	{
+		UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+		UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+		if (!World)
+		{
+			UE_LOG(LogTemp, Error, TEXT("GAPathBenchmark: couldn't load map %s"), *MapName);
+			return 1;
+		}
+
+		World->AddToRoot();
+		World->InitWorld(BenchmarkWorldValues());
+		World->UpdateWorldComponents(true, false);
+
+		TActorIterator<AGAGridActor> It(World);
+		AGAGridActor* Grid = It ? *It : nullptr;
+		if (!Grid || Grid->Data.Num() != Grid->XCount * Grid->YCount)
+		{
+			UE_LOG(LogTemp, Error, TEXT("GAPathBenchmark: %s has no grid actor with data"), *MapName);
+			DestroyBenchmarkWorld(World);
+			return 1;
+		}
+
+		FGAPathBenchmarkScenario Scenario;
+		Scenario.Name = FPaths::GetBaseFilename(MapName);
+		Scenario.Size = Grid->XCount;
+		BenchmarkGrid(Scenario, Grid, QueryCount, Warmup, Seed, Csv);
+
+		DestroyBenchmarkWorld(World);
+	}
+	else
+	{
+		UWorld::InitializationValues WorldValues = BenchmarkWorldValues();
+		UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("GAPathBenchmark"), nullptr, true, ERHIFeatureLevel::Num, &WorldValues);
+		AGAGridActor* Grid = World->SpawnActor<AGAGridActor>();
+
+		for (const FString& Size : Sizes)
+		{
+			for (const FString& Name : ScenarioNames)
+			{
+				// Only the random grids vary by density
+				TArray<FString> ScenarioDensities = (Name == TEXT("Random")) ? Densities : TArray<FString>({ TEXT("0") });
+				for (const FString& Density : ScenarioDensities)
+				{
+					FGAPathBenchmarkScenario Scenario;
+					Scenario.Name = Name;
+					Scenario.Size = FCString::Atoi(*Size);
+					Scenario.Density = FCString::Atof(*Density);
+
+					if (!BuildScenarioGrid(Grid, Scenario, Seed))
+					{
+						UE_LOG(LogTemp, Warning, TEXT("GAPathBenchmark: bad grid size %s, skipping"), *Size);
+						continue;
+					}
+					BenchmarkGrid(Scenario, Grid, QueryCount, Warmup, Seed, Csv);
+				}
+			}
+		}
+
+		DestroyBenchmarkWorld(World);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *OutputPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("GAPathBenchmark: couldn't write %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("GAPathBenchmark: wrote %s"), *OutputPath);
+	return 0;
+}
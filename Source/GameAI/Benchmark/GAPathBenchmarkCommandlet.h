@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GAPathBenchmarkCommandlet.generated.h"
+
+
+// Headless pathfinding benchmark, for numbers that can be compared from one build to the next.
+//
+// Builds synthetic grids (rooms, mazes and random obstacles at several densities and sizes), or uses the grid
+// actor in a map, and runs the same seeded set of start/goal pairs through AStar, SmoothPath, Dijkstra and
+// DijkstraBounded. Writes one CSV row per grid and search: latency percentiles per query, nodes expanded, and
+// memory.
+//
+//   UnrealEditor-Cmd GameAI.uproject -run=GAPathBenchmark -nullrhi -unattended [options]
+//
+//   -Scenarios=Rooms,Maze,Random	Which synthetic grids to build
+//   -Sizes=64,128,256				Grid sizes (cells per side)
+//   -Densities=0.1,0.2,0.3			Obstacle densities for the random grids
+//   -Queries=200					Start/goal pairs per grid
+//   -Warmup=10						Untimed runs before each search is measured
+//   -Seed=1234
+//   -Map=/Game/Maps/SomeMap		Benchmark the grid in this map instead of synthetic ones
+//   -Output=Path.csv				Defaults to Saved/Benchmarks/PathBenchmark-<timestamp>.csv
+UCLASS()
+class UGAPathBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGAPathBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
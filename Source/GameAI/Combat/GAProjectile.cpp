@@ -0,0 +1,113 @@
+#include "GAProjectile.h"
+
+#include "GAProjectilePool.h"
+#include "GameAI/Spatial/GAInfluenceMap.h"
+#include "Components/SphereComponent.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "TimerManager.h"
+
+
+AGAProjectile::AGAProjectile()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	CollisionComponent = CreateDefaultSubobject<USphereComponent>(TEXT("CollisionComponent"));
+	CollisionComponent->InitSphereRadius(8.0f);
+	CollisionComponent->SetCollisionProfileName(TEXT("BlockAllDynamic"));
+	CollisionComponent->SetNotifyRigidBodyCollision(true);
+	RootComponent = CollisionComponent;
+
+	ProjectileMovement = CreateDefaultSubobject<UProjectileMovementComponent>(TEXT("ProjectileMovement"));
+	ProjectileMovement->SetUpdatedComponent(CollisionComponent);
+	ProjectileMovement->InitialSpeed = 3000.0f;
+	ProjectileMovement->MaxSpeed = 3000.0f;
+	ProjectileMovement->ProjectileGravityScale = 0.0f;
+	ProjectileMovement->bRotationFollowsVelocity = true;
+
+	// Launch turns it on
+	ProjectileMovement->bAutoActivate = false;
+
+	Damage = 10.0f;
+	Lifetime = 3.0f;
+	ThreatStrength = 1.0f;
+}
+
+void AGAProjectile::Launch(const FVector& Location, const FRotator& Rotation, AActor* InOwner, APawn* InInstigator)
+{
+	SetOwner(InOwner);
+	SetInstigator(InInstigator);
+
+	// Don't shoot ourselves on the way out
+	CollisionComponent->ClearMoveIgnoreActors();
+	if (InInstigator)
+	{
+		CollisionComponent->IgnoreActorWhenMoving(InInstigator, true);
+	}
+
+	SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	CollisionComponent->OnComponentHit.AddUniqueDynamic(this, &AGAProjectile::OnHit);
+
+	ProjectileMovement->SetUpdatedComponent(CollisionComponent);
+	ProjectileMovement->Velocity = Rotation.Vector() * ProjectileMovement->InitialSpeed;
+	ProjectileMovement->Activate(true);
+
+	GetWorldTimerManager().SetTimer(LifetimeTimer, this, &AGAProjectile::Release, Lifetime, false);
+
+	if (ThreatStrength > 0.0f)
+	{
+		if (UGAInfluenceMapSubsystem* InfluenceMap = GetWorld()->GetSubsystem<UGAInfluenceMapSubsystem>())
+		{
+			InfluenceMap->RegisterSource(this, GAIC_Threat, ThreatStrength);
+		}
+	}
+
+	bInFlight = true;
+}
+
+void AGAProjectile::Deactivate()
+{
+	bInFlight = false;
+
+	GetWorldTimerManager().ClearTimer(LifetimeTimer);
+
+	ProjectileMovement->StopMovementImmediately();
+	ProjectileMovement->Deactivate();
+	SetActorEnableCollision(false);
+	SetActorHiddenInGame(true);
+
+	if (UGAInfluenceMapSubsystem* InfluenceMap = GetWorld()->GetSubsystem<UGAInfluenceMapSubsystem>())
+	{
+		InfluenceMap->UnregisterSource(this);
+	}
+}
+
+void AGAProjectile::Release()
+{
+	if (UGAProjectilePoolSubsystem* Pool = GetWorld()->GetSubsystem<UGAProjectilePoolSubsystem>())
+	{
+		Pool->ReleaseProjectile(this);
+	}
+	else
+	{
+		Destroy();
+	}
+}
+
+void AGAProjectile::OnHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
+{
+	if (!bInFlight)
+	{
+		return;
+	}
+
+	if (OtherActor && OtherActor != this && Damage > 0.0f)
+	{
+		UGameplayStatics::ApplyPointDamage(OtherActor, Damage, GetActorForwardVector(), Hit, GetInstigatorController(), this, nullptr);
+	}
+
+	OnImpact(Hit);
+	Release();
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "GAProjectile.generated.h"
+
+class USphereComponent;
+class UProjectileMovementComponent;
+
+
+// A projectile that can be recycled. Fired and returned through UGAProjectilePoolSubsystem: when it hits
+// something or its lifetime runs out, it switches off its movement, collision and visibility and goes back to
+// the pool, rather than being destroyed.
+// Visuals are left to Blueprint subclasses.
+UCLASS(BlueprintType, Blueprintable)
+class AGAProjectile : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AGAProjectile();
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	TObjectPtr<USphereComponent> CollisionComponent;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	TObjectPtr<UProjectileMovementComponent> ProjectileMovement;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Damage;
+
+	// Seconds in flight before it's returned to the pool unhit
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Lifetime;
+
+	// Strength of the threat influence it gives off while in flight. 0 for none
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ThreatStrength;
+
+	// Puts the projectile in flight from Location along Rotation
+	void Launch(const FVector& Location, const FRotator& Rotation, AActor* InOwner, APawn* InInstigator);
+
+	// Switches everything off. Called by the pool; use Release to be done with a projectile
+	void Deactivate();
+
+	// Back to the pool (or destroyed, if it didn't come from one)
+	UFUNCTION(BlueprintCallable)
+	void Release();
+
+	bool IsInFlight() const { return bInFlight; }
+
+	UFUNCTION(BlueprintImplementableEvent)
+	void OnImpact(const FHitResult& Hit);
+
+protected:
+	UFUNCTION()
+	void OnHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
+
+	FTimerHandle LifetimeTimer;
+	bool bInFlight = false;
+};
@@ -0,0 +1,147 @@
+#include "GAProjectilePool.h"
+
+#include "GAProjectile.h"
+#include "Engine/World.h"
+
+
+void UGAProjectilePoolSubsystem::Deinitialize()
+{
+	// The actors go with the world
+	Pools.Empty();
+	Super::Deinitialize();
+}
+
+AGAProjectile* UGAProjectilePoolSubsystem::SpawnPooled(TSubclassOf<AGAProjectile> ProjectileClass, FGAProjectilePoolEntry& Pool)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AGAProjectile* Projectile = GetWorld()->SpawnActor<AGAProjectile>(ProjectileClass, FTransform::Identity, SpawnParams);
+	if (Projectile)
+	{
+		Projectile->Deactivate();
+		Pool.All.Add(Projectile);
+		Pool.Stats.Total = Pool.All.Num();
+	}
+	return Projectile;
+}
+
+void UGAProjectilePoolSubsystem::Prewarm(TSubclassOf<AGAProjectile> ProjectileClass, int32 Count)
+{
+	if (!ProjectileClass || !GetWorld())
+	{
+		return;
+	}
+
+	FGAProjectilePoolEntry& Pool = Pools.FindOrAdd(ProjectileClass);
+	Pool.Stats.ProjectileClass = ProjectileClass;
+
+	Count = FMath::Min(Count, MaxPerClass);
+	while (Pool.All.Num() < Count)
+	{
+		AGAProjectile* Projectile = SpawnPooled(ProjectileClass, Pool);
+		if (!Projectile)
+		{
+			break;
+		}
+		Pool.Free.Add(Projectile);
+	}
+}
+
+AGAProjectile* UGAProjectilePoolSubsystem::FireProjectile(TSubclassOf<AGAProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, AActor* Owner, APawn* Instigator)
+{
+	if (!ProjectileClass || !GetWorld())
+	{
+		return nullptr;
+	}
+
+	FGAProjectilePoolEntry& Pool = Pools.FindOrAdd(ProjectileClass);
+	Pool.Stats.ProjectileClass = ProjectileClass;
+
+	AGAProjectile* Projectile = nullptr;
+	while (Pool.Free.Num() > 0 && !Projectile)
+	{
+		// Something else may have destroyed it (level streaming, say)
+		Projectile = Pool.Free.Pop(EAllowShrinking::No);
+		if (!IsValid(Projectile))
+		{
+			Pool.All.Remove(Projectile);
+			Projectile = nullptr;
+		}
+	}
+
+	if (Projectile)
+	{
+		Pool.Stats.Reuses++;
+	}
+	else
+	{
+		Projectile = SpawnPooled(ProjectileClass, Pool);
+		if (!Projectile)
+		{
+			return nullptr;
+		}
+		Pool.Stats.Spawns++;
+	}
+
+	Projectile->Launch(Location, Rotation, Owner, Instigator);
+
+	Pool.Stats.Total = Pool.All.Num();
+	Pool.Stats.InFlight = Pool.All.Num() - Pool.Free.Num();
+	Pool.Stats.PeakInFlight = FMath::Max(Pool.Stats.PeakInFlight, Pool.Stats.InFlight);
+
+	return Projectile;
+}
+
+void UGAProjectilePoolSubsystem::ReleaseProjectile(AGAProjectile* Projectile)
+{
+	if (!Projectile || !Projectile->IsInFlight())
+	{
+		return;
+	}
+
+	Projectile->Deactivate();
+
+	FGAProjectilePoolEntry* Pool = Pools.Find(Projectile->GetClass());
+	if (!Pool || !Pool->All.Contains(Projectile))
+	{
+		// Not one of ours
+		Projectile->Destroy();
+		return;
+	}
+
+	if (Pool->All.Num() > MaxPerClass)
+	{
+		Pool->All.RemoveSwap(Projectile);
+		Projectile->Destroy();
+	}
+	else
+	{
+		Pool->Free.Add(Projectile);
+	}
+
+	Pool->Stats.Total = Pool->All.Num();
+	Pool->Stats.InFlight = Pool->All.Num() - Pool->Free.Num();
+}
+
+bool UGAProjectilePoolSubsystem::GetPoolStats(TSubclassOf<AGAProjectile> ProjectileClass, FGAProjectilePoolStats& StatsOut) const
+{
+	const FGAProjectilePoolEntry* Pool = Pools.Find(ProjectileClass);
+	if (!Pool)
+	{
+		StatsOut = FGAProjectilePoolStats();
+		return false;
+	}
+
+	StatsOut = Pool->Stats;
+	return true;
+}
+
+void UGAProjectilePoolSubsystem::GetAllPoolStats(TArray<FGAProjectilePoolStats>& StatsOut) const
+{
+	StatsOut.Reset();
+	for (const TPair<TSubclassOf<AGAProjectile>, FGAProjectilePoolEntry>& Pair : Pools)
+	{
+		StatsOut.Add(Pair.Value.Stats);
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GAProjectilePool.generated.h"
+
+class AGAProjectile;
+
+
+// Occupancy of one projectile class's pool
+USTRUCT(BlueprintType)
+struct FGAProjectilePoolStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	TSubclassOf<AGAProjectile> ProjectileClass;
+
+	// Projectiles the pool owns, in flight or not
+	UPROPERTY(BlueprintReadOnly)
+	int32 Total = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 InFlight = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 PeakInFlight = 0;
+
+	// Fires served from the free list, and fires that had to spawn because it was empty
+	UPROPERTY(BlueprintReadOnly)
+	int32 Reuses = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 Spawns = 0;
+};
+
+
+// One class's projectiles
+USTRUCT()
+struct FGAProjectilePoolEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<AGAProjectile>> All;
+
+	UPROPERTY()
+	TArray<TObjectPtr<AGAProjectile>> Free;
+
+	FGAProjectilePoolStats Stats;
+};
+
+
+// Keeps a pool of projectile actors per class, so firing doesn't spawn (and hitting doesn't destroy) anything
+// once the pool is warm. Pools grow on demand when they run dry, up to MaxPerClass; past that, extra projectiles
+// are destroyed when they come back rather than kept.
+UCLASS()
+class UGAProjectilePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Spawns projectiles up front (deactivated) until the pool for Class holds at least Count
+	UFUNCTION(BlueprintCallable)
+	void Prewarm(TSubclassOf<AGAProjectile> ProjectileClass, int32 Count);
+
+	// Takes a projectile from the pool (spawning one if there are none free) and launches it
+	UFUNCTION(BlueprintCallable)
+	AGAProjectile* FireProjectile(TSubclassOf<AGAProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, AActor* Owner, APawn* Instigator);
+
+	// Called by AGAProjectile::Release
+	void ReleaseProjectile(AGAProjectile* Projectile);
+
+	UFUNCTION(BlueprintCallable)
+	bool GetPoolStats(TSubclassOf<AGAProjectile> ProjectileClass, FGAProjectilePoolStats& StatsOut) const;
+
+	UFUNCTION(BlueprintCallable)
+	void GetAllPoolStats(TArray<FGAProjectilePoolStats>& StatsOut) const;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MaxPerClass = 256;
+
+protected:
+	AGAProjectile* SpawnPooled(TSubclassOf<AGAProjectile> ProjectileClass, FGAProjectilePoolEntry& Pool);
+
+	UPROPERTY()
+	TMap<TSubclassOf<AGAProjectile>, FGAProjectilePoolEntry> Pools;
+};
@@ -0,0 +1,34 @@
+#include "GameAIStats.h"
+
+
+thread_local FGameAISearchCounts FGameAIStats::LastSearch;
+
+
+DEFINE_STAT(STAT_GameAI_AStar);
+DEFINE_STAT(STAT_GameAI_SmoothPath);
+DEFINE_STAT(STAT_GameAI_LineTrace);
+DEFINE_STAT(STAT_GameAI_Dijkstra);
+DEFINE_STAT(STAT_GameAI_DijkstraBounded);
+DEFINE_STAT(STAT_GameAI_ReconstructDijkstra);
+
+DEFINE_STAT(STAT_GameAI_PathTick);
+DEFINE_STAT(STAT_GameAI_PathFollowingTick);
+DEFINE_STAT(STAT_GameAI_Perception);
+DEFINE_STAT(STAT_GameAI_InfluenceMap);
+DEFINE_STAT(STAT_GameAI_SpatialQuery);
+DEFINE_STAT(STAT_GameAI_TacticalQuery);
+
+DEFINE_STAT(STAT_GameAI_RefreshDataFromNav);
+DEFINE_STAT(STAT_GameAI_RefreshDebugMesh);
+DEFINE_STAT(STAT_GameAI_RefreshDebugTexture);
+
+DEFINE_STAT(STAT_GameAI_NodesExpanded);
+DEFINE_STAT(STAT_GameAI_HeapPushes);
+DEFINE_STAT(STAT_GameAI_LineTraces);
+DEFINE_STAT(STAT_GameAI_PathRefreshes);
+DEFINE_STAT(STAT_GameAI_PathSteps);
+
+TRACE_DECLARE_INT_COUNTER(GameAI_NodesExpanded, TEXT("GameAI/Nodes Expanded"));
+TRACE_DECLARE_INT_COUNTER(GameAI_HeapPushes, TEXT("GameAI/Heap Pushes"));
+TRACE_DECLARE_INT_COUNTER(GameAI_LineTraces, TEXT("GameAI/Line Traces"));
+TRACE_DECLARE_INT_COUNTER(GameAI_PathLength, TEXT("GameAI/Path Length"));
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+
+// "stat GameAI" in the console. The same code paths show up as named scopes in Unreal Insights (cpu channel),
+// along with the counter tracks below
+DECLARE_STATS_GROUP(TEXT("GameAI"), STATGROUP_GameAI, STATCAT_Advanced);
+
+// Searches
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AStar"), STAT_GameAI_AStar, STATGROUP_GameAI, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("SmoothPath"), STAT_GameAI_SmoothPath, STATGROUP_GameAI, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("LineTrace"), STAT_GameAI_LineTrace, STATGROUP_GameAI, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Dijkstra"), STAT_GameAI_Dijkstra, STATGROUP_GameAI, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("DijkstraBounded"), STAT_GameAI_DijkstraBounded, STATGROUP_GameAI, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ReconstructDijkstra"), STAT_GameAI_ReconstructDijkstra, STATGROUP_GameAI, );
+
+// Agents
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Path TickComponent"), STAT_GameAI_PathTick, STATGROUP_GameAI, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Path Following Tick"), STAT_GameAI_PathFollowingTick, STATGROUP_GameAI, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Perception Tick"), STAT_GameAI_Perception, STATGROUP_GameAI, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Influence Map Tick"), STAT_GameAI_InfluenceMap, STATGROUP_GameAI, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spatial Query"), STAT_GameAI_SpatialQuery, STATGROUP_GameAI, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tactical Query Tick"), STAT_GameAI_TacticalQuery, STATGROUP_GameAI, );
+
+// Grid
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RefreshDataFromNav"), STAT_GameAI_RefreshDataFromNav, STATGROUP_GameAI, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RefreshDebugMesh"), STAT_GameAI_RefreshDebugMesh, STATGROUP_GameAI, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RefreshDebugTexture"), STAT_GameAI_RefreshDebugTexture, STATGROUP_GameAI, );
+
+// Per-frame counts
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Nodes Expanded"), STAT_GameAI_NodesExpanded, STATGROUP_GameAI, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Heap Pushes"), STAT_GameAI_HeapPushes, STATGROUP_GameAI, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Line Traces"), STAT_GameAI_LineTraces, STATGROUP_GameAI, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Path Refreshes"), STAT_GameAI_PathRefreshes, STATGROUP_GameAI, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Path Steps"), STAT_GameAI_PathSteps, STATGROUP_GameAI, );
+
+// Insights counter tracks. These hold the numbers for the most recent search/refresh, so a spike lines up with
+// the agent scope (see GAMEAI_TRACE_AGENT_SCOPE) it happened in
+TRACE_DECLARE_INT_COUNTER_EXTERN(GameAI_NodesExpanded);
+TRACE_DECLARE_INT_COUNTER_EXTERN(GameAI_HeapPushes);
+TRACE_DECLARE_INT_COUNTER_EXTERN(GameAI_LineTraces);
+TRACE_DECLARE_INT_COUNTER_EXTERN(GameAI_PathLength);
+
+
+// A cpu scope named after the actor, so per-agent work can be told apart in Insights. The name is only built
+// when the cpu channel is actually being traced
+#if CPUPROFILERTRACE_ENABLED
+#define GAMEAI_TRACE_AGENT_SCOPE(Actor) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT((UE_TRACE_CHANNELEXPR_IS_ENABLED(CpuChannel) && (Actor)) ? *(Actor)->GetName() : TEXT("GameAI Agent"))
+#else
+#define GAMEAI_TRACE_AGENT_SCOPE(Actor)
+#endif
+
+
+// What one search did
+struct FGameAISearchCounts
+{
+	int32 NodesExpanded = 0;
+	int32 HeapPushes = 0;
+
+	// For smoothing passes, which don't expand nodes
+	int32 LineTraces = 0;
+};
+
+
+struct FGameAIStats
+{
+	// The most recent search on this thread, so tools (see UGAPathBenchmarkCommandlet) can read the numbers back
+	// without stats being compiled in
+	static thread_local FGameAISearchCounts LastSearch;
+
+	// Totals for one search
+	static FORCEINLINE void RecordSearch(int32 NodesExpanded, int32 HeapPushes)
+	{
+		LastSearch.NodesExpanded = NodesExpanded;
+		LastSearch.HeapPushes = HeapPushes;
+		INC_DWORD_STAT_BY(STAT_GameAI_NodesExpanded, NodesExpanded);
+		INC_DWORD_STAT_BY(STAT_GameAI_HeapPushes, HeapPushes);
+		TRACE_COUNTER_SET(GameAI_NodesExpanded, NodesExpanded);
+		TRACE_COUNTER_SET(GameAI_HeapPushes, HeapPushes);
+	}
+
+	// Line traces made by one smoothing pass. The per-frame stat is counted by the trace itself
+	static FORCEINLINE void RecordLineTraces(int32 Count)
+	{
+		LastSearch.LineTraces = Count;
+		TRACE_COUNTER_SET(GameAI_LineTraces, Count);
+	}
+
+	static FORCEINLINE void RecordPathRefresh(int32 PathLength)
+	{
+		INC_DWORD_STAT(STAT_GameAI_PathRefreshes);
+		INC_DWORD_STAT_BY(STAT_GameAI_PathSteps, PathLength);
+		TRACE_COUNTER_SET(GameAI_PathLength, PathLength);
+	}
+};
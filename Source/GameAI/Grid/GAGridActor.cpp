@@ -6,10 +6,11 @@
 #include "NavigationSystem.h"
 #include "NavMesh/RecastNavMesh.h"
 #include "Engine/Texture2D.h"
-
-
-UE_DISABLE_OPTIMIZATION
-
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Math/VectorRegister.h"
+#include "Async/ParallelFor.h"
+#include "GameAI/GameAIStats.h"
+#include "GACoreLine.h"
 
 
 FCellRef FCellRef::Invalid(INDEX_NONE, INDEX_NONE);
@@ -41,7 +42,14 @@ AGAGridActor::AGAGridActor(const FObjectInitializer& ObjectInitializer)
 	DebugMeshComponent->SetVisibility(false);
 
 	DebugMeshZOffset = 30.0f;
-
+	DebugMeshChunkSize = 64;
+
+	// Only ticks while actors are registered with the overlay
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	GridVersion = 0;
+	DataVersion = 0;
+	DataHash = 0;
 }
 
 void AGAGridActor::PostLoad()
@@ -54,6 +62,55 @@ void AGAGridActor::PostLoad()
 	Super::PostLoad();
 }
 
+void AGAGridActor::PostRegisterAllComponents()
+{
+	Super::PostRegisterAllComponents();
+
+	// Keep the cached grid transform in sync with the actor. TransformUpdated fires whenever the root moves,
+	// in editor and in game.
+	if (SceneComponent)
+	{
+		SceneComponent->TransformUpdated.RemoveAll(this);
+		SceneComponent->TransformUpdated.AddUObject(this, &AGAGridActor::OnRootTransformUpdated);
+	}
+
+	RefreshTransformCache();
+	RefreshDataHash();
+
+	if (Data.Num() == XCount * YCount && Data.Num() > 0)
+	{
+		MipChain.Build(this);
+	}
+}
+
+void AGAGridActor::Tick(float DeltaSeconds)
+{
+	UpdateOverlay();
+
+	// Everything changed this frame, rebuilt once
+	if (bDebugMeshRefreshPending)
+	{
+		bDebugMeshRefreshPending = false;
+		RefreshDirtyDebugMeshChunks();
+		RefreshTickEnabled();
+	}
+
+	Super::Tick(DeltaSeconds);
+}
+
+void AGAGridActor::PostUnregisterAllComponents()
+{
+	if (SceneComponent)
+	{
+		SceneComponent->TransformUpdated.RemoveAll(this);
+	}
+
+	Super::PostUnregisterAllComponents();
+
+	// Nothing keeps it in sync any more
+	TransformCache.bValid = false;
+}
+
 
 #if WITH_EDITORONLY_DATA
 void AGAGridActor::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
@@ -66,6 +123,12 @@ void AGAGridActor::PostEditChangeProperty(FPropertyChangedEvent& PropertyChanged
 		RefreshBoxComponent();
 	}
 
+	// Edited by hand, so the pyramid can't know what changed
+	if (ChangedPropertyName == FName("DebugGridMap"))
+	{
+		NotifyDebugGridMapChanged();
+	}
+
 	RefreshDerivedValues();
 
 	Super::PostEditChangeProperty(PropertyChangedEvent);
@@ -90,6 +153,69 @@ void AGAGridActor::RefreshDerivedValues()
 	// Refresh HalfExtents
 	HalfExtents.X = 0.5f * CellScale * float(XCount);
 	HalfExtents.Y = 0.5f * CellScale * float(YCount);
+
+	// CellScale or the counts may have changed
+	RefreshTransformCache();
+}
+
+
+// Grid transform cache --------------------------------
+
+void AGAGridActor::BuildTransformCache(FGAGridTransformCache& CacheOut) const
+{
+	FTransform GridTransform = GetActorTransform();
+	float HalfScale = 0.5f * CellScale;
+	float InvCellScale = (CellScale != 0.0f) ? 1.0f / CellScale : 0.0f;
+
+	CacheOut.Origin = GridTransform.GetLocation();
+
+	// InverseTransformVector is linear, so the inverse transform can be written as three rows
+	// built from the inverse-transformed world axes
+	FVector InvAxisX = GridTransform.InverseTransformVector(FVector::XAxisVector);
+	FVector InvAxisY = GridTransform.InverseTransformVector(FVector::YAxisVector);
+	FVector InvAxisZ = GridTransform.InverseTransformVector(FVector::ZAxisVector);
+
+	CacheOut.WorldToCellX = FVector3f(InvAxisX.X, InvAxisY.X, InvAxisZ.X) * InvCellScale;
+	CacheOut.WorldToCellY = FVector3f(InvAxisX.Y, InvAxisY.Y, InvAxisZ.Y) * InvCellScale;
+	CacheOut.CellOffset = FVector2f(HalfExtents.X * InvCellScale, HalfExtents.Y * InvCellScale);
+
+	CacheOut.CellZeroCenter = FVector3f(GridTransform.TransformVector(FVector(HalfScale - HalfExtents.X, HalfScale - HalfExtents.Y, 0.0f)));
+	CacheOut.CellToWorldX = FVector3f(GridTransform.TransformVector(FVector(CellScale, 0.0f, 0.0f)));
+	CacheOut.CellToWorldY = FVector3f(GridTransform.TransformVector(FVector(0.0f, CellScale, 0.0f)));
+	CacheOut.HeightToWorld = FVector3f(GridTransform.TransformVector(FVector::ZAxisVector));
+
+	CacheOut.bValid = true;
+}
+
+void AGAGridActor::RefreshTransformCache()
+{
+	// Until the components are registered the actor transform isn't final (in the constructor there's no root at all),
+	// so the cache stays invalid and GetTransformCache builds a temporary one instead
+	if (SceneComponent && SceneComponent->IsRegistered())
+	{
+		BuildTransformCache(TransformCache);
+	}
+	else
+	{
+		TransformCache.bValid = false;
+	}
+}
+
+void AGAGridActor::OnRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	RefreshTransformCache();
+}
+
+const FGAGridTransformCache& AGAGridActor::GetTransformCache(FGAGridTransformCache& Scratch) const
+{
+	if (TransformCache.bValid)
+	{
+		return TransformCache;
+	}
+
+	// Not registered (the CDO, or an actor that hasn't been added to a world yet). Build one on the spot.
+	BuildTransformCache(Scratch);
+	return Scratch;
 }
 
 
@@ -100,56 +226,98 @@ bool AGAGridActor::ResetData()
 	Data.SetNumZeroed(GetCellCount());
 	HeightData.SetNumZeroed(CellCount);
 
+	// The overlay is sized to match, so re-stamp everything into a fresh one
+	Overlay.Reset(CellCount);
+	for (FGAOverlayRegistration& Registration : OverlayRegistrations)
+	{
+		FIntRect DirtyRect;
+		Registration.StampedCells.Reset();
+		RestampOverlayRegistration(Registration, true, DirtyRect);
+	}
+
+	MarkDebugTextureDirty();
 	return Result;
 }
 
+bool AGAGridActor::ResizeGrid(int32 InXCount, int32 InYCount, float InCellScale)
+{
+	if (InXCount <= 0 || InYCount <= 0 || InCellScale <= 0.0f)
+	{
+		return false;
+	}
+
+	XCount = InXCount;
+	YCount = InYCount;
+	CellScale = InCellScale;
+	RefreshDerivedValues();
+
+#if WITH_EDITORONLY_DATA
+	RefreshBoxComponent();
+#endif //WITH_EDITORONLY_DATA
+
+	// Sized for the old grid. NotifyCellsChanged rebuilds it
+	MipChain.Reset();
+
+	ResetData();
+	return true;
+}
+
 // Return the cell the given point is inside of
 // If bClamp = true, then any point outside of the grid will be clamped to the bounds of the grid
 // Otherwise, if the point is outside the grid, it will return FCellRef::Invalid
 
 FCellRef AGAGridActor::GetCellRef(const FVector& Point, bool bClamp) const
 {
-	// First, transform the point into grid-local space
-	// note, we drop the Z dimension at this point, by casting to a FVector2D
-	FTransform GridTransform = GetActorTransform();
-	FVector2D LocalPoint = FVector2D(GridTransform.InverseTransformPosition(Point));
+	FVector2f CellSpace = GetCellSpacePosition(Point);
+	float CellX = CellSpace.X;
+	float CellY = CellSpace.Y;
 
 	if (bClamp)
 	{
-		LocalPoint.X = FMath::Clamp(LocalPoint.X, -HalfExtents.X, HalfExtents.X);
-		LocalPoint.Y = FMath::Clamp(LocalPoint.Y, -HalfExtents.Y, HalfExtents.Y);
+		CellX = FMath::Clamp(CellX, 0.0f, float(XCount));
+		CellY = FMath::Clamp(CellY, 0.0f, float(YCount));
 	}
-	else if (FMath::Abs(LocalPoint.X) > HalfExtents.X || FMath::Abs(LocalPoint.Y) > HalfExtents.Y)
+	else if (CellX < 0.0f || CellX > float(XCount) || CellY < 0.0f || CellY > float(YCount))
 	{
 		return FCellRef::Invalid;
 	}
 
-	LocalPoint += HalfExtents;		// Now LocalPoint is relative the to the (0, 0) corner of grid
-
-	// Discretize by dividing by scale and flooring
+	// Discretize by flooring
 	// Out of an abundance of caution we also clamp the result to a valid index, to avoid any floating-point issues
 
 	FCellRef Result(
-		FMath::Clamp(FMath::FloorToInt32(LocalPoint.X / CellScale), 0, XCount - 1),
-		FMath::Clamp(FMath::FloorToInt32(LocalPoint.Y / CellScale), 0, YCount - 1)
+		FMath::Clamp(FMath::FloorToInt32(CellX), 0, XCount - 1),
+		FMath::Clamp(FMath::FloorToInt32(CellY), 0, YCount - 1)
 	);
 	return Result;
 }
 
+FVector2f AGAGridActor::GetCellSpacePosition(const FVector& Point) const
+{
+	// Transform the point into cell space using the cached affine
+	// note, we drop the Z dimension at this point
+	FGAGridTransformCache Scratch;
+	const FGAGridTransformCache& Cache = GetTransformCache(Scratch);
+	FVector3f Delta = FVector3f(Point - Cache.Origin);
+
+	// Now relative to the (0, 0) corner of grid, in units of cells
+	return FVector2f((Delta | Cache.WorldToCellX) + Cache.CellOffset.X, (Delta | Cache.WorldToCellY) + Cache.CellOffset.Y);
+}
+
 FVector AGAGridActor::GetCellPosition(const FCellRef& CellRef) const
 {
-	float HalfScale = 0.5f * CellScale;
 	int32 Index = CellRefToIndex(CellRef);
+	float Height = HeightData.IsValidIndex(Index) ? HeightData[Index] : 0.0f;
 
-	// Grab the center of the cell, then offset by -HalfExtents, so that it is relative to the center of the grid
-	FVector LocalResult;
-	LocalResult.X = CellRef.X * CellScale + HalfScale - HalfExtents.X;
-	LocalResult.Y = CellRef.Y * CellScale + HalfScale - HalfExtents.Y;
-	LocalResult.Z = HeightData.IsValidIndex(Index) ? HeightData[Index] :  0.0f;
+	// Center of the cell, relative to the grid origin, run through the cached affine
+	FGAGridTransformCache Scratch;
+	const FGAGridTransformCache& Cache = GetTransformCache(Scratch);
+	FVector3f Offset = Cache.CellZeroCenter
+		+ Cache.CellToWorldX * float(CellRef.X)
+		+ Cache.CellToWorldY * float(CellRef.Y)
+		+ Cache.HeightToWorld * Height;
 
-	FTransform ActorTransform = GetActorTransform();
-	FVector Result = ActorTransform.TransformPosition(LocalResult);
-	return Result;
+	return Cache.Origin + FVector(Offset);
 }
 
 bool AGAGridActor::IsCellRefInBounds(const FCellRef& CellRef) const
@@ -159,6 +327,197 @@ bool AGAGridActor::IsCellRefInBounds(const FCellRef& CellRef) const
 
 
 
+// Batched coordinate conversion --------------------------------
+
+void AGAGridActor::GetCellRefs(const float* PointsX, const float* PointsY, const float* PointsZ, int32 Count, int32* CellXOut, int32* CellYOut, bool bClamp) const
+{
+	FGAGridTransformCache Scratch;
+	const FGAGridTransformCache& Cache = GetTransformCache(Scratch);
+	FVector3f Origin = FVector3f(Cache.Origin);
+
+	// Splat all the constants once
+	const VectorRegister4Float OriginX = VectorSetFloat1(Origin.X);
+	const VectorRegister4Float OriginY = VectorSetFloat1(Origin.Y);
+	const VectorRegister4Float OriginZ = VectorSetFloat1(Origin.Z);
+	const VectorRegister4Float XRow0 = VectorSetFloat1(Cache.WorldToCellX.X);
+	const VectorRegister4Float XRow1 = VectorSetFloat1(Cache.WorldToCellX.Y);
+	const VectorRegister4Float XRow2 = VectorSetFloat1(Cache.WorldToCellX.Z);
+	const VectorRegister4Float YRow0 = VectorSetFloat1(Cache.WorldToCellY.X);
+	const VectorRegister4Float YRow1 = VectorSetFloat1(Cache.WorldToCellY.Y);
+	const VectorRegister4Float YRow2 = VectorSetFloat1(Cache.WorldToCellY.Z);
+	const VectorRegister4Float OffsetX = VectorSetFloat1(Cache.CellOffset.X);
+	const VectorRegister4Float OffsetY = VectorSetFloat1(Cache.CellOffset.Y);
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float MinusOne = VectorSetFloat1(-1.0f);
+	const VectorRegister4Float CountX = VectorSetFloat1(float(XCount));
+	const VectorRegister4Float CountY = VectorSetFloat1(float(YCount));
+	const VectorRegister4Float MaxIndexX = VectorSetFloat1(float(XCount - 1));
+	const VectorRegister4Float MaxIndexY = VectorSetFloat1(float(YCount - 1));
+
+	int32 Index = 0;
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		VectorRegister4Float DX = VectorSubtract(VectorLoad(PointsX + Index), OriginX);
+		VectorRegister4Float DY = VectorSubtract(VectorLoad(PointsY + Index), OriginY);
+		VectorRegister4Float DZ = VectorSubtract(VectorLoad(PointsZ + Index), OriginZ);
+
+		VectorRegister4Float CX = VectorMultiplyAdd(DZ, XRow2, VectorMultiplyAdd(DY, XRow1, VectorMultiplyAdd(DX, XRow0, OffsetX)));
+		VectorRegister4Float CY = VectorMultiplyAdd(DZ, YRow2, VectorMultiplyAdd(DY, YRow1, VectorMultiplyAdd(DX, YRow0, OffsetY)));
+
+		VectorRegister4Float InBounds = VectorBitwiseAnd(
+			VectorBitwiseAnd(VectorCompareGE(CX, Zero), VectorCompareLE(CX, CountX)),
+			VectorBitwiseAnd(VectorCompareGE(CY, Zero), VectorCompareLE(CY, CountY)));
+
+		// Same discretization as GetCellRef: floor, then clamp to a valid index
+		CX = VectorMax(VectorMin(VectorFloor(CX), MaxIndexX), Zero);
+		CY = VectorMax(VectorMin(VectorFloor(CY), MaxIndexY), Zero);
+
+		if (!bClamp)
+		{
+			CX = VectorSelect(InBounds, CX, MinusOne);
+			CY = VectorSelect(InBounds, CY, MinusOne);
+		}
+
+		VectorIntStore(VectorFloatToInt(CX), CellXOut + Index);
+		VectorIntStore(VectorFloatToInt(CY), CellYOut + Index);
+	}
+
+	// Leftovers
+	for (; Index < Count; Index++)
+	{
+		FCellRef CellRef = GetCellRef(FVector(PointsX[Index], PointsY[Index], PointsZ[Index]), bClamp);
+		CellXOut[Index] = CellRef.X;
+		CellYOut[Index] = CellRef.Y;
+	}
+}
+
+void AGAGridActor::GetCellRefs(const FGAPositionsSoA& Points, TArray<int32>& CellXOut, TArray<int32>& CellYOut, bool bClamp) const
+{
+	int32 Count = Points.Num();
+	CellXOut.SetNumUninitialized(Count);
+	CellYOut.SetNumUninitialized(Count);
+	GetCellRefs(Points.X.GetData(), Points.Y.GetData(), Points.Z.GetData(), Count, CellXOut.GetData(), CellYOut.GetData(), bClamp);
+}
+
+void AGAGridActor::GetCellRefs(TConstArrayView<FVector> Points, TArray<FCellRef>& CellsOut, bool bClamp) const
+{
+	// Transpose into small on-stack SoA chunks, convert, and transpose back
+	constexpr int32 ChunkSize = 64;
+	float X[ChunkSize], Y[ChunkSize], Z[ChunkSize];
+	int32 CellX[ChunkSize], CellY[ChunkSize];
+
+	CellsOut.SetNumUninitialized(Points.Num());
+
+	for (int32 ChunkStart = 0; ChunkStart < Points.Num(); ChunkStart += ChunkSize)
+	{
+		int32 ChunkCount = FMath::Min(ChunkSize, Points.Num() - ChunkStart);
+		for (int32 Index = 0; Index < ChunkCount; Index++)
+		{
+			const FVector& Point = Points[ChunkStart + Index];
+			X[Index] = float(Point.X);
+			Y[Index] = float(Point.Y);
+			Z[Index] = float(Point.Z);
+		}
+
+		GetCellRefs(X, Y, Z, ChunkCount, CellX, CellY, bClamp);
+
+		for (int32 Index = 0; Index < ChunkCount; Index++)
+		{
+			CellsOut[ChunkStart + Index] = FCellRef(CellX[Index], CellY[Index]);
+		}
+	}
+}
+
+// Shared SIMD kernel for the GetCellPositions variants. Writes Base + the affine offset of each cell center.
+static void CellsToPositions(const FGAGridTransformCache& Cache, const TArray<float>& HeightData, int32 XCount, const FVector3f& Base,
+	const int32* CellX, const int32* CellY, int32 Count, float* OutX, float* OutY, float* OutZ)
+{
+	// Heights are a gather, so pull those first
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		int32 CellIndex = CellY[Index] * XCount + CellX[Index];
+		OutZ[Index] = HeightData.IsValidIndex(CellIndex) ? HeightData[CellIndex] : 0.0f;
+	}
+
+	const VectorRegister4Float BaseX = VectorSetFloat1(Base.X);
+	const VectorRegister4Float BaseY = VectorSetFloat1(Base.Y);
+	const VectorRegister4Float BaseZ = VectorSetFloat1(Base.Z);
+	const VectorRegister4Float AxisXX = VectorSetFloat1(Cache.CellToWorldX.X);
+	const VectorRegister4Float AxisXY = VectorSetFloat1(Cache.CellToWorldX.Y);
+	const VectorRegister4Float AxisXZ = VectorSetFloat1(Cache.CellToWorldX.Z);
+	const VectorRegister4Float AxisYX = VectorSetFloat1(Cache.CellToWorldY.X);
+	const VectorRegister4Float AxisYY = VectorSetFloat1(Cache.CellToWorldY.Y);
+	const VectorRegister4Float AxisYZ = VectorSetFloat1(Cache.CellToWorldY.Z);
+	const VectorRegister4Float UpX = VectorSetFloat1(Cache.HeightToWorld.X);
+	const VectorRegister4Float UpY = VectorSetFloat1(Cache.HeightToWorld.Y);
+	const VectorRegister4Float UpZ = VectorSetFloat1(Cache.HeightToWorld.Z);
+
+	int32 Index = 0;
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		VectorRegister4Float CX = VectorIntToFloat(VectorIntLoad(CellX + Index));
+		VectorRegister4Float CY = VectorIntToFloat(VectorIntLoad(CellY + Index));
+		VectorRegister4Float H = VectorLoad(OutZ + Index);
+
+		VectorStore(VectorMultiplyAdd(H, UpX, VectorMultiplyAdd(CY, AxisYX, VectorMultiplyAdd(CX, AxisXX, BaseX))), OutX + Index);
+		VectorStore(VectorMultiplyAdd(H, UpY, VectorMultiplyAdd(CY, AxisYY, VectorMultiplyAdd(CX, AxisXY, BaseY))), OutY + Index);
+		VectorStore(VectorMultiplyAdd(H, UpZ, VectorMultiplyAdd(CY, AxisYZ, VectorMultiplyAdd(CX, AxisXZ, BaseZ))), OutZ + Index);
+	}
+
+	for (; Index < Count; Index++)
+	{
+		FVector3f Position = Base
+			+ Cache.CellToWorldX * float(CellX[Index])
+			+ Cache.CellToWorldY * float(CellY[Index])
+			+ Cache.HeightToWorld * OutZ[Index];
+
+		OutX[Index] = Position.X;
+		OutY[Index] = Position.Y;
+		OutZ[Index] = Position.Z;
+	}
+}
+
+void AGAGridActor::GetCellPositions(const int32* CellX, const int32* CellY, int32 Count, FGAPositionsSoA& PositionsOut) const
+{
+	FGAGridTransformCache Scratch;
+	const FGAGridTransformCache& Cache = GetTransformCache(Scratch);
+
+	PositionsOut.SetNumUninitialized(Count);
+	CellsToPositions(Cache, HeightData, XCount, FVector3f(Cache.Origin) + Cache.CellZeroCenter,
+		CellX, CellY, Count, PositionsOut.X.GetData(), PositionsOut.Y.GetData(), PositionsOut.Z.GetData());
+}
+
+void AGAGridActor::GetCellPositions(TConstArrayView<FCellRef> Cells, TArray<FVector>& PositionsOut) const
+{
+	// Unlike the SoA version, this one keeps the origin in double precision
+	FGAGridTransformCache Scratch;
+	const FGAGridTransformCache& Cache = GetTransformCache(Scratch);
+
+	constexpr int32 ChunkSize = 64;
+	int32 CellX[ChunkSize], CellY[ChunkSize];
+	float OffsetX[ChunkSize], OffsetY[ChunkSize], OffsetZ[ChunkSize];
+
+	PositionsOut.SetNumUninitialized(Cells.Num());
+
+	for (int32 ChunkStart = 0; ChunkStart < Cells.Num(); ChunkStart += ChunkSize)
+	{
+		int32 ChunkCount = FMath::Min(ChunkSize, Cells.Num() - ChunkStart);
+		for (int32 Index = 0; Index < ChunkCount; Index++)
+		{
+			CellX[Index] = Cells[ChunkStart + Index].X;
+			CellY[Index] = Cells[ChunkStart + Index].Y;
+		}
+
+		CellsToPositions(Cache, HeightData, XCount, Cache.CellZeroCenter, CellX, CellY, ChunkCount, OffsetX, OffsetY, OffsetZ);
+
+		for (int32 Index = 0; Index < ChunkCount; Index++)
+		{
+			PositionsOut[ChunkStart + Index] = Cache.Origin + FVector(OffsetX[Index], OffsetY[Index], OffsetZ[Index]);
+		}
+	}
+}
+
+
 FVector2D AGAGridActor::GetCellGridSpacePosition(const FCellRef& CellRef) const
 {
 	float HalfScale = 0.5f * CellScale;
@@ -173,17 +532,338 @@ FVector2D AGAGridActor::GetCellGridSpacePosition(const FCellRef& CellRef) const
 
 
 
-ECellData AGAGridActor::GetCellData(const FCellRef &CellRef) const
-{
-	int32 CellIndex = CellRefToIndex(CellRef);
-	return Data[CellIndex];
-}
+ECellData AGAGridActor::GetCellData(const FCellRef &CellRef) const
+{
+	int32 CellIndex = CellRefToIndex(CellRef);
+	return Data[CellIndex];
+}
+
+
+float AGAGridActor::GetCellHeightData(const FCellRef& CellRef) const
+{
+	int32 CellIndex = CellRefToIndex(CellRef);
+	return HeightData[CellIndex];
+}
+
+
+bool AGAGridActor::IsCellTraversable(const FCellRef& CellRef) const
+{
+	return GetCoreGrid().IsTraversable(CellRef.X, CellRef.Y);
+}
+
+
+float AGAGridActor::GetCellCost(const FCellRef& CellRef) const
+{
+	GACore::FGridView Grid = GetCoreGrid();
+	return Grid.IsInBounds(CellRef.X, CellRef.Y) ? Grid.GetCost(Grid.ToIndex(CellRef.X, CellRef.Y)) : 1.0f;
+}
+
+
+bool AGAGridActor::HasLineOfSight(const FCellRef& From, const FCellRef& To) const
+{
+	return GACore::HasLineOfSight(GetCoreGrid(), From.X, From.Y, To.X, To.Y);
+}
+
+
+GACore::FGridView AGAGridActor::GetCoreGrid() const
+{
+	static_assert(sizeof(ECellData) == sizeof(uint8) && uint8(ECellData::CellDataTraversable) == GACore::CellFlagsTraversable,
+		"GACore reads Data as its own cell flags");
+
+	// Anything that doesn't cover the whole grid (mid-rebuild, or an overlay that was never set up) is left out
+	// rather than read past its end
+	const int32 CellCount = XCount * YCount;
+	GACore::FGridView Grid;
+	Grid.Width = XCount;
+	Grid.Height = YCount;
+	Grid.Flags = (Data.Num() == CellCount) ? reinterpret_cast<const uint8*>(Data.GetData()) : nullptr;
+	Grid.BlockCounts = (Overlay.BlockCount.Num() == CellCount) ? Overlay.BlockCount.GetData() : nullptr;
+	Grid.ExtraCosts = (Overlay.ExtraCost.Num() == CellCount) ? Overlay.ExtraCost.GetData() : nullptr;
+	return Grid;
+}
+
+
+GACore::FGridStorage AGAGridActor::CopyCoreGrid() const
+{
+	const GACore::FGridView View = GetCoreGrid();
+	const int32 CellCount = View.GetCellCount();
+
+	GACore::FGridStorage Copy;
+	Copy.Width = View.Width;
+	Copy.Height = View.Height;
+	if (View.Flags)
+	{
+		Copy.Flags.assign(View.Flags, View.Flags + CellCount);
+	}
+	if (View.BlockCounts && Overlay.HasBlockedCells())
+	{
+		Copy.BlockCounts.assign(View.BlockCounts, View.BlockCounts + CellCount);
+	}
+	if (View.ExtraCosts)
+	{
+		Copy.ExtraCosts.assign(View.ExtraCosts, View.ExtraCosts + CellCount);
+	}
+	return Copy;
+}
+
+TSharedPtr<const GACore::FGridStorage, ESPMode::ThreadSafe> AGAGridActor::GetSharedCoreGrid() const
+{
+	if (!SharedCoreGrid.IsValid() || SharedCoreGridVersion != GridVersion
+		|| SharedCoreGrid->Width != XCount || SharedCoreGrid->Height != YCount)
+	{
+		// Whoever still holds the old copy keeps it
+		SharedCoreGrid = MakeShared<const GACore::FGridStorage, ESPMode::ThreadSafe>(CopyCoreGrid());
+		SharedCoreGridVersion = GridVersion;
+	}
+	return SharedCoreGrid;
+}
+
+
+// Visibility --------------------------------
+
+// Floor of A / B, for B > 0
+static FORCEINLINE int32 FloorDivide(int32 A, int32 B)
+{
+	return (A >= 0) ? (A / B) : -((-A + B - 1) / B);
+}
+
+void AGAGridActor::ComputeVisibility(const FCellRef& Origin, TBitArray<>& VisibleOut, int32 MaxRadius, bool bIncludeOverlay) const
+{
+	GACore::FGridView Grid = GetCoreGrid();
+	if (!bIncludeOverlay)
+	{
+		Grid.BlockCounts = nullptr;
+		Grid.ExtraCosts = nullptr;
+	}
+
+	ComputeVisibility(Grid, Origin, VisibleOut, MaxRadius);
+}
+
+void AGAGridActor::ComputeVisibility(const GACore::FGridView& Grid, const FCellRef& Origin, TBitArray<>& VisibleOut, int32 MaxRadius)
+{
+	VisibleOut.Init(false, Grid.GetCellCount());
+	if (!Grid.IsInBounds(Origin.X, Origin.Y))
+	{
+		return;
+	}
+
+	VisibleOut[Grid.ToIndex(Origin.X, Origin.Y)] = true;
+
+	// Symmetric shadowcasting, after Albert Ford's write-up (https://www.albertford.com/shadowcasting/).
+	// Each quadrant is scanned row by row, outward from the origin. A row is the span of columns between a start
+	// and end slope. Whenever the scan goes from floor to wall, the rest of the row is shadowed and a new row
+	// is queued for the lit part. Slopes are kept as exact fractions (Num / Den, Den > 0) so there's no
+	// floating-point drift at the edges of shadows.
+	struct FRow
+	{
+		int32 Depth;
+		int32 StartNum, StartDen;
+		int32 EndNum, EndDen;
+	};
+
+	TArray<FRow, TInlineAllocator<64>> Stack;
+	int32 MaxRadiusSquared = MaxRadius * MaxRadius;
+
+	for (int32 Quadrant = 0; Quadrant < 4; Quadrant++)
+	{
+		// Quadrant-local (depth, column) to grid cell
+		auto Transform = [&Origin, Quadrant](int32 Depth, int32 Column)
+		{
+			switch (Quadrant)
+			{
+			case 0:		return FCellRef(Origin.X + Column, Origin.Y - Depth);
+			case 1:		return FCellRef(Origin.X + Column, Origin.Y + Depth);
+			case 2:		return FCellRef(Origin.X + Depth, Origin.Y + Column);
+			default:	return FCellRef(Origin.X - Depth, Origin.Y + Column);
+			}
+		};
+
+		Stack.Reset();
+		Stack.Add({ 1, -1, 1, 1, 1 });
+
+		while (Stack.Num() > 0)
+		{
+			FRow Row = Stack.Pop(EAllowShrinking::No);
+			if (MaxRadius > 0 && Row.Depth > MaxRadius)
+			{
+				continue;
+			}
+
+			// Columns from round-ties-up(Depth * StartSlope) to round-ties-down(Depth * EndSlope)
+			int32 MinColumn = FloorDivide(2 * Row.Depth * Row.StartNum + Row.StartDen, 2 * Row.StartDen);
+			int32 MaxColumn = -FloorDivide(-(2 * Row.Depth * Row.EndNum - Row.EndDen), 2 * Row.EndDen);
+
+			// 0 = none yet, 1 = floor, 2 = wall
+			int32 Previous = 0;
+
+			for (int32 Column = MinColumn; Column <= MaxColumn; Column++)
+			{
+				FCellRef CellRef = Transform(Row.Depth, Column);
+				bool bInBounds = Grid.IsInBounds(CellRef.X, CellRef.Y);
+				bool bWall = !Grid.IsTraversable(CellRef.X, CellRef.Y);
+
+				// Floors are only revealed if their center is inside the row's slopes -- that's what makes it symmetric
+				bool bSymmetric = (Column * Row.StartDen >= Row.Depth * Row.StartNum) && (Column * Row.EndDen <= Row.Depth * Row.EndNum);
+				bool bInRadius = (MaxRadius <= 0) || (Column * Column + Row.Depth * Row.Depth <= MaxRadiusSquared);
+
+				if (bInBounds && bInRadius && (bWall || bSymmetric))
+				{
+					VisibleOut[Grid.ToIndex(CellRef.X, CellRef.Y)] = true;
+				}
+
+				if (Previous == 2 && !bWall)
+				{
+					// Coming out of a wall: the lit part of this row starts at this cell's leading edge
+					Row.StartNum = 2 * Column - 1;
+					Row.StartDen = 2 * Row.Depth;
+				}
+
+				if (Previous == 1 && bWall)
+				{
+					// Going into a wall: scan the lit part of the next row up to this cell's leading edge
+					Stack.Add({ Row.Depth + 1, Row.StartNum, Row.StartDen, 2 * Column - 1, 2 * Row.Depth });
+				}
+
+				Previous = bWall ? 2 : 1;
+			}
+
+			if (Previous == 1)
+			{
+				Stack.Add({ Row.Depth + 1, Row.StartNum, Row.StartDen, Row.EndNum, Row.EndDen });
+			}
+		}
+	}
+}
+
+bool AGAGridActor::ComputeVisibilityMap(const FCellRef& Origin, FGAGridMap& VisibilityOut, int32 MaxRadius) const
+{
+	if (!IsCellRefInBounds(Origin))
+	{
+		return false;
+	}
+
+	TBitArray<> Visible;
+	ComputeVisibility(Origin, Visible, MaxRadius);
+
+	VisibilityOut = FGAGridMap(this, FGridBox(0, XCount - 1, 0, YCount - 1), 0.0f);
+	float* VisibilityData = VisibilityOut.Data.GetData();
+	for (TConstSetBitIterator<> It(Visible); It; ++It)
+	{
+		VisibilityData[It.GetIndex()] = 1.0f;
+	}
+
+	return true;
+}
+
+
+bool AGAGridActor::IsVisible(const FCellRef& A, const FCellRef& B) const
+{
+	if (!IsCellRefInBounds(A) || !IsCellRefInBounds(B))
+	{
+		return false;
+	}
+
+	if (!PVS.IsValidFor(this))
+	{
+		return HasLineOfSight(A, B);
+	}
+
+	// Hidden in the static data means hidden. Visible may still be blocked by something in the overlay on the way
+	return PVS.IsVisible(A, B) && IsOverlayLineClear(A, B);
+}
+
+bool AGAGridActor::IsOverlayLineClear(const FCellRef& From, const FCellRef& To) const
+{
+	if (!Overlay.HasBlockedCells())
+	{
+		return true;
+	}
+
+	// Both ends are in bounds, so every cell the walk asks about is too
+	return GACore::WalkLine(From.X, From.Y, To.X, To.Y, [this](int32 X, int32 Y)
+	{
+		return !Overlay.IsBlocked(Y * XCount + X);
+	});
+}
+
+void AGAGridActor::BakePVS()
+{
+	Modify();
+
+	double StartTime = FPlatformTime::Seconds();
+	PVS.Bake(this);
+
+	UE_LOG(LogTemp, Log, TEXT("Baked grid PVS: %d x %d cells, cluster size %d, %.1f KB, %.2f s"),
+		XCount, YCount, PVS.ClusterSize, float(PVS.GetAllocatedSize()) / 1024.0f, FPlatformTime::Seconds() - StartTime);
+}
+
+void AGAGridActor::BenchmarkPVS(int32 QueryCount, int32 Seed) const
+{
+	if (!PVS.IsValidFor(this))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("BenchmarkPVS: no PVS baked for this grid"));
+		return;
+	}
+
+	// Same random queries for both, between traversable cells
+	FRandomStream Random(Seed);
+	TArray<TPair<FCellRef, FCellRef>> Queries;
+	Queries.Reserve(QueryCount);
+	for (int32 Attempt = 0; Queries.Num() < QueryCount && Attempt < QueryCount * 10; Attempt++)
+	{
+		FCellRef A(Random.RandRange(0, XCount - 1), Random.RandRange(0, YCount - 1));
+		FCellRef B(Random.RandRange(0, XCount - 1), Random.RandRange(0, YCount - 1));
+		if (IsCellTraversable(A) && IsCellTraversable(B))
+		{
+			Queries.Emplace(A, B);
+		}
+	}
+
+	TBitArray<> PVSResults(false, Queries.Num());
+	TBitArray<> TraceResults(false, Queries.Num());
+
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < Queries.Num(); Index++)
+	{
+		PVSResults[Index] = PVS.IsVisible(Queries[Index].Key, Queries[Index].Value);
+	}
+	double PVSTime = FPlatformTime::Seconds() - StartTime;
+
+	// What a lookup saves at runtime: the line walk IsVisible does without a PVS
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < Queries.Num(); Index++)
+	{
+		TraceResults[Index] = HasLineOfSight(Queries[Index].Key, Queries[Index].Value);
+	}
+	double TraceTime = FPlatformTime::Seconds() - StartTime;
+
+	// Agreement is against what the bake is defined by: shadowcasting over the static data, one pass per origin
+	TMap<int32, TArray<int32>> QueriesByOrigin;
+	for (int32 Index = 0; Index < Queries.Num(); Index++)
+	{
+		QueriesByOrigin.FindOrAdd(CellRefToIndex(Queries[Index].Key)).Add(Index);
+	}
 
+	int32 Agreements = 0;
+	int32 FalseVisible = 0;
+	TBitArray<> Visible;
+	for (const TPair<int32, TArray<int32>>& Origin : QueriesByOrigin)
+	{
+		ComputeVisibility(FCellRef(Origin.Key % XCount, Origin.Key / XCount), Visible, 0, false);
+		for (int32 Index : Origin.Value)
+		{
+			bool bReference = Visible[CellRefToIndex(Queries[Index].Value)];
+			Agreements += (PVSResults[Index] == bReference) ? 1 : 0;
+			FalseVisible += (PVSResults[Index] && !bReference) ? 1 : 0;
+		}
+	}
 
-float AGAGridActor::GetCellHeightData(const FCellRef& CellRef) const
-{
-	int32 CellIndex = CellRefToIndex(CellRef);
-	return HeightData[CellIndex];
+	int32 Count = FMath::Max(Queries.Num(), 1);
+	UE_LOG(LogTemp, Log, TEXT("BenchmarkPVS: %d queries. PVS %.1f ns/query, traces %.1f ns/query (%.1fx). PVS %.1f KB, cluster size %d. Agreement with shadowcasting %.2f%%, PVS-only visible %.2f%%"),
+		Queries.Num(),
+		1.0e9 * PVSTime / Count, 1.0e9 * TraceTime / Count, TraceTime / FMath::Max(PVSTime, 1.0e-9),
+		float(PVS.GetAllocatedSize()) / 1024.0f, PVS.ClusterSize,
+		100.0f * Agreements / Count, 100.0f * FalseVisible / Count);
 }
 
 
@@ -204,6 +884,9 @@ bool AGAGridActor::GridSpaceBoundsToRect2D(const FBox2D& Box, FIntRect &RectOut)
 
 bool AGAGridActor::RefreshDataFromNav()
 {
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_RefreshDataFromNav);
+	TRACE_CPUPROFILER_EVENT_SCOPE(AGAGridActor::RefreshDataFromNav);
+
 	bool Result = false;
 	UNavigationSystemV1 *NavSystem = UNavigationSystemV1::GetNavigationSystem(this);
 	if (NavSystem)
@@ -378,293 +1061,605 @@ bool AGAGridActor::RefreshDataFromNav()
 				}
 			}
 		}
+
+		NotifyCellsChanged(FIntRect(0, 0, XCount - 1, YCount - 1));
 	}
 
 	return Result;
 }
 
 
-// Debugging and Visualization --------------------------------
-
+// Dynamic overlay --------------------------------
 
-bool AGAGridActor::RefreshDebugMesh()
+void AGAGridActor::RegisterOverlayActor(AActor* Actor, const FGAOverlayFootprint& Footprint)
 {
-	TArray<FVector> Vertices;
-	TArray<int32> Triangles;
-	TArray<FVector> Normals;
-	TArray<FVector2D> UV0;
-	TArray<FColor> VertexColors;			// can safely leave empty
-	TArray<FProcMeshTangent> Tangents;		// can safely leave empty
+	if (!Actor)
+	{
+		return;
+	}
+
+	if (Overlay.BlockCount.Num() != GetCellCount())
+	{
+		Overlay.Reset(GetCellCount());
+	}
+
+	// Re-registering just swaps the footprint
+	UnregisterOverlayActor(Actor);
+
+	FGAOverlayRegistration& Registration = OverlayRegistrations.AddDefaulted_GetRef();
+	Registration.Actor = Actor;
+	Registration.Footprint = Footprint;
 
-	int32 VertexCount = (XCount + 1) * (YCount + 1);
+	FIntRect DirtyRect;
+	if (RestampOverlayRegistration(Registration, true, DirtyRect))
+	{
+		NotifyCellsChanged(DirtyRect, EGACellChange::Overlay);
+	}
+
+	RefreshTickEnabled();
+}
 
-	// Generate the vertices array
-	// TODO: do a raycast to to figure out where the ground actually is
+void AGAGridActor::UnregisterOverlayActor(AActor* Actor)
+{
+	for (int32 Index = OverlayRegistrations.Num() - 1; Index >= 0; Index--)
 	{
-		Vertices.SetNumUninitialized(VertexCount);
+		FGAOverlayRegistration& Registration = OverlayRegistrations[Index];
+		if (Registration.Actor.Get() == Actor)
+		{
+			if (Registration.StampedCells.Num() > 0)
+			{
+				FIntRect DirtyRect = Registration.StampedRect;
+				EraseOverlayRegistration(Registration);
+				NotifyCellsChanged(DirtyRect, EGACellChange::Overlay);
+			}
 
-		FVector2D ZeroZeroCorner(
-			-float(XCount) * CellScale * 0.5f, 
-			-float(YCount) * CellScale * 0.5f);
+			OverlayRegistrations.RemoveAtSwap(Index);
+		}
+	}
 
-		int32 Index = 0;
+	RefreshTickEnabled();
+}
 
-		for (int32 Y = 0; Y <= YCount; Y++)				// note, the use of the <= means we will have ONE MORE row and column or verts than cells
+void AGAGridActor::UpdateOverlay()
+{
+	for (int32 Index = OverlayRegistrations.Num() - 1; Index >= 0; Index--)
+	{
+		FGAOverlayRegistration& Registration = OverlayRegistrations[Index];
+		FIntRect DirtyRect;
+
+		if (!Registration.Actor.IsValid())
 		{
-			for (int32 X = 0; X <= XCount; X++)
+			// Actor went away without unregistering -- clean up after it
+			if (Registration.StampedCells.Num() > 0)
 			{
-				FVector VertexPoint;
-				float H = 0.0f;
-				int32 HCount = 0;
+				DirtyRect = Registration.StampedRect;
+				EraseOverlayRegistration(Registration);
+				NotifyCellsChanged(DirtyRect, EGACellChange::Overlay);
+			}
 
-				// computing the height is a bit of an annoyance. Because these verts are at the corners between cells (not at cell centers)
-				// we don't have perfect height data for them. But we can approximate by averaging adjacent cell heights. This is okay because
-				// it's just for debugging. We will omit non traversable cells though
+			OverlayRegistrations.RemoveAtSwap(Index);
+		}
+		else if (RestampOverlayRegistration(Registration, false, DirtyRect))
+		{
+			NotifyCellsChanged(DirtyRect, EGACellChange::Overlay);
+		}
+	}
+}
 
-				FCellRef BottomRight(X, Y);
-				FCellRef TopRight(X, Y - 1);
-				FCellRef TopLeft(X - 1, Y - 1);
-				FCellRef BottomLeft(X - 1, Y);
+void AGAGridActor::NotifyCellsChanged(const FIntRect& DirtyRect, EGACellChange Change)
+{
+	GridVersion++;
+	if (Change == EGACellChange::Data)
+	{
+		DataVersion++;
+		RefreshDataHash();
+	}
 
-				if (IsCellRefInBounds(BottomRight) && EnumHasAllFlags(GetCellData(BottomRight), ECellData::CellDataTraversable))
-				{
-					int32 CellIndex = CellRefToIndex(BottomRight);
-					H += HeightData[CellIndex];
-					HCount++;
-				}
+	if (MipChain.Num() > 0)
+	{
+		MipChain.Update(this, DirtyRect);
+	}
+	else if (Data.Num() == XCount * YCount && Data.Num() > 0)
+	{
+		MipChain.Build(this);
+	}
 
-				if (IsCellRefInBounds(TopRight) && EnumHasAllFlags(GetCellData(TopRight), ECellData::CellDataTraversable))
-				{
-					int32 CellIndex = CellRefToIndex(TopRight);
-					H += HeightData[CellIndex];
-					HCount++;
-				}
+	// The debug texture and mesh only show the static data, so an overlay restamp wouldn't change a texel or a triangle
+	if (Change == EGACellChange::Data)
+	{
+		MarkDebugTextureDirty(DirtyRect);
+		MarkDebugMeshDirty(DirtyRect);
+	}
+	OnCellsChanged.Broadcast(DirtyRect);
+}
 
-				if (IsCellRefInBounds(TopLeft) && EnumHasAllFlags(GetCellData(TopLeft), ECellData::CellDataTraversable))
-				{
-					int32 CellIndex = CellRefToIndex(TopLeft);
-					H += HeightData[CellIndex];
-					HCount++;
-				}
+void AGAGridActor::RefreshTickEnabled()
+{
+	SetActorTickEnabled(OverlayRegistrations.Num() > 0 || bDebugMeshRefreshPending);
+}
 
-				if (IsCellRefInBounds(BottomLeft) && EnumHasAllFlags(GetCellData(BottomLeft), ECellData::CellDataTraversable))
-				{
-					int32 CellIndex = CellRefToIndex(BottomLeft);
-					H += HeightData[CellIndex];
-					HCount++;
-				}
+void AGAGridActor::RefreshDataHash()
+{
+	DataHash = (Data.Num() > 0) ? FCrc::MemCrc32(Data.GetData(), Data.Num() * sizeof(ECellData)) : 0;
+}
 
-				if (HCount > 0)
-				{
-					H /= float(HCount);
-				}
+void AGAGridActor::EraseOverlayRegistration(FGAOverlayRegistration& Registration)
+{
+	Overlay.Stamp(Registration.StampedCells, Registration.Footprint, -1);
+	Registration.StampedCells.Reset();
+}
 
-				VertexPoint.X = float(X) * CellScale + ZeroZeroCorner.X;
-				VertexPoint.Y = float(Y) * CellScale + ZeroZeroCorner.Y;
-				VertexPoint.Z = H + DebugMeshZOffset;
-				Vertices[Index] = VertexPoint;
-				Index++;
-			}
-		}
+bool AGAGridActor::RestampOverlayRegistration(FGAOverlayRegistration& Registration, bool bForce, FIntRect& DirtyRectOut)
+{
+	// Footprints are stamped around the center of the actor's cell, not the actor itself, so moving around
+	// within a cell costs nothing
+	AActor* Actor = Registration.Actor.Get();
+	FCellRef CenterCell = Actor ? GetCellRef(Actor->GetActorLocation()) : FCellRef::Invalid;
+	int32 CenterIndex = CenterCell.IsValid() ? CellRefToIndex(CenterCell) : INDEX_NONE;
+
+	if (!bForce && (CenterIndex == Registration.StampedCellIndex))
+	{
+		return false;
 	}
 
-	// Generate the triangles array with counter-clockwise winding
+	bool bHadStamp = Registration.StampedCells.Num() > 0;
+	FIntRect OldRect = Registration.StampedRect;
+
+	EraseOverlayRegistration(Registration);
+	Registration.StampedCellIndex = CenterIndex;
+
+	if (CenterCell.IsValid())
 	{
-		int32 TriangleCount = GetCellCount() * 6;		// two triangles per cell
-		Triangles.SetNumUninitialized(TriangleCount);
+		float CellRadius = Registration.Footprint.Radius / CellScale;
+		int32 CellExtent = FMath::CeilToInt32(CellRadius);
+		float CellRadiusSquared = CellRadius * CellRadius;
 
-		int32 VertexXCount = XCount + 1;
-		int32 TriangleIndex = 0;
+		FIntRect& Rect = Registration.StampedRect;
+		Rect.Min.X = FMath::Max(CenterCell.X - CellExtent, 0);
+		Rect.Min.Y = FMath::Max(CenterCell.Y - CellExtent, 0);
+		Rect.Max.X = FMath::Min(CenterCell.X + CellExtent, XCount - 1);
+		Rect.Max.Y = FMath::Min(CenterCell.Y + CellExtent, YCount - 1);
 
-		for (int32 Y = 0; Y < YCount; Y++)
+		for (int32 Y = Rect.Min.Y; Y <= Rect.Max.Y; Y++)
 		{
-			for (int32 X = 0; X < XCount; X++)
+			for (int32 X = Rect.Min.X; X <= Rect.Max.X; X++)
 			{
-				// Don't bother for non traversable cells
-				if (EnumHasAllFlags(GetCellData(FCellRef(X, Y)), ECellData::CellDataTraversable))
+				int32 DX = X - CenterCell.X;
+				int32 DY = Y - CenterCell.Y;
+
+				// The center cell is always covered, however small the radius
+				if (float(DX * DX + DY * DY) <= CellRadiusSquared || (DX == 0 && DY == 0))
 				{
-					// First figure out the four vertices of this cell (in counter-clockwise order)
-					// Note: personally, this breaks my brain a bit, but the labels of "bottom" and "left" etc. below are using
-					// UE's weird left-hand coordinate system, whereby X is the "right" direction and Y is the "down" direction
-
-					int32 Index0 = Y * VertexXCount + X;		// Top left
-					int32 Index1 = Index0 + VertexXCount;		// Bottom left
-					int32 Index2 = Index1 + 1;					// Bottom right
-					int32 Index3 = Index0 + 1;					// Top right
-
-					// First triangle - bottom right half of the cell
-					Triangles[TriangleIndex] = Index0;
-					Triangles[TriangleIndex + 1] = Index1;
-					Triangles[TriangleIndex + 2] = Index2;
-
-					// Second triangle - top left half of the cell
-					Triangles[TriangleIndex + 3] = Index0;
-					Triangles[TriangleIndex + 4] = Index2;
-					Triangles[TriangleIndex + 5] = Index3;
-
-					TriangleIndex += 6;
+					Registration.StampedCells.Add(CellRefToIndex(FCellRef(X, Y)));
 				}
 			}
 		}
 
-		// Original length was an upper limit. Cut it down to the number of triangles we actually set.
-		Triangles.SetNum(TriangleIndex, EAllowShrinking::Yes);
+		Overlay.Stamp(Registration.StampedCells, Registration.Footprint, 1);
 	}
 
-	// Generate the UV coordinates for each vertex
+	bool bHasStamp = Registration.StampedCells.Num() > 0;
+	if (!bHadStamp && !bHasStamp)
+	{
+		return false;
+	}
+
+	// Dirty region covers both the erased and the new footprint (inclusive cell indices)
+	if (bHadStamp && bHasStamp)
+	{
+		DirtyRectOut.Min.X = FMath::Min(OldRect.Min.X, Registration.StampedRect.Min.X);
+		DirtyRectOut.Min.Y = FMath::Min(OldRect.Min.Y, Registration.StampedRect.Min.Y);
+		DirtyRectOut.Max.X = FMath::Max(OldRect.Max.X, Registration.StampedRect.Max.X);
+		DirtyRectOut.Max.Y = FMath::Max(OldRect.Max.Y, Registration.StampedRect.Max.Y);
+	}
+	else
 	{
-		UV0.SetNumUninitialized(VertexCount);
-		float DeltaX = 1.0f / float(XCount);
-		float DeltaY = 1.0f / float(YCount);
+		DirtyRectOut = bHadStamp ? OldRect : Registration.StampedRect;
+	}
 
-		int32 Index = 0; 
+	return true;
+}
 
-		for (int32 Y = 0; Y <= YCount; Y++)
-		{
-			for (int32 X = 0; X <= XCount; X++)
-			{
-				FVector2D UV(
-					float(X) * DeltaX,
-					float(Y) * DeltaY
-				);
 
-				UV0[Index] = UV;
-				Index++;
-			}
-		}
+// Debugging and Visualization --------------------------------
+
+
+bool AGAGridActor::RefreshDebugMesh()
+{
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_RefreshDebugMesh);
+	TRACE_CPUPROFILER_EVENT_SCOPE(AGAGridActor::RefreshDebugMesh);
+
+	if (!DebugMeshComponent)
+	{
+		return false;
 	}
 
-	// Generate the UV coordinates for each vertex
-	// For now, assume all are straight up
+	DebugMeshComponent->ClearAllMeshSections();
+	DebugMeshBuiltChunkSize = 0;
+	return RefreshDirtyDebugMeshChunks();
+}
+
+void AGAGridActor::MarkDebugMeshDirty(const FIntRect& DirtyRect)
+{
+	if (DebugMeshBuiltChunkSize <= 0)
 	{
-		Normals.SetNumUninitialized(VertexCount);
-		int32 Index = 0;
+		return;
+	}
+
+	// A cell's height feeds the four vertices at its corners, which can sit on the edge of the neighbouring
+	// chunks, so grow the rect by one cell before mapping it to chunks
+	int32 MinChunkX = FMath::Max(DirtyRect.Min.X - 1, 0) / DebugMeshBuiltChunkSize;
+	int32 MinChunkY = FMath::Max(DirtyRect.Min.Y - 1, 0) / DebugMeshBuiltChunkSize;
+	int32 MaxChunkX = FMath::Min(FMath::Min(DirtyRect.Max.X + 1, XCount - 1) / DebugMeshBuiltChunkSize, DebugMeshChunkXCount - 1);
+	int32 MaxChunkY = FMath::Min(FMath::Min(DirtyRect.Max.Y + 1, YCount - 1) / DebugMeshBuiltChunkSize, DebugMeshChunkYCount - 1);
 
-		for (int32 Y = 0; Y <= YCount; Y++)
+	for (int32 ChunkY = MinChunkY; ChunkY <= MaxChunkY; ChunkY++)
+	{
+		for (int32 ChunkX = MinChunkX; ChunkX <= MaxChunkX; ChunkX++)
 		{
-			for (int32 X = 0; X <= XCount; X++)
-			{
-				Normals[Index] = FVector::UpVector;
-				Index++;
-			}
+			DebugMeshDirtyChunks[ChunkY * DebugMeshChunkXCount + ChunkX] = true;
 		}
 	}
 
-	DebugMeshComponent->CreateMeshSection(
-		0,				// section index
-		Vertices,		
-		Triangles,
-		Normals,
-		UV0,
-		VertexColors,
-		Tangents,
-		false  // create collision
-	);
-
-	return true;
+	UWorld* World = GetWorld();
+	if (World && World->IsGameWorld())
+	{
+		bDebugMeshRefreshPending = true;
+		RefreshTickEnabled();
+	}
+	else
+	{
+		RefreshDirtyDebugMeshChunks();
+	}
 }
 
-bool AGAGridActor::RefreshDebugTexture()
+bool AGAGridActor::RefreshDirtyDebugMeshChunks()
 {
-	bool Result = false;
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_RefreshDebugMesh);
+	TRACE_CPUPROFILER_EVENT_SCOPE(AGAGridActor::RefreshDirtyDebugMeshChunks);
 
-	// Note: this is for debugging the map rendering
-	/*
+	if (!DebugMeshComponent || XCount <= 0 || YCount <= 0 || Data.Num() != XCount * YCount || HeightData.Num() != XCount * YCount)
 	{
-		FGridBox Box(XCount / 4, XCount - XCount / 4, YCount / 4, YCount - YCount / 4);
-		DebugGridMap = FGAGridMap(this, Box, 0.0f);
-		for (int32 Y = Box.MinY; Y <= Box.MaxY; Y++)
-		{
-			for (int32 X = Box.MinX; X <= Box.MaxX; X++)
-			{
-				DebugGridMap.SetValue(FCellRef(X, Y), float((X-Box.MinX) + (Y - Box.MinY)));
-			}
-		}
+		return false;
 	}
-	*/
 
-	if (DebugMeshComponent)
+	int32 ChunkSize = FMath::Max(DebugMeshChunkSize, 1);
+	int32 ChunkXCount = FMath::DivideAndRoundUp(XCount, ChunkSize);
+	int32 ChunkYCount = FMath::DivideAndRoundUp(YCount, ChunkSize);
+
+	// Layout changed (or never built) -- everything goes
+	if (ChunkSize != DebugMeshBuiltChunkSize || ChunkXCount != DebugMeshChunkXCount || ChunkYCount != DebugMeshChunkYCount)
 	{
-		// create a new texture
-		UTexture2D *RuntimeTexture = UTexture2D::CreateTransient(XCount, YCount);
-		FTexture2DMipMap *FirstMip = &RuntimeTexture->GetPlatformData()->Mips[0];
-		FByteBulkData *ImageData = &FirstMip->BulkData;
-		uint8* RawImageData = (uint8*)ImageData->Lock(LOCK_READ_WRITE);
-		int32 ElementCount = ImageData->GetElementCount();
-		int32 ElementSize = ImageData->GetElementSize();
+		DebugMeshComponent->ClearAllMeshSections();
+		DebugMeshBuiltChunkSize = ChunkSize;
+		DebugMeshChunkXCount = ChunkXCount;
+		DebugMeshChunkYCount = ChunkYCount;
+		DebugMeshDirtyChunks.Init(true, ChunkXCount * ChunkYCount);
+	}
 
-		check(ElementCount == 4 * XCount * YCount);
-		check(ElementSize == sizeof(uint8));
+	TArray<int32> DirtyChunks;
+	for (TConstSetBitIterator<> It(DebugMeshDirtyChunks); It; ++It)
+	{
+		DirtyChunks.Add(It.GetIndex());
+	}
 
-		int32 Index = 0;
+	if (DirtyChunks.Num() == 0)
+	{
+		return true;
+	}
 
-		if (DebugGridMap.IsValid())
-		{
-			float MaxValue;
-			DebugGridMap.GetMaxValue(MaxValue, BIG_NUMBER);
+	struct FChunkGeometry
+	{
+		TArray<FVector> Vertices;
+		TArray<int32> Triangles;
+		TArray<FVector> Normals;
+		TArray<FVector2D> UV0;
+	};
+	TArray<FChunkGeometry> Geometry;
+	Geometry.SetNum(DirtyChunks.Num());
+
+	FVector2D ZeroZeroCorner(
+		-float(XCount) * CellScale * 0.5f,
+		-float(YCount) * CellScale * 0.5f);
+	float DeltaU = 1.0f / float(XCount);
+	float DeltaV = 1.0f / float(YCount);
+
+	auto IsTraversableIndex = [this](int32 X, int32 Y)
+	{
+		return X >= 0 && X < XCount && Y >= 0 && Y < YCount
+			&& EnumHasAllFlags(Data[Y * XCount + X], ECellData::CellDataTraversable);
+	};
 
-			for (int32 Y = 0; Y < YCount; Y++)
+	// Chunks only read the grid and write their own geometry, so they build in parallel
+	ParallelFor(DirtyChunks.Num(), [&](int32 DirtyIndex)
+	{
+		int32 ChunkIndex = DirtyChunks[DirtyIndex];
+		int32 MinX = (ChunkIndex % ChunkXCount) * ChunkSize;
+		int32 MinY = (ChunkIndex / ChunkXCount) * ChunkSize;
+		int32 Width = FMath::Min(ChunkSize, XCount - MinX);
+		int32 Height = FMath::Min(ChunkSize, YCount - MinY);
+		int32 VertexXCount = Width + 1;
+		int32 VertexCount = VertexXCount * (Height + 1);
+
+		FChunkGeometry& Chunk = Geometry[DirtyIndex];
+		Chunk.Vertices.SetNumUninitialized(VertexCount);
+		Chunk.Normals.SetNumUninitialized(VertexCount);
+		Chunk.UV0.SetNumUninitialized(VertexCount);
+
+		// Vertices sit at the corners between cells, so their height is the average of the traversable cells
+		// around them. This is okay because it's just for debugging
+		int32 Index = 0;
+		for (int32 Y = MinY; Y <= MinY + Height; Y++)
+		{
+			for (int32 X = MinX; X <= MinX + Width; X++)
 			{
-				for (int32 X = 0; X < XCount; X++)
+				float H = 0.0f;
+				int32 HCount = 0;
+
+				for (int32 DY = -1; DY <= 0; DY++)
 				{
-					FCellRef CellRef(X, Y);
-					ECellData CellData = GetCellData(CellRef);
-					bool Traversable = EnumHasAllFlags(CellData, ECellData::CellDataTraversable);
-
-					float MapValue;
-					bool IsOnMap = DebugGridMap.GetValue(CellRef, MapValue);
-					int32 IntVal = 0;
-					if (IsOnMap)
+					for (int32 DX = -1; DX <= 0; DX++)
 					{
-						IntVal = FMath::RoundToInt(255.0f * (MapValue / MaxValue));
+						if (IsTraversableIndex(X + DX, Y + DY))
+						{
+							H += HeightData[(Y + DY) * XCount + (X + DX)];
+							HCount++;
+						}
 					}
+				}
 
-					// Note: fade from blue to red as we approach the max value in the debug map
-
-					RawImageData[Index] = IsOnMap ? 255 - IntVal : 0;		// blue		Are we on the map or not?
-					RawImageData[Index + 1] = Traversable ? 50 : 0;			// green	Are we traversable or not?
-					RawImageData[Index + 2] = IntVal;						// red		The value
-					RawImageData[Index + 3] = 255;							// alpha
-
-					Index += 4;
+				if (HCount > 0)
+				{
+					H /= float(HCount);
 				}
-			}
 
+				Chunk.Vertices[Index] = FVector(float(X) * CellScale + ZeroZeroCorner.X, float(Y) * CellScale + ZeroZeroCorner.Y, H + DebugMeshZOffset);
+				Chunk.Normals[Index] = FVector::UpVector;
+				Chunk.UV0[Index] = FVector2D(float(X) * DeltaU, float(Y) * DeltaV);
+				Index++;
+			}
 		}
-		else
+
+		// Triangles with counter-clockwise winding, skipping non traversable cells.
+		// Note: the labels of "bottom" and "left" etc. below are using UE's weird left-hand coordinate system,
+		// whereby X is the "right" direction and Y is the "down" direction
+		Chunk.Triangles.Reserve(Width * Height * 6);
+		for (int32 Y = 0; Y < Height; Y++)
 		{
-			for (int32 Y = 0; Y < YCount; Y++)
+			for (int32 X = 0; X < Width; X++)
 			{
-				for (int32 X = 0; X < XCount; X++)
+				if (!IsTraversableIndex(MinX + X, MinY + Y))
 				{
-					ECellData CellData = GetCellData(FCellRef(X, Y));
-					bool Traversable = EnumHasAllFlags(CellData, ECellData::CellDataTraversable);
-					uint8 Val = Traversable ? 255 : 0;
+					continue;
+				}
 
-					RawImageData[Index] = Val;			// blue 
-					RawImageData[Index + 1] = Val;		// green
-					RawImageData[Index + 2] = Val;		// red
-					RawImageData[Index + 3] = 255;		// alpha
+				int32 Index0 = Y * VertexXCount + X;		// Top left
+				int32 Index1 = Index0 + VertexXCount;		// Bottom left
+				int32 Index2 = Index1 + 1;					// Bottom right
+				int32 Index3 = Index0 + 1;					// Top right
 
-					Index += 4;
-				}
+				// First triangle - bottom right half of the cell
+				Chunk.Triangles.Add(Index0);
+				Chunk.Triangles.Add(Index1);
+				Chunk.Triangles.Add(Index2);
+
+				// Second triangle - top left half of the cell
+				Chunk.Triangles.Add(Index0);
+				Chunk.Triangles.Add(Index2);
+				Chunk.Triangles.Add(Index3);
 			}
 		}
+	});
+
+	// Handing the sections over has to happen here, on the game thread
+	TArray<FColor> VertexColors;			// can safely leave empty
+	TArray<FProcMeshTangent> Tangents;		// can safely leave empty
 
-		ImageData->Unlock();
-		RuntimeTexture->UpdateResource();
+	for (int32 DirtyIndex = 0; DirtyIndex < DirtyChunks.Num(); DirtyIndex++)
+	{
+		int32 SectionIndex = DirtyChunks[DirtyIndex];
+		FChunkGeometry& Chunk = Geometry[DirtyIndex];
 
-		UMaterialInstanceDynamic* DynamicMaterial = DebugMeshComponent->CreateDynamicMaterialInstance(0, DebugMaterial);
-		if (DynamicMaterial)
+		if (Chunk.Triangles.Num() == 0)
 		{
-			DynamicMaterial->SetTextureParameterValue("DebugTexture", RuntimeTexture);
-			DebugMeshComponent->SetMaterial(0, DynamicMaterial);
+			DebugMeshComponent->ClearMeshSection(SectionIndex);
+			continue;
 		}
 
-		Result = true;
+		DebugMeshComponent->CreateMeshSection(
+			SectionIndex,
+			Chunk.Vertices,
+			Chunk.Triangles,
+			Chunk.Normals,
+			Chunk.UV0,
+			VertexColors,
+			Tangents,
+			false  // create collision
+		);
+
+		if (DebugMaterialInstance)
+		{
+			DebugMeshComponent->SetMaterial(SectionIndex, DebugMaterialInstance);
+		}
 	}
 
-	return Result;
+	DebugMeshDirtyChunks.Init(false, ChunkXCount * ChunkYCount);
+	return true;
+}
+
+void AGAGridActor::SetDebugGridMap(const FGAGridMap& Map)
+{
+	DebugGridMap = Map;
+	DebugGridMapVersion++;
+	DebugGridMapPyramid.Build(DebugGridMap, BIG_NUMBER, DebugGridMapVersion);
+	MarkDebugTextureDirty();
+}
+
+void AGAGridActor::NotifyDebugGridMapChanged()
+{
+	DebugGridMapVersion++;
+	MarkDebugTextureDirty();
+}
+
+bool AGAGridActor::SetDebugGridMapValue(const FCellRef& CellRef, float Value)
+{
+	// Writes through the pyramid keep it current, so these don't bump the version
+	if (!DebugGridMapPyramid.IsBuiltFor(DebugGridMap, DebugGridMapVersion))
+	{
+		DebugGridMapPyramid.Build(DebugGridMap, BIG_NUMBER, DebugGridMapVersion);
+	}
+
+	if (!DebugGridMapPyramid.SetValue(CellRef, Value))
+	{
+		return false;
+	}
+
+	MarkDebugTextureDirty(FIntRect(CellRef.X, CellRef.Y, CellRef.X, CellRef.Y));
+	return true;
+}
+
+void AGAGridActor::MarkDebugTextureDirty(const FIntRect& DirtyRect)
+{
+	if (!bDebugTextureDirty)
+	{
+		DebugTextureDirtyRect = DirtyRect;
+		bDebugTextureDirty = true;
+	}
+	else
+	{
+		DebugTextureDirtyRect.Union(DirtyRect);
+	}
+}
+
+void AGAGridActor::MarkDebugTextureDirty()
+{
+	MarkDebugTextureDirty(FIntRect(0, 0, XCount - 1, YCount - 1));
+}
+
+FColor AGAGridActor::GetDebugTexel(int32 X, int32 Y, float MaxValue) const
+{
+	bool Traversable = EnumHasAllFlags(Data[Y * XCount + X], ECellData::CellDataTraversable);
+
+	if (!DebugGridMap.IsValid())
+	{
+		uint8 Val = Traversable ? 255 : 0;
+		return FColor(Val, Val, Val, 255);
+	}
+
+	const FGridBox& Bounds = DebugGridMap.GridBounds;
+	bool IsOnMap = (X >= Bounds.MinX && X <= Bounds.MaxX && Y >= Bounds.MinY && Y <= Bounds.MaxY);
+	int32 IntVal = 0;
+	if (IsOnMap && MaxValue > 0.0f)
+	{
+		float MapValue = DebugGridMap.Data[(Y - Bounds.MinY) * (Bounds.MaxX - Bounds.MinX + 1) + (X - Bounds.MinX)];
+		IntVal = FMath::Clamp(FMath::RoundToInt(255.0f * (MapValue / MaxValue)), 0, 255);
+	}
+
+	// Note: fade from blue to red as we approach the max value in the debug map
+	return FColor(
+		IntVal,									// red		The value
+		Traversable ? 50 : 0,					// green	Are we traversable or not?
+		IsOnMap ? 255 - IntVal : 0,				// blue		Are we on the map or not?
+		255);									// alpha
 }
 
-UE_ENABLE_OPTIMIZATION
+bool AGAGridActor::RefreshDebugTexture()
+{
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_RefreshDebugTexture);
+	TRACE_CPUPROFILER_EVENT_SCOPE(AGAGridActor::RefreshDebugTexture);
+
+	if (!DebugMeshComponent || XCount <= 0 || YCount <= 0 || Data.Num() != XCount * YCount)
+	{
+		return false;
+	}
+
+	// (Re)create the texture only when the grid size changes
+	if (!DebugTexture || DebugTexture->GetSizeX() != XCount || DebugTexture->GetSizeY() != YCount)
+	{
+		DebugTexture = UTexture2D::CreateTransient(XCount, YCount, PF_B8G8R8A8);
+		DebugTexture->UpdateResource();
+		DebugMaterialInstance = nullptr;
+		MarkDebugTextureDirty();
+	}
+
+	if (!DebugMaterialInstance || DebugMaterialInstance->Parent != DebugMaterial)
+	{
+		DebugMaterialInstance = DebugMeshComponent->CreateDynamicMaterialInstance(0, DebugMaterial);
+		if (DebugMaterialInstance)
+		{
+			DebugMaterialInstance->SetTextureParameterValue("DebugTexture", DebugTexture);
+		}
+	}
+
+	// Colors are relative to the max, so if it moved every texel has to be redone
+	float MaxValue = 0.0f;
+	if (DebugGridMap.IsValid())
+	{
+		// The pyramid is normally already up to date, in which case this is O(1)
+		if (!DebugGridMapPyramid.IsBuiltFor(DebugGridMap, DebugGridMapVersion))
+		{
+			DebugGridMapPyramid.Build(DebugGridMap, BIG_NUMBER, DebugGridMapVersion);
+		}
+		DebugGridMapPyramid.GetMaxValue(MaxValue);
+	}
+
+	if (MaxValue != DebugTextureMaxValue)
+	{
+		DebugTextureMaxValue = MaxValue;
+		MarkDebugTextureDirty();
+	}
+
+	if (!bDebugTextureDirty)
+	{
+		return true;
+	}
+
+	FIntRect Rect(
+		FMath::Max(DebugTextureDirtyRect.Min.X, 0),
+		FMath::Max(DebugTextureDirtyRect.Min.Y, 0),
+		FMath::Min(DebugTextureDirtyRect.Max.X, XCount - 1),
+		FMath::Min(DebugTextureDirtyRect.Max.Y, YCount - 1));
+	bDebugTextureDirty = false;
+
+	if (Rect.Min.X > Rect.Max.X || Rect.Min.Y > Rect.Max.Y)
+	{
+		return true;
+	}
+
+	// The render thread reads the texels some time later, so they go in their own allocation which the cleanup
+	// callback frees
+	int32 Width = Rect.Max.X - Rect.Min.X + 1;
+	int32 Height = Rect.Max.Y - Rect.Min.Y + 1;
+	FColor* Texels = new FColor[Width * Height];
+
+	for (int32 Y = 0; Y < Height; Y++)
+	{
+		FColor* Row = Texels + Y * Width;
+		for (int32 X = 0; X < Width; X++)
+		{
+			Row[X] = GetDebugTexel(Rect.Min.X + X, Rect.Min.Y + Y, MaxValue);
+		}
+	}
+
+	FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(Rect.Min.X, Rect.Min.Y, 0, 0, Width, Height);
+	DebugTexture->UpdateTextureRegions(0, 1, Region, Width * sizeof(FColor), sizeof(FColor), (uint8*)Texels,
+		[](uint8* SrcData, const FUpdateTextureRegion2D* Regions)
+		{
+			delete[] (FColor*)SrcData;
+			delete Regions;
+		});
+
+	// One material slot per debug mesh chunk
+	if (DebugMaterialInstance)
+	{
+		for (int32 SectionIndex = 0; SectionIndex < DebugMeshComponent->GetNumSections(); SectionIndex++)
+		{
+			if (DebugMeshComponent->GetMaterial(SectionIndex) != DebugMaterialInstance)
+			{
+				DebugMeshComponent->SetMaterial(SectionIndex, DebugMaterialInstance);
+			}
+		}
+	}
+
+	return true;
+}
@@ -2,13 +2,20 @@
 
 #include "CoreMinimal.h"
 #include "Math/MathFwd.h"
+#include "Components/SceneComponent.h"
 #include "GAGridMap.h"
+#include "GAGridOverlay.h"
+#include "GAGridPVS.h"
+#include "GAGridMapPyramid.h"
+#include "GAGridMip.h"
+#include "GACoreGrid.h"
 #include "GAGridActor.generated.h"
 
 class UBoxComponent;
 class USceneComponent;
 class UProceduralMeshComponent;
 class UTexture2D;
+class UMaterialInstanceDynamic;
 
 UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
 enum class ECellData : uint8
@@ -64,6 +71,65 @@ struct FCellRef
 };
 
 
+// Structure-of-arrays batch of world positions, used by the batched coordinate conversions on AGAGridActor.
+// Keeping the components in separate arrays lets us convert four points at a time with VectorRegister math.
+struct FGAPositionsSoA
+{
+	TArray<float> X;
+	TArray<float> Y;
+	TArray<float> Z;
+
+	int32 Num() const { return X.Num(); }
+
+	void SetNumUninitialized(int32 Count)
+	{
+		X.SetNumUninitialized(Count);
+		Y.SetNumUninitialized(Count);
+		Z.SetNumUninitialized(Count);
+	}
+};
+
+
+// Cached grid-to-world affine.
+// "Cell space" here means grid space divided by CellScale, i.e. (0, 0) is the min corner of the (0, 0) cell
+// and one unit is one cell. Everything is stored relative to Origin (the actor location) so that the float
+// math stays precise.
+struct FGAGridTransformCache
+{
+	FGAGridTransformCache() : bValid(false) {}
+
+	// World position the cached offsets are relative to
+	FVector Origin;
+
+	// World -> cell space: CellX = (P - Origin) | WorldToCellX + CellOffset.X
+	FVector3f WorldToCellX;
+	FVector3f WorldToCellY;
+	FVector2f CellOffset;
+
+	// Cell space -> world: P = Origin + CellZeroCenter + X * CellToWorldX + Y * CellToWorldY + Height * HeightToWorld
+	FVector3f CellZeroCenter;
+	FVector3f CellToWorldX;
+	FVector3f CellToWorldY;
+	FVector3f HeightToWorld;
+
+	bool bValid;
+};
+
+
+// Broadcast whenever a rectangle of cells changes traversability or cost (in cell indices, inclusive)
+DECLARE_MULTICAST_DELEGATE_OneParam(FGAGridCellsChanged, const FIntRect& /*DirtyRect*/);
+
+// What a NotifyCellsChanged call is about
+enum class EGACellChange : uint8
+{
+	// The static Data or HeightData (nav refresh, or cells written from code)
+	Data,
+
+	// Only the dynamic overlay (footprints stamped or erased)
+	Overlay,
+};
+
+
 UCLASS(BlueprintType, Blueprintable)
 class AGAGridActor : public AActor 
 {
@@ -105,6 +171,9 @@ public:
 	TArray<float> HeightData;
 
 	virtual void PostLoad() override;
+	virtual void PostRegisterAllComponents() override;
+	virtual void PostUnregisterAllComponents() override;
+	virtual void Tick(float DeltaSeconds) override;
 
 #if WITH_EDITORONLY_DATA
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
@@ -122,9 +191,24 @@ private:
 
 	void RefreshDerivedValues();
 
+	// Grid transform cache --------------------------------
+
+	FGAGridTransformCache TransformCache;
+
+	void RefreshTransformCache();
+	void BuildTransformCache(FGAGridTransformCache& CacheOut) const;
+	void OnRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	// Returns the cached transform, or builds a temporary one into Scratch if the cache hasn't been set up yet
+	const FGAGridTransformCache& GetTransformCache(FGAGridTransformCache& Scratch) const;
+
 public:
 	bool ResetData();
 
+	// Changes the dimensions and clears the data, for grids built from code rather than from the nav mesh.
+	// Call NotifyCellsChanged once the new data is written
+	bool ResizeGrid(int32 InXCount, int32 InYCount, float InCellScale);
+
 	// Accessors --------------------------------
 
 	// Return the cell the given point is inside of
@@ -140,6 +224,16 @@ public:
 	UFUNCTION(BlueprintCallable)
 	bool IsCellRefInBounds(const FCellRef& CellRef) const;
 
+	// Batched versions of GetCellRef and GetCellPosition.
+	// The SoA versions are the fast path: they run four points at a time through SIMD registers.
+	// Cells that are out of bounds (when bClamp = false) come back as INDEX_NONE in both X and Y.
+	void GetCellRefs(const FGAPositionsSoA& Points, TArray<int32>& CellXOut, TArray<int32>& CellYOut, bool bClamp = false) const;
+	void GetCellRefs(const float* PointsX, const float* PointsY, const float* PointsZ, int32 Count, int32* CellXOut, int32* CellYOut, bool bClamp = false) const;
+	void GetCellRefs(TConstArrayView<FVector> Points, TArray<FCellRef>& CellsOut, bool bClamp = false) const;
+
+	void GetCellPositions(const int32* CellX, const int32* CellY, int32 Count, FGAPositionsSoA& PositionsOut) const;
+	void GetCellPositions(TConstArrayView<FCellRef> Cells, TArray<FVector>& PositionsOut) const;
+
 	// Get the grid-space position of the center of the given cell
 	// Note, grid-space is a bit of a weird idea.
 	// In actor space, (0, 0) is the center of the grid
@@ -148,6 +242,10 @@ public:
 	// where HalfExtents is 0.5 the total width and height of the grid
 	FVector2D GetCellGridSpacePosition(const FCellRef& CellRef) const;
 
+	// The point relative to the min corner of the (0, 0) cell, in units of cells (Z is dropped). Not clamped, so
+	// points outside the grid come back outside [0, XCount] x [0, YCount]
+	FVector2f GetCellSpacePosition(const FVector& Point) const;
+
 
 	// Return the flattened index of the cell
 	// The assumes a X-major ordering of the data array.
@@ -165,6 +263,62 @@ public:
 	UFUNCTION(BlueprintCallable)
 	float GetCellHeightData(const FCellRef &CellRef) const;
 
+	// Is the cell in bounds, traversable in the base data AND not blocked by the overlay?
+	bool IsCellTraversable(const FCellRef& CellRef) const;
+
+	// Cost of stepping into the given cell: 1 plus any overlay cost
+	float GetCellCost(const FCellRef& CellRef) const;
+
+	// Walks every cell the segment between the two cell centers touches, and returns true if all are traversable
+	UFUNCTION(BlueprintCallable)
+	bool HasLineOfSight(const FCellRef& From, const FCellRef& To) const;
+
+	// The cell flags and overlay, as handed to the engine-independent algorithms in GACore.
+	// Points into Data and Overlay, so don't hold onto it past a rebuild or resize
+	GACore::FGridView GetCoreGrid() const;
+
+	// A copy of what GetCoreGrid points at, for searches that run on another thread while the grid keeps changing.
+	// The overlay's block counts are only copied if anything is blocked
+	GACore::FGridStorage CopyCoreGrid() const;
+
+	// CopyCoreGrid, shared. The copy is only taken again once the grid has changed (see GetGridVersion), so the
+	// background searches started between two changes all read the same one. Game thread only
+	TSharedPtr<const GACore::FGridStorage, ESPMode::ThreadSafe> GetSharedCoreGrid() const;
+
+	// Visibility --------------------------------
+
+	// Computes which cells can be seen from Origin, for the whole grid in one pass, using symmetric shadowcasting
+	// (cell A sees cell B exactly when B sees A). Blocking cells that border visible space are marked visible too.
+	// If MaxRadius > 0, only cells within that many cells of Origin are considered.
+	// VisibleOut is indexed like Data (see CellRefToIndex). With bIncludeOverlay false, only the static Data blocks sight.
+	void ComputeVisibility(const FCellRef& Origin, TBitArray<>& VisibleOut, int32 MaxRadius = 0, bool bIncludeOverlay = true) const;
+
+	// The same over any view of the cells, such as a copy taken for another thread. The view's overlay blocks sight
+	static void ComputeVisibility(const GACore::FGridView& Grid, const FCellRef& Origin, TBitArray<>& VisibleOut, int32 MaxRadius = 0);
+
+	// Same as above, but writes 1 (visible) or 0 into a full-grid map
+	UFUNCTION(BlueprintCallable)
+	bool ComputeVisibilityMap(const FCellRef& Origin, FGAGridMap& VisibilityOut, int32 MaxRadius = 0) const;
+
+	// Can cell A see cell B? Uses the baked PVS when there is one, otherwise falls back to HasLineOfSight.
+	// The PVS only covers the static Data, so a pair it calls visible is then checked against the overlay alone,
+	// along the line between them. See FGAGridPVS for the precision trade-offs of the baked version
+	UFUNCTION(BlueprintCallable)
+	bool IsVisible(const FCellRef& A, const FCellRef& B) const;
+
+	// Precomputed cell-to-cell visibility for static levels. Stored with the actor
+	UPROPERTY(EditAnywhere)
+	FGAGridPVS PVS;
+
+	// Bake PVS from the current Data (the overlay is left out, see FGAGridPVS)
+	UFUNCTION(BlueprintCallable, CallInEditor)
+	void BakePVS();
+
+	// Times QueryCount random PVS lookups against the same queries done with HasLineOfSight, and logs the timings,
+	// PVS memory and how often the PVS agrees with ComputeVisibility over the static Data, which is what it's baked from
+	UFUNCTION(BlueprintCallable, CallInEditor)
+	void BenchmarkPVS(int32 QueryCount = 100000, int32 Seed = 1234) const;
+
 	// Returns the bounds of the given box in cell indices
 	// Note, assumes the Box is in grid-space already
 	// Returns an invalid rectangle if the Box and the grid are disjoint
@@ -176,9 +330,83 @@ public:
 	UFUNCTION(BlueprintCallable)
 	bool RefreshDataFromNav();
 
+	// Dynamic overlay --------------------------------
+	// Registered actors stamp their footprint into an overlay that is combined with Data at query time.
+	// Footprints are re-stamped incrementally (erase old, stamp new) when an actor changes cell.
+
+	UFUNCTION(BlueprintCallable)
+	void RegisterOverlayActor(AActor* Actor, const FGAOverlayFootprint& Footprint);
+
+	UFUNCTION(BlueprintCallable)
+	void UnregisterOverlayActor(AActor* Actor);
+
+	// Re-stamp any registered actors that have moved. Called from Tick, but can be called manually too
+	UFUNCTION(BlueprintCallable)
+	void UpdateOverlay();
+
+	// Bumped every time traversability or cost changes anywhere on the grid, including overlay restamps
+	uint32 GetGridVersion() const { return GridVersion; }
+
+	// Bumped only when Data or HeightData change. Overlay restamps leave it alone, so things derived from the
+	// static data alone can be kept across them
+	uint32 GetDataVersion() const { return DataVersion; }
+
+	// CRC of Data as of the last static change. Unlike the versions this is the same after a save and load,
+	// so data baked into the level (the PVS) can be checked against it
+	uint32 GetDataHash() const { return DataHash; }
+
+	// Fires with the changed region whenever traversability or cost changes.
+	// Mutable so that listeners holding a const grid (which is most of them) can subscribe
+	mutable FGAGridCellsChanged OnCellsChanged;
+
+	void NotifyCellsChanged(const FIntRect& DirtyRect, EGACellChange Change = EGACellChange::Data);
+
+	// Downsampled traversability/height levels for coarse-to-fine queries. Kept current by NotifyCellsChanged
+	const FGAGridMipChain& GetMipChain() const { return MipChain; }
+
+private:
+	FGAGridOverlay Overlay;
+	FGAGridMipChain MipChain;
+	TArray<FGAOverlayRegistration> OverlayRegistrations;
+	uint32 GridVersion;
+	uint32 DataVersion;
+	uint32 DataHash;
+
+	// The last GetSharedCoreGrid copy, and the GridVersion it was taken at
+	mutable TSharedPtr<const GACore::FGridStorage, ESPMode::ThreadSafe> SharedCoreGrid;
+	mutable uint32 SharedCoreGridVersion = 0;
+
+	void RefreshDataHash();
+
+	// Is no cell on the line between the two (in-bounds) cells blocked in the overlay? Static Data is ignored
+	bool IsOverlayLineClear(const FCellRef& From, const FCellRef& To) const;
+
+	// Ticking is only needed while something is registered with the overlay or the debug mesh has a refresh pending
+	void RefreshTickEnabled();
+
+	// Returns true and fills in DirtyRectOut if the registration's footprint changed
+	bool RestampOverlayRegistration(FGAOverlayRegistration& Registration, bool bForce, FIntRect& DirtyRectOut);
+	void EraseOverlayRegistration(FGAOverlayRegistration& Registration);
+
+public:
+
 	// Debugging and Visualization --------------------------------
+	// Note: from code, write this through SetDebugGridMap/SetDebugGridMapValue so the max pyramid stays in sync,
+	// or call NotifyDebugGridMapChanged after writing it directly
 	UPROPERTY(EditAnywhere)
 	FGAGridMap DebugGridMap;
+
+	// Max pyramid over DebugGridMap, so RefreshDebugTexture doesn't have to scan for the max
+	FGAGridMapPyramid DebugGridMapPyramid;
+
+	UFUNCTION(BlueprintCallable)
+	void SetDebugGridMap(const FGAGridMap& Map);
+
+	UFUNCTION(BlueprintCallable)
+	bool SetDebugGridMapValue(const FCellRef& CellRef, float Value);
+
+	// DebugGridMap was written without going through the setters: rebuild the pyramid and texture on next use
+	void NotifyDebugGridMapChanged();
 	// Debug mesh component
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	TObjectPtr<UProceduralMeshComponent> DebugMeshComponent;
@@ -189,10 +417,53 @@ public:
 	UPROPERTY(EditAnywhere)
 	TObjectPtr<UMaterialInterface> DebugMaterial;
 
+	// The debug mesh is split into sections of DebugMeshChunkSize x DebugMeshChunkSize cells
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "1"))
+	int32 DebugMeshChunkSize;
+
+	// Rebuilds every chunk
 	UFUNCTION(BlueprintCallable)
 	bool RefreshDebugMesh();
 
+	// Rebuilds only the chunks touched since the last refresh (see MarkDebugMeshDirty)
+	UFUNCTION(BlueprintCallable)
+	bool RefreshDirtyDebugMeshChunks();
+
+	// Flags the chunks over the region (inclusive cell indices) and schedules RefreshDirtyDebugMeshChunks for the
+	// next tick, so several changes in a frame cost one rebuild. Editor worlds don't tick, so there it runs right away.
+	// Does nothing until the mesh has been built once with RefreshDebugMesh.
+	// Called from NotifyCellsChanged; call it yourself after writing Data or HeightData directly
+	void MarkDebugMeshDirty(const FIntRect& DirtyRect);
+
+	// Uploads whatever changed in DebugGridMap (or the cell data) since the last call. The texture and material
+	// instance are created once and reused, and only the dirty region is re-uploaded, unless the map's max
+	// (which the colors are normalized by) changed
 	UFUNCTION(BlueprintCallable)
 	bool RefreshDebugTexture();
 
+	// Forces the next RefreshDebugTexture to re-upload the region (inclusive cell indices), or everything
+	void MarkDebugTextureDirty(const FIntRect& DirtyRect);
+	void MarkDebugTextureDirty();
+
+private:
+	// Bumped for every write to DebugGridMap that bypasses the pyramid, so it knows to rebuild
+	uint32 DebugGridMapVersion = 0;
+
+	FColor GetDebugTexel(int32 X, int32 Y, float MaxValue) const;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UTexture2D> DebugTexture;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UMaterialInstanceDynamic> DebugMaterialInstance;
+
+	TBitArray<> DebugMeshDirtyChunks;
+	bool bDebugMeshRefreshPending = false;
+	int32 DebugMeshBuiltChunkSize = 0;
+	int32 DebugMeshChunkXCount = 0;
+	int32 DebugMeshChunkYCount = 0;
+
+	FIntRect DebugTextureDirtyRect;
+	bool bDebugTextureDirty = true;
+	float DebugTextureMaxValue = 0.0f;
 };
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "GAGridMapCache.h"
+
+
+FGAGridMapHandle FGAGridMapCache::Find(const FGAGridMapCacheKey& Key)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	FEntry* Entry = Entries.Find(Key);
+	if (!Entry)
+	{
+		MissCount++;
+		return FGAGridMapHandle();
+	}
+
+	// Move to the front
+	UsageOrder.RemoveNode(Entry->Node, false);
+	UsageOrder.AddHead(Entry->Node);
+
+	HitCount++;
+	return Entry->Map;
+}
+
+FGAGridMapHandle FGAGridMapCache::Add(const FGAGridMapCacheKey& Key, FGAGridMap&& Map)
+{
+	return Add(Key, MakeShared<const FGAGridMap, ESPMode::ThreadSafe>(MoveTemp(Map)));
+}
+
+FGAGridMapHandle FGAGridMapCache::Add(const FGAGridMapCacheKey& Key, const FGAGridMapHandle& Handle)
+{
+	if (!Handle.IsValid())
+	{
+		return Handle;
+	}
+
+	SIZE_T Bytes = sizeof(FGAGridMap) + Handle->Data.GetAllocatedSize();
+
+	FScopeLock ScopeLock(&Lock);
+
+	if (FEntry* Existing = Entries.Find(Key))
+	{
+		return Existing->Map;
+	}
+
+	UsageOrder.AddHead(Key);
+
+	FEntry& Entry = Entries.Add(Key);
+	Entry.Map = Handle;
+	Entry.Bytes = Bytes;
+	Entry.Node = UsageOrder.GetHead();
+	UsedBytes += Bytes;
+
+	EvictToFit();
+	return Handle;
+}
+
+FGAGridMapHandle FGAGridMapCache::FindOrCompute(const FGAGridMapCacheKey& Key, TFunctionRef<void(FGAGridMap&)> Compute)
+{
+	if (FGAGridMapHandle Cached = Find(Key))
+	{
+		return Cached;
+	}
+
+	// Computing can take a while, so don't hold the lock for it. Two threads racing on the same key will both
+	// compute, and the loser gets the winner's map back from Add
+	FGAGridMap Map;
+	Compute(Map);
+	return Add(Key, MoveTemp(Map));
+}
+
+void FGAGridMapCache::EvictToFit()
+{
+	// Never evict the entry we just added, even if it's bigger than the whole budget on its own
+	while (UsedBytes > MaxBytes && Entries.Num() > 1)
+	{
+		TDoubleLinkedList<FGAGridMapCacheKey>::TDoubleLinkedListNode* Oldest = UsageOrder.GetTail();
+		FEntry Evicted;
+		Entries.RemoveAndCopyValue(Oldest->GetValue(), Evicted);
+		UsageOrder.RemoveNode(Oldest);
+		UsedBytes -= Evicted.Bytes;
+	}
+}
+
+void FGAGridMapCache::Empty()
+{
+	FScopeLock ScopeLock(&Lock);
+	Entries.Empty();
+	UsageOrder.Empty();
+	UsedBytes = 0;
+}
+
+int32 FGAGridMapCache::Invalidate(FObjectKey Grid, TFunctionRef<bool(const FGAGridMapCacheKey&, const FGAGridMap&)> ShouldEvict)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	int32 EvictedCount = 0;
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (It.Key().Grid == Grid && ShouldEvict(It.Key(), *It.Value().Map))
+		{
+			UsageOrder.RemoveNode(It.Value().Node);
+			UsedBytes -= It.Value().Bytes;
+			It.RemoveCurrent();
+			EvictedCount++;
+		}
+	}
+
+	return EvictedCount;
+}
+
+void FGAGridMapCache::SetMaxBytes(SIZE_T InMaxBytes)
+{
+	FScopeLock ScopeLock(&Lock);
+	MaxBytes = InMaxBytes;
+	EvictToFit();
+}
+
+SIZE_T FGAGridMapCache::GetUsedBytes() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return UsedBytes;
+}
+
+int32 FGAGridMapCache::Num() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Entries.Num();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "Containers/List.h"
+#include "GAGridActor.h"
+
+
+// Shared, read-only reference to a cached map. The map stays alive for as long as someone holds a handle,
+// even after the cache has evicted it.
+typedef TSharedPtr<const FGAGridMap, ESPMode::ThreadSafe> FGAGridMapHandle;
+
+
+// What a cached map was computed from. LayerType is up to the caller (e.g. an EGASpatialLayer), and
+// DataVersion makes a change to the grid's static data an automatic miss.
+// Overlay restamps don't change the key -- they happen nearly every frame, and most don't touch most maps.
+// Whoever owns the cache drops the entries an overlay change does affect, with Invalidate.
+struct FGAGridMapCacheKey
+{
+	FObjectKey Grid;
+	int32 LayerType = 0;
+	FCellRef SourceCell;
+	uint32 DataVersion = 0;
+
+	FGAGridMapCacheKey() {}
+	FGAGridMapCacheKey(const AGAGridActor* InGrid, int32 InLayerType, const FCellRef& InSourceCell)
+		: Grid(InGrid), LayerType(InLayerType), SourceCell(InSourceCell), DataVersion(InGrid ? InGrid->GetDataVersion() : 0) {}
+
+	bool operator==(const FGAGridMapCacheKey& Other) const
+	{
+		return Grid == Other.Grid && LayerType == Other.LayerType && SourceCell == Other.SourceCell && DataVersion == Other.DataVersion;
+	}
+
+	friend uint32 GetTypeHash(const FGAGridMapCacheKey& Key)
+	{
+		return HashCombine(HashCombine(GetTypeHash(Key.Grid), uint32(Key.LayerType)), HashCombine(GetTypeHash(Key.SourceCell), Key.DataVersion));
+	}
+};
+
+
+// Least-recently-used cache of computed maps (distance fields, LOS layers ...), bounded by the bytes of map
+// data it holds. Agents that ask for the same layer from the same cell on the same grid data share one
+// map instead of each flooding their own. Thread-safe.
+// Owned by whatever computes the maps (UGASpatialEvaluatorSubsystem), so it goes away with the world.
+class FGAGridMapCache
+{
+public:
+	// Returns the cached map, or an empty handle on a miss. A hit makes the entry the most recently used
+	FGAGridMapHandle Find(const FGAGridMapCacheKey& Key);
+
+	// Caches Map under Key and returns a handle to it. If another thread got there first, returns theirs
+	FGAGridMapHandle Add(const FGAGridMapCacheKey& Key, FGAGridMap&& Map);
+
+	// The same, for a map that's already shared (built on another thread, say)
+	FGAGridMapHandle Add(const FGAGridMapCacheKey& Key, const FGAGridMapHandle& Map);
+
+	// Find, or on a miss run Compute (outside the lock) and Add the result
+	FGAGridMapHandle FindOrCompute(const FGAGridMapCacheKey& Key, TFunctionRef<void(FGAGridMap&)> Compute);
+
+	void Empty();
+
+	// Drops the entries for Grid that ShouldEvict says no longer hold, and returns how many went.
+	// Handles already given out stay valid
+	int32 Invalidate(FObjectKey Grid, TFunctionRef<bool(const FGAGridMapCacheKey&, const FGAGridMap&)> ShouldEvict);
+
+	// Least recently used entries are evicted until the cache fits. Default is 64MB
+	void SetMaxBytes(SIZE_T InMaxBytes);
+
+	SIZE_T GetUsedBytes() const;
+	int32 Num() const;
+	uint64 GetHitCount() const { return HitCount; }
+	uint64 GetMissCount() const { return MissCount; }
+
+private:
+	struct FEntry
+	{
+		FGAGridMapHandle Map;
+		SIZE_T Bytes = 0;
+
+		// Our node in UsageOrder
+		TDoubleLinkedList<FGAGridMapCacheKey>::TDoubleLinkedListNode* Node = nullptr;
+	};
+
+	// Lock must be held
+	void EvictToFit();
+
+	mutable FCriticalSection Lock;
+	TMap<FGAGridMapCacheKey, FEntry> Entries;
+
+	// Most recently used at the head
+	TDoubleLinkedList<FGAGridMapCacheKey> UsageOrder;
+
+	SIZE_T UsedBytes = 0;
+	SIZE_T MaxBytes = 64 * 1024 * 1024;
+	std::atomic<uint64> HitCount = 0;
+	std::atomic<uint64> MissCount = 0;
+};
@@ -0,0 +1,364 @@
+#include "GAGridMapOps.h"
+
+#include "Math/VectorRegister.h"
+
+
+float FGAResponseCurve::Evaluate(float X) const
+{
+	if (Points.Num() == 0)
+	{
+		return X;
+	}
+
+	if (X <= Points[0].X)
+	{
+		return Points[0].Y;
+	}
+
+	for (int32 Index = 1; Index < Points.Num(); Index++)
+	{
+		const FVector2D& P0 = Points[Index - 1];
+		const FVector2D& P1 = Points[Index];
+		if (X <= P1.X)
+		{
+			float Span = P1.X - P0.X;
+			float T = (Span > 0.0f) ? (X - P0.X) / Span : 1.0f;
+			return FMath::Lerp(float(P0.Y), float(P1.Y), T);
+		}
+	}
+
+	return Points.Last().Y;
+}
+
+
+bool FGAGridMapOps::HaveSameBounds(const FGAGridMap& A, const FGAGridMap& B)
+{
+	return (A.GridBounds.MinX == B.GridBounds.MinX) && (A.GridBounds.MaxX == B.GridBounds.MaxX)
+		&& (A.GridBounds.MinY == B.GridBounds.MinY) && (A.GridBounds.MaxY == B.GridBounds.MaxY)
+		&& (A.Data.Num() == B.Data.Num());
+}
+
+FCellRef FGAGridMapOps::IndexToCellRef(const FGAGridMap& Map, int32 Index)
+{
+	int32 Width = GetRowWidth(Map);
+	return FCellRef(Map.GridBounds.MinX + Index % Width, Map.GridBounds.MinY + Index / Width);
+}
+
+
+// Element-wise helpers. Run VectorOp four values at a time and ScalarOp on the leftovers.
+// The maps store their rows back to back, so running over the whole Data array is the same as running every row.
+template <typename VectorOpType, typename ScalarOpType>
+static void BinaryOp(float* OutData, const float* AData, const float* BData, int32 Count, VectorOpType VectorOp, ScalarOpType ScalarOp)
+{
+	int32 Index = 0;
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		VectorStore(VectorOp(VectorLoad(AData + Index), VectorLoad(BData + Index)), OutData + Index);
+	}
+
+	for (; Index < Count; Index++)
+	{
+		OutData[Index] = ScalarOp(AData[Index], BData[Index]);
+	}
+}
+
+template <typename VectorOpType, typename ScalarOpType>
+static bool BinaryOp(FGAGridMap& Out, const FGAGridMap& A, const FGAGridMap& B, VectorOpType VectorOp, ScalarOpType ScalarOp)
+{
+	if (!ensure(FGAGridMapOps::HaveSameBounds(A, B)))
+	{
+		return false;
+	}
+
+	if (&Out != &A && &Out != &B)
+	{
+		Out.GridBounds = A.GridBounds;
+		Out.Data.SetNumUninitialized(A.Data.Num());
+	}
+
+	BinaryOp(Out.Data.GetData(), A.Data.GetData(), B.Data.GetData(), A.Data.Num(), VectorOp, ScalarOp);
+	return true;
+}
+
+template <typename VectorOpType, typename ScalarOpType>
+static void UnaryOp(float* Data, int32 Count, VectorOpType VectorOp, ScalarOpType ScalarOp)
+{
+	int32 Index = 0;
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		VectorStore(VectorOp(VectorLoad(Data + Index)), Data + Index);
+	}
+
+	for (; Index < Count; Index++)
+	{
+		Data[Index] = ScalarOp(Data[Index]);
+	}
+}
+
+template <typename VectorOpType, typename ScalarOpType>
+static void UnaryOp(FGAGridMap& Map, VectorOpType VectorOp, ScalarOpType ScalarOp)
+{
+	UnaryOp(Map.Data.GetData(), Map.Data.Num(), VectorOp, ScalarOp);
+}
+
+
+bool FGAGridMapOps::Add(FGAGridMap& Out, const FGAGridMap& A, const FGAGridMap& B)
+{
+	return BinaryOp(Out, A, B,
+		[](VectorRegister4Float VA, VectorRegister4Float VB) { return VectorAdd(VA, VB); },
+		[](float FA, float FB) { return FA + FB; });
+}
+
+bool FGAGridMapOps::AddScaled(FGAGridMap& Out, const FGAGridMap& A, const FGAGridMap& B, float Weight)
+{
+	if (!ensure(HaveSameBounds(A, B)))
+	{
+		return false;
+	}
+
+	if (&Out != &A && &Out != &B)
+	{
+		Out.GridBounds = A.GridBounds;
+		Out.Data.SetNumUninitialized(A.Data.Num());
+	}
+
+	AddScaled(Out.Data.GetData(), A.Data.GetData(), B.Data.GetData(), Weight, A.Data.Num());
+	return true;
+}
+
+void FGAGridMapOps::AddScaled(float* Out, const float* A, const float* B, float Weight, int32 Count)
+{
+	const VectorRegister4Float VWeight = VectorSetFloat1(Weight);
+	BinaryOp(Out, A, B, Count,
+		[VWeight](VectorRegister4Float VA, VectorRegister4Float VB) { return VectorMultiplyAdd(VB, VWeight, VA); },
+		[Weight](float FA, float FB) { return FA + FB * Weight; });
+}
+
+bool FGAGridMapOps::Multiply(FGAGridMap& Out, const FGAGridMap& A, const FGAGridMap& B)
+{
+	return BinaryOp(Out, A, B,
+		[](VectorRegister4Float VA, VectorRegister4Float VB) { return VectorMultiply(VA, VB); },
+		[](float FA, float FB) { return FA * FB; });
+}
+
+bool FGAGridMapOps::Lerp(FGAGridMap& Out, const FGAGridMap& A, const FGAGridMap& B, float Alpha)
+{
+	const VectorRegister4Float VAlpha = VectorSetFloat1(Alpha);
+	return BinaryOp(Out, A, B,
+		[VAlpha](VectorRegister4Float VA, VectorRegister4Float VB) { return VectorMultiplyAdd(VectorSubtract(VB, VA), VAlpha, VA); },
+		[Alpha](float FA, float FB) { return FA + (FB - FA) * Alpha; });
+}
+
+void FGAGridMapOps::Clamp(FGAGridMap& Map, float MinValue, float MaxValue)
+{
+	const VectorRegister4Float VMin = VectorSetFloat1(MinValue);
+	const VectorRegister4Float VMax = VectorSetFloat1(MaxValue);
+	UnaryOp(Map,
+		[VMin, VMax](VectorRegister4Float V) { return VectorMin(VectorMax(V, VMin), VMax); },
+		[MinValue, MaxValue](float F) { return FMath::Clamp(F, MinValue, MaxValue); });
+}
+
+void FGAGridMapOps::Normalize(FGAGridMap& Map, float IgnoreValue)
+{
+	const float* MapData = Map.Data.GetData();
+	int32 Count = Map.Data.Num();
+
+	// First pass: min and max of the values we're not ignoring
+	const VectorRegister4Float VIgnore = VectorSetFloat1(IgnoreValue);
+	const VectorRegister4Float VBig = VectorSetFloat1(BIG_NUMBER);
+	const VectorRegister4Float VMinusBig = VectorSetFloat1(-BIG_NUMBER);
+	VectorRegister4Float VMinAcc = VBig;
+	VectorRegister4Float VMaxAcc = VMinusBig;
+
+	int32 Index = 0;
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		VectorRegister4Float V = VectorLoad(MapData + Index);
+		VectorRegister4Float Keep = VectorCompareLT(V, VIgnore);
+		VMinAcc = VectorMin(VMinAcc, VectorSelect(Keep, V, VBig));
+		VMaxAcc = VectorMax(VMaxAcc, VectorSelect(Keep, V, VMinusBig));
+	}
+
+	float Mins[4], Maxs[4];
+	VectorStore(VMinAcc, Mins);
+	VectorStore(VMaxAcc, Maxs);
+	float MinValue = FMath::Min(FMath::Min(Mins[0], Mins[1]), FMath::Min(Mins[2], Mins[3]));
+	float MaxValue = FMath::Max(FMath::Max(Maxs[0], Maxs[1]), FMath::Max(Maxs[2], Maxs[3]));
+
+	for (; Index < Count; Index++)
+	{
+		if (MapData[Index] < IgnoreValue)
+		{
+			MinValue = FMath::Min(MinValue, MapData[Index]);
+			MaxValue = FMath::Max(MaxValue, MapData[Index]);
+		}
+	}
+
+	if (MaxValue < MinValue)
+	{
+		// Nothing to normalize
+		return;
+	}
+
+	// Second pass: remap. A flat map goes to all zeros
+	float Range = MaxValue - MinValue;
+	float InvRange = (Range > UE_SMALL_NUMBER) ? 1.0f / Range : 0.0f;
+	const VectorRegister4Float VMinValue = VectorSetFloat1(MinValue);
+	const VectorRegister4Float VInvRange = VectorSetFloat1(InvRange);
+
+	UnaryOp(Map,
+		[VIgnore, VMinValue, VInvRange](VectorRegister4Float V)
+		{
+			return VectorSelect(VectorCompareLT(V, VIgnore), VectorMultiply(VectorSubtract(V, VMinValue), VInvRange), V);
+		},
+		[IgnoreValue, MinValue, InvRange](float F) { return (F < IgnoreValue) ? (F - MinValue) * InvRange : F; });
+}
+
+void FGAGridMapOps::ApplyResponseCurve(FGAGridMap& Map, const FGAResponseCurve& Curve)
+{
+	ApplyResponseCurve(Map.Data.GetData(), Map.Data.Num(), Curve);
+}
+
+void FGAGridMapOps::ApplyResponseCurve(float* Data, int32 Count, const FGAResponseCurve& Curve)
+{
+	const TArray<FVector2D>& Points = Curve.Points;
+	if (Points.Num() == 0)
+	{
+		return;
+	}
+
+	// Each segment is evaluated over the whole register with a clamped t, and later segments win wherever
+	// X has passed their start. That keeps everything branch-free.
+	// "Passed" is strictly greater, so a point shared by two segments (including a vertical step, where two points
+	// have the same X) takes the value at the end of the earlier segment, exactly as Evaluate does for the scalar tail.
+	// Curves are usually a handful of points, so the per-segment constants normally stay on the stack.
+	struct FSegmentConstants
+	{
+		VectorRegister4Float StartX;
+		VectorRegister4Float StartY;
+		VectorRegister4Float DeltaY;
+		VectorRegister4Float InvSpan;
+	};
+
+	TArray<FSegmentConstants, TInlineAllocator<32>> Segments;
+	Segments.Reserve(Points.Num() - 1);
+	for (int32 Segment = 0; Segment + 1 < Points.Num(); Segment++)
+	{
+		const FVector2D& P0 = Points[Segment];
+		const FVector2D& P1 = Points[Segment + 1];
+		float Span = P1.X - P0.X;
+
+		FSegmentConstants& Constants = Segments.AddUninitialized_GetRef();
+		Constants.StartX = VectorSetFloat1(P0.X);
+		Constants.StartY = VectorSetFloat1(P0.Y);
+		Constants.DeltaY = VectorSetFloat1(P1.Y - P0.Y);
+		Constants.InvSpan = VectorSetFloat1((Span > 0.0f) ? 1.0f / Span : BIG_NUMBER);
+	}
+
+	const VectorRegister4Float FirstY = VectorSetFloat1(Points[0].Y);
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float One = VectorOneFloat();
+	const FSegmentConstants* SegmentData = Segments.GetData();
+	const int32 SegmentCount = Segments.Num();
+
+	UnaryOp(Data, Count,
+		[&](VectorRegister4Float X)
+		{
+			VectorRegister4Float Result = FirstY;
+			for (int32 Segment = 0; Segment < SegmentCount; Segment++)
+			{
+				const FSegmentConstants& Constants = SegmentData[Segment];
+				VectorRegister4Float T = VectorMultiply(VectorSubtract(X, Constants.StartX), Constants.InvSpan);
+				T = VectorMin(VectorMax(T, Zero), One);
+				VectorRegister4Float SegmentValue = VectorMultiplyAdd(T, Constants.DeltaY, Constants.StartY);
+				Result = VectorSelect(VectorCompareGT(X, Constants.StartX), SegmentValue, Result);
+			}
+			return Result;
+		},
+		[&Curve](float X) { return Curve.Evaluate(X); });
+}
+
+bool FGAGridMapOps::MaskedMax(const FGAGridMap& Map, const FGAGridMap* Mask, float& MaxValueOut, FCellRef& ArgMaxOut)
+{
+	if (Mask && !ensure(HaveSameBounds(Map, *Mask)))
+	{
+		return false;
+	}
+
+	const float* MapData = Map.Data.GetData();
+	const float* MaskData = Mask ? Mask->Data.GetData() : nullptr;
+	int32 Count = Map.Data.Num();
+
+	// First pass: the max itself, vectorized
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float MinusBig = VectorSetFloat1(-BIG_NUMBER);
+	VectorRegister4Float VMaxAcc = MinusBig;
+
+	int32 Index = 0;
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		VectorRegister4Float V = VectorLoad(MapData + Index);
+		if (MaskData)
+		{
+			V = VectorSelect(VectorCompareGT(VectorLoad(MaskData + Index), Zero), V, MinusBig);
+		}
+		VMaxAcc = VectorMax(VMaxAcc, V);
+	}
+
+	float Maxs[4];
+	VectorStore(VMaxAcc, Maxs);
+	float MaxValue = FMath::Max(FMath::Max(Maxs[0], Maxs[1]), FMath::Max(Maxs[2], Maxs[3]));
+
+	for (; Index < Count; Index++)
+	{
+		if (!MaskData || MaskData[Index] > 0.0f)
+		{
+			MaxValue = FMath::Max(MaxValue, MapData[Index]);
+		}
+	}
+
+	// Second pass: first index that hits it. This usually exits early
+	for (Index = 0; Index < Count; Index++)
+	{
+		if ((MapData[Index] == MaxValue) && (!MaskData || MaskData[Index] > 0.0f))
+		{
+			MaxValueOut = MaxValue;
+			ArgMaxOut = IndexToCellRef(Map, Index);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int32 FGAGridMapOps::ArgMax(const float* Data, int32 Count, float& MaxValueOut)
+{
+	// Same two passes as MaskedMax, without the mask. The new values go first so a NaN doesn't stick
+	VectorRegister4Float VMaxAcc = VectorSetFloat1(-INFINITY);
+
+	int32 Index = 0;
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		VMaxAcc = VectorMax(VectorLoad(Data + Index), VMaxAcc);
+	}
+
+	float Maxs[4];
+	VectorStore(VMaxAcc, Maxs);
+	float MaxValue = FMath::Max(FMath::Max(Maxs[0], Maxs[1]), FMath::Max(Maxs[2], Maxs[3]));
+
+	for (; Index < Count; Index++)
+	{
+		MaxValue = FMath::Max(Data[Index], MaxValue);
+	}
+
+	for (Index = 0; Index < Count; Index++)
+	{
+		if (Data[Index] == MaxValue)
+		{
+			MaxValueOut = MaxValue;
+			return Index;
+		}
+	}
+
+	return INDEX_NONE;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GAGridActor.h"
+#include "GAGridMapOps.generated.h"
+
+
+// A piecewise-linear response curve, used to turn raw spatial function values (distances, LOS, etc.) into scores.
+// Points must be sorted by X. Inputs outside the curve's range are clamped to the first/last point.
+USTRUCT(BlueprintType)
+struct FGAResponseCurve
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TArray<FVector2D> Points;
+
+	float Evaluate(float X) const;
+};
+
+
+// Bulk operations over whole FGAGridMaps.
+// All of these run over the map's Data array with VectorRegister math (SSE/AVX/NEON, whatever the platform has),
+// four cells at a time, rather than going through GetValue/SetValue per cell.
+// Maps combined element-wise must cover the same GridBounds. Out may alias either input.
+struct FGAGridMapOps
+{
+	// Out = A + B
+	static bool Add(FGAGridMap& Out, const FGAGridMap& A, const FGAGridMap& B);
+
+	// Out = A + B * Weight. Handy for accumulating weighted score layers
+	static bool AddScaled(FGAGridMap& Out, const FGAGridMap& A, const FGAGridMap& B, float Weight);
+
+	// Out = A * B
+	static bool Multiply(FGAGridMap& Out, const FGAGridMap& A, const FGAGridMap& B);
+
+	// Out = A + (B - A) * Alpha
+	static bool Lerp(FGAGridMap& Out, const FGAGridMap& A, const FGAGridMap& B, float Alpha);
+
+	// Clamp every value in place
+	static void Clamp(FGAGridMap& Map, float MinValue, float MaxValue);
+
+	// Remap values in place to [0, 1]. Values >= IgnoreValue (e.g. unreachable cells in a distance map) are left alone
+	static void Normalize(FGAGridMap& Map, float IgnoreValue = BIG_NUMBER);
+
+	// Run every value in place through the response curve
+	static void ApplyResponseCurve(FGAGridMap& Map, const FGAResponseCurve& Curve);
+
+	// Finds the max value, and the cell it's in, among the cells where Mask > 0 (or all cells, if Mask is null).
+	// Ties go to the lowest index so results are deterministic. Returns false if no cell passed the mask
+	static bool MaskedMax(const FGAGridMap& Map, const FGAGridMap* Mask, float& MaxValueOut, FCellRef& ArgMaxOut);
+
+	// The same ops over Count floats, for callers working through part of a map a row at a time. The map versions
+	// above are these run over the whole Data array, so the two always agree
+	static void AddScaled(float* Out, const float* A, const float* B, float Weight, int32 Count);
+	static void ApplyResponseCurve(float* Data, int32 Count, const FGAResponseCurve& Curve);
+
+	// Index of the max of Count floats, the lowest index on ties. INDEX_NONE if there's nothing to compare
+	// (Count is 0, or every value is NaN)
+	static int32 ArgMax(const float* Data, int32 Count, float& MaxValueOut);
+
+	// Helpers for treating a map as rows of floats
+	static int32 GetRowWidth(const FGAGridMap& Map) { return Map.GridBounds.MaxX - Map.GridBounds.MinX + 1; }
+	static FCellRef IndexToCellRef(const FGAGridMap& Map, int32 Index);
+	static FORCEINLINE int32 CellRefToIndex(const FGAGridMap& Map, const FCellRef& CellRef)
+	{
+		return (CellRef.Y - Map.GridBounds.MinY) * GetRowWidth(Map) + (CellRef.X - Map.GridBounds.MinX);
+	}
+	static bool IsInBounds(const FGAGridMap& Map, const FCellRef& CellRef)
+	{
+		return (CellRef.X >= Map.GridBounds.MinX) && (CellRef.X <= Map.GridBounds.MaxX)
+			&& (CellRef.Y >= Map.GridBounds.MinY) && (CellRef.Y <= Map.GridBounds.MaxY);
+	}
+	static bool HaveSameBounds(const FGAGridMap& A, const FGAGridMap& B);
+};
@@ -0,0 +1,93 @@
+#include "GAGridMapPool.h"
+
+
+void FGAPooledGridMap::Release()
+{
+	if (Map)
+	{
+		FGAGridMapPool::Get().Release(Map);
+		Map = nullptr;
+	}
+}
+
+
+FGAGridMapPool& FGAGridMapPool::Get()
+{
+	static FGAGridMapPool Pool;
+	return Pool;
+}
+
+FGAGridMapPool::~FGAGridMapPool()
+{
+	for (FGAGridMap* Map : FreeMaps)
+	{
+		delete Map;
+	}
+}
+
+FGAPooledGridMap FGAGridMapPool::Acquire(const FGridBox& Box, float InitialValue)
+{
+	int32 CellCount = (Box.MaxX - Box.MinX + 1) * (Box.MaxY - Box.MinY + 1);
+	FGAGridMap* Map = nullptr;
+
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		// Prefer a map that's already big enough, so we don't reallocate
+		int32 BestIndex = INDEX_NONE;
+		for (int32 Index = FreeMaps.Num() - 1; Index >= 0; Index--)
+		{
+			if (FreeMaps[Index]->Data.Max() >= CellCount)
+			{
+				BestIndex = Index;
+				break;
+			}
+		}
+
+		if (BestIndex == INDEX_NONE && FreeMaps.Num() > 0)
+		{
+			BestIndex = FreeMaps.Num() - 1;
+		}
+
+		if (BestIndex != INDEX_NONE)
+		{
+			Map = FreeMaps[BestIndex];
+			FreeMaps.RemoveAtSwap(BestIndex, 1, EAllowShrinking::No);
+		}
+	}
+
+	if (!Map)
+	{
+		Map = new FGAGridMap();
+	}
+
+	// Re-point the map at the new box, keeping its allocation
+	Map->GridBounds = Box;
+	Map->Data.SetNumUninitialized(CellCount, EAllowShrinking::No);
+	for (float& Value : Map->Data)
+	{
+		Value = InitialValue;
+	}
+
+	return FGAPooledGridMap(Map);
+}
+
+void FGAGridMapPool::Release(FGAGridMap* Map)
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (FreeMaps.Num() < MaxFreeMaps)
+		{
+			FreeMaps.Add(Map);
+			return;
+		}
+	}
+
+	delete Map;
+}
+
+int32 FGAGridMapPool::GetFreeCount() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return FreeMaps.Num();
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GAGridActor.h"
+
+class FGAGridMapPool;
+
+
+// Move-only handle to a map borrowed from FGAGridMapPool. Gives the map back when it goes out of scope.
+class FGAPooledGridMap
+{
+public:
+	FGAPooledGridMap() : Map(nullptr) {}
+	explicit FGAPooledGridMap(FGAGridMap* InMap) : Map(InMap) {}
+	~FGAPooledGridMap() { Release(); }
+
+	FGAPooledGridMap(FGAPooledGridMap&& Other) : Map(Other.Map) { Other.Map = nullptr; }
+	FGAPooledGridMap& operator=(FGAPooledGridMap&& Other)
+	{
+		if (this != &Other)
+		{
+			Release();
+			Map = Other.Map;
+			Other.Map = nullptr;
+		}
+		return *this;
+	}
+
+	FGAPooledGridMap(const FGAPooledGridMap&) = delete;
+	FGAPooledGridMap& operator=(const FGAPooledGridMap&) = delete;
+
+	bool IsSet() const { return Map != nullptr; }
+	FGAGridMap* Get() const { return Map; }
+	FGAGridMap& operator*() const { check(Map); return *Map; }
+	FGAGridMap* operator->() const { check(Map); return Map; }
+
+	void Release();
+
+private:
+	FGAGridMap* Map;
+};
+
+
+// Recycles FGAGridMaps (and, more importantly, their Data allocations) between queries, so that searches which
+// run every frame don't allocate a fresh map each time. Thread-safe.
+class FGAGridMapPool
+{
+public:
+	static FGAGridMapPool& Get();
+	~FGAGridMapPool();
+
+	// Returns a map covering Box with every cell set to InitialValue
+	FGAPooledGridMap Acquire(const FGridBox& Box, float InitialValue);
+
+	// Maps beyond this many are freed instead of kept
+	void SetMaxFreeMaps(int32 InMaxFreeMaps) { MaxFreeMaps = InMaxFreeMaps; }
+
+	int32 GetFreeCount() const;
+
+private:
+	friend class FGAPooledGridMap;
+	void Release(FGAGridMap* Map);
+
+	mutable FCriticalSection Lock;
+	TArray<FGAGridMap*> FreeMaps;
+	int32 MaxFreeMaps = 32;
+};
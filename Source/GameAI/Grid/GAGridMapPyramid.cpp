@@ -0,0 +1,356 @@
+#include "GAGridMapPyramid.h"
+
+
+// Ignored cells show up as these, so they lose every comparison
+static constexpr float MissingMax = -MAX_flt;
+static constexpr float MissingMin = MAX_flt;
+
+
+void FGAGridMapPyramid::Reset()
+{
+	Map = nullptr;
+	MapWidth = MapHeight = 0;
+	Levels.Reset();
+}
+
+void FGAGridMapPyramid::Build(FGAGridMap& InMap, float InIgnoreValue, uint32 InDataVersion)
+{
+	Reset();
+
+	Map = &InMap;
+	IgnoreValue = InIgnoreValue;
+	DataVersion = InDataVersion;
+	MapWidth = InMap.GridBounds.MaxX - InMap.GridBounds.MinX + 1;
+	MapHeight = InMap.GridBounds.MaxY - InMap.GridBounds.MinY + 1;
+
+	if (MapWidth <= 0 || MapHeight <= 0 || InMap.Data.Num() != MapWidth * MapHeight)
+	{
+		Reset();
+		return;
+	}
+
+	// Level 0 is the map itself
+	Levels.AddDefaulted();
+	Levels[0].Width = MapWidth;
+	Levels[0].Height = MapHeight;
+
+	while (Levels.Last().Width > 1 || Levels.Last().Height > 1)
+	{
+		int32 Below = Levels.Num() - 1;
+		FLevel& Level = Levels.AddDefaulted_GetRef();
+		Level.Width = FMath::DivideAndRoundUp(Levels[Below].Width, 2);
+		Level.Height = FMath::DivideAndRoundUp(Levels[Below].Height, 2);
+		Level.Max.SetNumUninitialized(Level.Width * Level.Height);
+		Level.Min.SetNumUninitialized(Level.Width * Level.Height);
+
+		for (int32 Y = 0; Y < Level.Height; Y++)
+		{
+			for (int32 X = 0; X < Level.Width; X++)
+			{
+				RefreshParent(Below, X * 2, Y * 2);
+			}
+		}
+	}
+}
+
+bool FGAGridMapPyramid::IsBuiltFor(const FGAGridMap& InMap, uint32 InDataVersion) const
+{
+	return (Map == &InMap) && (Levels.Num() > 0) && (DataVersion == InDataVersion)
+		&& (MapWidth == InMap.GridBounds.MaxX - InMap.GridBounds.MinX + 1)
+		&& (MapHeight == InMap.GridBounds.MaxY - InMap.GridBounds.MinY + 1)
+		&& (InMap.Data.Num() == MapWidth * MapHeight);
+}
+
+int32 FGAGridMapPyramid::GetWidth(int32 Level) const
+{
+	return Levels[Level].Width;
+}
+
+int32 FGAGridMapPyramid::GetHeight(int32 Level) const
+{
+	return Levels[Level].Height;
+}
+
+float FGAGridMapPyramid::GetMaxAt(int32 Level, int32 X, int32 Y) const
+{
+	if (Level == 0)
+	{
+		float Value = Map->Data[Y * MapWidth + X];
+		return (Value >= IgnoreValue) ? MissingMax : Value;
+	}
+	return Levels[Level].Max[Y * Levels[Level].Width + X];
+}
+
+float FGAGridMapPyramid::GetMinAt(int32 Level, int32 X, int32 Y) const
+{
+	if (Level == 0)
+	{
+		float Value = Map->Data[Y * MapWidth + X];
+		return (Value >= IgnoreValue) ? MissingMin : Value;
+	}
+	return Levels[Level].Min[Y * Levels[Level].Width + X];
+}
+
+void FGAGridMapPyramid::RefreshParent(int32 Level, int32 X, int32 Y)
+{
+	// Recompute the block of Level + 1 that contains (X, Y) of Level
+	int32 ParentX = X / 2;
+	int32 ParentY = Y / 2;
+	float MaxValue = MissingMax;
+	float MinValue = MissingMin;
+
+	for (int32 ChildY = ParentY * 2; ChildY < FMath::Min(ParentY * 2 + 2, GetHeight(Level)); ChildY++)
+	{
+		for (int32 ChildX = ParentX * 2; ChildX < FMath::Min(ParentX * 2 + 2, GetWidth(Level)); ChildX++)
+		{
+			MaxValue = FMath::Max(MaxValue, GetMaxAt(Level, ChildX, ChildY));
+			MinValue = FMath::Min(MinValue, GetMinAt(Level, ChildX, ChildY));
+		}
+	}
+
+	FLevel& Parent = Levels[Level + 1];
+	Parent.Max[ParentY * Parent.Width + ParentX] = MaxValue;
+	Parent.Min[ParentY * Parent.Width + ParentX] = MinValue;
+}
+
+bool FGAGridMapPyramid::SetValue(const FCellRef& CellRef, float Value)
+{
+	if (!Map || !Map->SetValue(CellRef, Value))
+	{
+		return false;
+	}
+
+	// Walk up, stopping early once a block comes out the same as before
+	int32 X = CellRef.X - Map->GridBounds.MinX;
+	int32 Y = CellRef.Y - Map->GridBounds.MinY;
+	for (int32 Level = 0; Level < Levels.Num() - 1; Level++)
+	{
+		FLevel& Parent = Levels[Level + 1];
+		int32 ParentIndex = (Y / 2) * Parent.Width + (X / 2);
+		float OldMax = Parent.Max[ParentIndex];
+		float OldMin = Parent.Min[ParentIndex];
+
+		RefreshParent(Level, X, Y);
+
+		if (Parent.Max[ParentIndex] == OldMax && Parent.Min[ParentIndex] == OldMin)
+		{
+			break;
+		}
+
+		X /= 2;
+		Y /= 2;
+	}
+
+	return true;
+}
+
+bool FGAGridMapPyramid::GetMaxValue(float& MaxValueOut) const
+{
+	if (Levels.Num() == 0)
+	{
+		return false;
+	}
+
+	MaxValueOut = GetMaxAt(Levels.Num() - 1, 0, 0);
+	return MaxValueOut != MissingMax;
+}
+
+bool FGAGridMapPyramid::GetMax(float& MaxValueOut, FCellRef& CellOut) const
+{
+	if (!GetMaxValue(MaxValueOut))
+	{
+		return false;
+	}
+
+	// Follow the first child that holds the max down to the cell
+	int32 X = 0;
+	int32 Y = 0;
+	for (int32 Level = Levels.Num() - 1; Level > 0; Level--)
+	{
+		bool bFound = false;
+		for (int32 ChildY = Y * 2; ChildY < FMath::Min(Y * 2 + 2, GetHeight(Level - 1)) && !bFound; ChildY++)
+		{
+			for (int32 ChildX = X * 2; ChildX < FMath::Min(X * 2 + 2, GetWidth(Level - 1)) && !bFound; ChildX++)
+			{
+				if (GetMaxAt(Level - 1, ChildX, ChildY) == MaxValueOut)
+				{
+					X = ChildX;
+					Y = ChildY;
+					bFound = true;
+				}
+			}
+		}
+		check(bFound);
+	}
+
+	CellOut = FCellRef(Map->GridBounds.MinX + X, Map->GridBounds.MinY + Y);
+	return true;
+}
+
+bool FGAGridMapPyramid::GetMin(float& MinValueOut, FCellRef& CellOut) const
+{
+	if (Levels.Num() == 0)
+	{
+		return false;
+	}
+
+	MinValueOut = GetMinAt(Levels.Num() - 1, 0, 0);
+	if (MinValueOut == MissingMin)
+	{
+		return false;
+	}
+
+	int32 X = 0;
+	int32 Y = 0;
+	for (int32 Level = Levels.Num() - 1; Level > 0; Level--)
+	{
+		bool bFound = false;
+		for (int32 ChildY = Y * 2; ChildY < FMath::Min(Y * 2 + 2, GetHeight(Level - 1)) && !bFound; ChildY++)
+		{
+			for (int32 ChildX = X * 2; ChildX < FMath::Min(X * 2 + 2, GetWidth(Level - 1)) && !bFound; ChildX++)
+			{
+				if (GetMinAt(Level - 1, ChildX, ChildY) == MinValueOut)
+				{
+					X = ChildX;
+					Y = ChildY;
+					bFound = true;
+				}
+			}
+		}
+		check(bFound);
+	}
+
+	CellOut = FCellRef(Map->GridBounds.MinX + X, Map->GridBounds.MinY + Y);
+	return true;
+}
+
+template <typename OverlapFunctionType>
+void FGAGridMapPyramid::Search(int32 K, OverlapFunctionType Overlap, TArray<TPair<FCellRef, float>>& CellsOut) const
+{
+	CellsOut.Reset();
+	if (Levels.Num() == 0 || K <= 0)
+	{
+		return;
+	}
+
+	// Best-first: a block's max is an upper bound on everything in it, so the first cells to come off the
+	// heap are the best ones
+	TArray<FNode, TInlineAllocator<64>> Heap;
+	auto Push = [this, &Heap, &Overlap](int32 Level, int32 X, int32 Y)
+	{
+		float Value = GetMaxAt(Level, X, Y);
+		if (Value != MissingMax && Overlap(Level, X, Y) != 0)
+		{
+			Heap.HeapPush({ Value, Level, X, Y });
+		}
+	};
+
+	Push(Levels.Num() - 1, 0, 0);
+
+	while (Heap.Num() > 0 && CellsOut.Num() < K)
+	{
+		FNode Node;
+		Heap.HeapPop(Node, EAllowShrinking::No);
+
+		if (Node.Level == 0)
+		{
+			CellsOut.Emplace(FCellRef(Map->GridBounds.MinX + Node.X, Map->GridBounds.MinY + Node.Y), Node.Value);
+			continue;
+		}
+
+		for (int32 ChildY = Node.Y * 2; ChildY < FMath::Min(Node.Y * 2 + 2, GetHeight(Node.Level - 1)); ChildY++)
+		{
+			for (int32 ChildX = Node.X * 2; ChildX < FMath::Min(Node.X * 2 + 2, GetWidth(Node.Level - 1)); ChildX++)
+			{
+				Push(Node.Level - 1, ChildX, ChildY);
+			}
+		}
+	}
+}
+
+void FGAGridMapPyramid::GetTopK(int32 K, TArray<TPair<FCellRef, float>>& CellsOut) const
+{
+	Search(K, [](int32 Level, int32 X, int32 Y) { return 2; }, CellsOut);
+}
+
+bool FGAGridMapPyramid::GetMaxInRect(const FIntRect& Rect, float& MaxValueOut, FCellRef& CellOut) const
+{
+	if (!Map)
+	{
+		return false;
+	}
+
+	// Into map space
+	FIntRect LocalRect(
+		Rect.Min.X - Map->GridBounds.MinX, Rect.Min.Y - Map->GridBounds.MinY,
+		Rect.Max.X - Map->GridBounds.MinX, Rect.Max.Y - Map->GridBounds.MinY);
+
+	auto Overlap = [this, &LocalRect](int32 Level, int32 X, int32 Y)
+	{
+		int32 MinX = X << Level;
+		int32 MinY = Y << Level;
+		int32 MaxX = FMath::Min(((X + 1) << Level) - 1, MapWidth - 1);
+		int32 MaxY = FMath::Min(((Y + 1) << Level) - 1, MapHeight - 1);
+
+		if (MaxX < LocalRect.Min.X || MinX > LocalRect.Max.X || MaxY < LocalRect.Min.Y || MinY > LocalRect.Max.Y)
+		{
+			return 0;
+		}
+		bool bInside = MinX >= LocalRect.Min.X && MaxX <= LocalRect.Max.X && MinY >= LocalRect.Min.Y && MaxY <= LocalRect.Max.Y;
+		return bInside ? 2 : 1;
+	};
+
+	TArray<TPair<FCellRef, float>> Result;
+	Search(1, Overlap, Result);
+	if (Result.Num() == 0)
+	{
+		return false;
+	}
+
+	CellOut = Result[0].Key;
+	MaxValueOut = Result[0].Value;
+	return true;
+}
+
+bool FGAGridMapPyramid::GetMaxInRadius(const FCellRef& Center, float Radius, float& MaxValueOut, FCellRef& CellOut) const
+{
+	if (!Map)
+	{
+		return false;
+	}
+
+	int32 CenterX = Center.X - Map->GridBounds.MinX;
+	int32 CenterY = Center.Y - Map->GridBounds.MinY;
+	float RadiusSquared = Radius * Radius;
+
+	auto Overlap = [this, CenterX, CenterY, RadiusSquared](int32 Level, int32 X, int32 Y)
+	{
+		int32 MinX = X << Level;
+		int32 MinY = Y << Level;
+		int32 MaxX = FMath::Min(((X + 1) << Level) - 1, MapWidth - 1);
+		int32 MaxY = FMath::Min(((Y + 1) << Level) - 1, MapHeight - 1);
+
+		// Nearest and farthest cell of the block from the center
+		int32 NearDX = FMath::Max3(MinX - CenterX, 0, CenterX - MaxX);
+		int32 NearDY = FMath::Max3(MinY - CenterY, 0, CenterY - MaxY);
+		if (float(NearDX * NearDX + NearDY * NearDY) > RadiusSquared)
+		{
+			return 0;
+		}
+
+		int32 FarDX = FMath::Max(FMath::Abs(MinX - CenterX), FMath::Abs(MaxX - CenterX));
+		int32 FarDY = FMath::Max(FMath::Abs(MinY - CenterY), FMath::Abs(MaxY - CenterY));
+		return (float(FarDX * FarDX + FarDY * FarDY) <= RadiusSquared) ? 2 : 1;
+	};
+
+	TArray<TPair<FCellRef, float>> Result;
+	Search(1, Overlap, Result);
+	if (Result.Num() == 0)
+	{
+		return false;
+	}
+
+	CellOut = Result[0].Key;
+	MaxValueOut = Result[0].Value;
+	return true;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GAGridActor.h"
+
+
+// A max/min mip pyramid over an FGAGridMap.
+//
+// Level 0 is the map itself. Each level above stores, for every 2x2 block of the level below, the max and min
+// of that block, up to a single root cell. Writes made through SetValue update the map and then walk up the
+// pyramid, which is O(log n), and in exchange:
+//  - the global max/min is O(1) (plus O(log n) to find which cell it's in)
+//  - top-K, and best-in-rectangle/radius queries, are best-first searches down the pyramid that only open
+//    blocks which could still beat what's been found
+// so several agents can pick from the same scored map without each scanning it.
+//
+// Values >= IgnoreValue (e.g. the BIG_NUMBER/INFINITY of unreachable cells) are treated as missing, the same
+// way FGAGridMap::GetMaxValue treats them.
+//
+// The pyramid keeps a pointer to the map it was built for. Writes that bypass SetValue need a Build() after.
+// The owner can pass a version of the map's contents to Build and IsBuiltFor, bumped whenever it writes the map
+// some other way, so the pyramid is rebuilt after those writes rather than only after a resize.
+class FGAGridMapPyramid
+{
+public:
+	FGAGridMapPyramid() : Map(nullptr), IgnoreValue(BIG_NUMBER) {}
+
+	void Build(FGAGridMap& InMap, float InIgnoreValue = BIG_NUMBER, uint32 InDataVersion = 0);
+	void Reset();
+
+	// Is this pyramid up to date for (the current size and contents version of) this map?
+	bool IsBuiltFor(const FGAGridMap& InMap, uint32 InDataVersion = 0) const;
+
+	// Writes the map and updates the pyramid
+	bool SetValue(const FCellRef& CellRef, float Value);
+
+	// Returns false if every cell is ignored
+	bool GetMax(float& MaxValueOut, FCellRef& CellOut) const;
+	bool GetMin(float& MinValueOut, FCellRef& CellOut) const;
+	bool GetMaxValue(float& MaxValueOut) const;
+
+	// The K highest cells, best first
+	void GetTopK(int32 K, TArray<TPair<FCellRef, float>>& CellsOut) const;
+
+	// Best cell inside the rectangle (inclusive cell indices, in grid space like the map)
+	bool GetMaxInRect(const FIntRect& Rect, float& MaxValueOut, FCellRef& CellOut) const;
+
+	// Best cell whose center is within Radius cells of Center
+	bool GetMaxInRadius(const FCellRef& Center, float Radius, float& MaxValueOut, FCellRef& CellOut) const;
+
+private:
+	struct FLevel
+	{
+		int32 Width = 0;
+		int32 Height = 0;
+		TArray<float> Max;
+		TArray<float> Min;
+	};
+
+	// A block of the pyramid waiting to be opened during a search
+	struct FNode
+	{
+		float Value;
+		int32 Level;
+		int32 X;
+		int32 Y;
+
+		// Highest value first, then lowest level (cells before blocks), then position for determinism
+		bool operator<(const FNode& Other) const
+		{
+			if (Value != Other.Value) return Value > Other.Value;
+			if (Level != Other.Level) return Level < Other.Level;
+			if (Y != Other.Y) return Y < Other.Y;
+			return X < Other.X;
+		}
+	};
+
+	// Level 0 reads straight from the map
+	float GetMaxAt(int32 Level, int32 X, int32 Y) const;
+	float GetMinAt(int32 Level, int32 X, int32 Y) const;
+	int32 GetWidth(int32 Level) const;
+	int32 GetHeight(int32 Level) const;
+	void RefreshParent(int32 Level, int32 X, int32 Y);
+
+	// Generic best-first search. Overlap(Level, X, Y) returns 0 for no overlap, 1 for partial, 2 for full
+	template <typename OverlapFunctionType>
+	void Search(int32 K, OverlapFunctionType Overlap, TArray<TPair<FCellRef, float>>& CellsOut) const;
+
+	FGAGridMap* Map;
+	float IgnoreValue;
+	uint32 DataVersion = 0;
+	int32 MapWidth = 0;
+	int32 MapHeight = 0;
+
+	// Levels[0] is unused (it's the map). Levels.Last() is 1x1
+	TArray<FLevel> Levels;
+};
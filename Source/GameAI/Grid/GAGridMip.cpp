@@ -0,0 +1,263 @@
+#include "GAGridMip.h"
+
+#include "GAGridActor.h"
+#include "GAGridMap.h"
+
+
+void FGAGridMipChain::Build(const AGAGridActor* Grid, int32 LevelCount)
+{
+	Levels.Reset();
+	if (!Grid || Grid->XCount <= 0 || Grid->YCount <= 0)
+	{
+		return;
+	}
+
+	for (int32 LevelIndex = 0; LevelIndex < LevelCount; LevelIndex++)
+	{
+		FGAGridMipLevel& Level = Levels.AddDefaulted_GetRef();
+		Level.Factor = 2 << LevelIndex;
+		Level.Width = FMath::DivideAndRoundUp(Grid->XCount, Level.Factor);
+		Level.Height = FMath::DivideAndRoundUp(Grid->YCount, Level.Factor);
+
+		int32 BlockCount = Level.Width * Level.Height;
+		Level.TraversableFraction.SetNumUninitialized(BlockCount);
+		Level.MinHeight.SetNumUninitialized(BlockCount);
+		Level.MaxHeight.SetNumUninitialized(BlockCount);
+		Level.RepresentativeCell.SetNumUninitialized(BlockCount);
+	}
+
+	Update(Grid, FIntRect(0, 0, Grid->XCount - 1, Grid->YCount - 1));
+}
+
+void FGAGridMipChain::Update(const AGAGridActor* Grid, const FIntRect& Rect)
+{
+	if (!Grid || Levels.Num() == 0)
+	{
+		return;
+	}
+
+	// Resized grid -- start over
+	if (Levels[0].Width != FMath::DivideAndRoundUp(Grid->XCount, Levels[0].Factor)
+		|| Levels[0].Height != FMath::DivideAndRoundUp(Grid->YCount, Levels[0].Factor))
+	{
+		Build(Grid, Levels.Num());
+		return;
+	}
+
+	for (FGAGridMipLevel& Level : Levels)
+	{
+		int32 MinBlockX = FMath::Max(Rect.Min.X, 0) / Level.Factor;
+		int32 MinBlockY = FMath::Max(Rect.Min.Y, 0) / Level.Factor;
+		int32 MaxBlockX = FMath::Min(Rect.Max.X / Level.Factor, Level.Width - 1);
+		int32 MaxBlockY = FMath::Min(Rect.Max.Y / Level.Factor, Level.Height - 1);
+
+		for (int32 BlockY = MinBlockY; BlockY <= MaxBlockY; BlockY++)
+		{
+			for (int32 BlockX = MinBlockX; BlockX <= MaxBlockX; BlockX++)
+			{
+				UpdateBlock(Grid, Level, BlockX, BlockY);
+			}
+		}
+	}
+}
+
+void FGAGridMipChain::UpdateBlock(const AGAGridActor* Grid, FGAGridMipLevel& Level, int32 BlockX, int32 BlockY)
+{
+	int32 MinX = BlockX * Level.Factor;
+	int32 MinY = BlockY * Level.Factor;
+	int32 MaxX = FMath::Min(MinX + Level.Factor, Grid->XCount) - 1;
+	int32 MaxY = FMath::Min(MinY + Level.Factor, Grid->YCount) - 1;
+
+	// Twice the block center, so the distance test stays in integers
+	int32 CenterX2 = MinX + MaxX;
+	int32 CenterY2 = MinY + MaxY;
+
+	int32 TraversableCount = 0;
+	float MinHeight = MAX_flt;
+	float MaxHeight = -MAX_flt;
+	int32 Representative = INDEX_NONE;
+	int32 RepresentativeDistance = MAX_int32;
+
+	for (int32 Y = MinY; Y <= MaxY; Y++)
+	{
+		for (int32 X = MinX; X <= MaxX; X++)
+		{
+			FCellRef CellRef(X, Y);
+			if (!Grid->IsCellTraversable(CellRef))
+			{
+				continue;
+			}
+
+			TraversableCount++;
+			float CellHeight = Grid->GetCellHeightData(CellRef);
+			MinHeight = FMath::Min(MinHeight, CellHeight);
+			MaxHeight = FMath::Max(MaxHeight, CellHeight);
+
+			int32 DX = 2 * X - CenterX2;
+			int32 DY = 2 * Y - CenterY2;
+			int32 Distance = DX * DX + DY * DY;
+			if (Distance < RepresentativeDistance)
+			{
+				RepresentativeDistance = Distance;
+				Representative = Grid->CellRefToIndex(CellRef);
+			}
+		}
+	}
+
+	int32 BlockIndex = BlockY * Level.Width + BlockX;
+	int32 CellCount = (MaxX - MinX + 1) * (MaxY - MinY + 1);
+	Level.TraversableFraction[BlockIndex] = float(TraversableCount) / float(CellCount);
+	Level.MinHeight[BlockIndex] = (TraversableCount > 0) ? MinHeight : 0.0f;
+	Level.MaxHeight[BlockIndex] = (TraversableCount > 0) ? MaxHeight : 0.0f;
+	Level.RepresentativeCell[BlockIndex] = Representative;
+}
+
+FGAGridMipLevel FGAGridMipLevel::CopyBlocks(const FGridBox& Box) const
+{
+	FGAGridMipLevel Copy;
+	Copy.Factor = Factor;
+
+	int32 MinBlockX = FMath::Max(FMath::Max(Box.MinX, 0) / Factor, OriginX);
+	int32 MinBlockY = FMath::Max(FMath::Max(Box.MinY, 0) / Factor, OriginY);
+	int32 MaxBlockX = FMath::Min(Box.MaxX / Factor, OriginX + Width - 1);
+	int32 MaxBlockY = FMath::Min(Box.MaxY / Factor, OriginY + Height - 1);
+	if (MaxBlockX < MinBlockX || MaxBlockY < MinBlockY)
+	{
+		return Copy;
+	}
+
+	Copy.Width = MaxBlockX - MinBlockX + 1;
+	Copy.Height = MaxBlockY - MinBlockY + 1;
+	Copy.OriginX = MinBlockX;
+	Copy.OriginY = MinBlockY;
+
+	const int32 BlockCount = Copy.Width * Copy.Height;
+	Copy.TraversableFraction.SetNumUninitialized(BlockCount);
+	Copy.MinHeight.SetNumUninitialized(BlockCount);
+	Copy.MaxHeight.SetNumUninitialized(BlockCount);
+	Copy.RepresentativeCell.SetNumUninitialized(BlockCount);
+
+	for (int32 Row = 0; Row < Copy.Height; Row++)
+	{
+		int32 From = (MinBlockY - OriginY + Row) * Width + (MinBlockX - OriginX);
+		int32 To = Row * Copy.Width;
+		FMemory::Memcpy(&Copy.TraversableFraction[To], &TraversableFraction[From], Copy.Width * sizeof(float));
+		FMemory::Memcpy(&Copy.MinHeight[To], &MinHeight[From], Copy.Width * sizeof(float));
+		FMemory::Memcpy(&Copy.MaxHeight[To], &MaxHeight[From], Copy.Width * sizeof(float));
+		FMemory::Memcpy(&Copy.RepresentativeCell[To], &RepresentativeCell[From], Copy.Width * sizeof(int32));
+	}
+
+	return Copy;
+}
+
+bool FGAGridMipChain::FindBestCell(const AGAGridActor* Grid, const FGridBox& Box, int32 LevelIndex, int32 RefineBudget,
+	TFunctionRef<float(const FCellRef&)> ScoreFunction, FCellRef& BestCellOut, int32* ScoreEvaluationsOut,
+	float MinTraversableFraction) const
+{
+	if (!Grid || !Levels.IsValidIndex(LevelIndex))
+	{
+		return false;
+	}
+
+	return FindBestCellInLevel(Levels[LevelIndex], Grid->XCount, Box, RefineBudget,
+		[Grid](const FCellRef& CellRef) { return Grid->IsCellTraversable(CellRef); },
+		ScoreFunction, BestCellOut, ScoreEvaluationsOut, MinTraversableFraction);
+}
+
+bool FGAGridMipChain::FindBestCellInLevel(const FGAGridMipLevel& Level, int32 GridWidth, const FGridBox& Box, int32 RefineBudget,
+	TFunctionRef<bool(const FCellRef&)> IsTraversable, TFunctionRef<float(const FCellRef&)> ScoreFunction,
+	FCellRef& BestCellOut, int32* ScoreEvaluationsOut, float MinTraversableFraction)
+{
+	if (GridWidth <= 0 || Level.Width <= 0 || Level.Height <= 0)
+	{
+		return false;
+	}
+
+	int32 Evaluations = 0;
+
+	// Coarse pass: one score per block, at its representative cell
+	struct FBlockScore
+	{
+		float Score;
+		int32 BlockIndex;
+
+		// Best first, ties to the lower index
+		bool operator<(const FBlockScore& Other) const
+		{
+			return (Score > Other.Score) || (Score == Other.Score && BlockIndex < Other.BlockIndex);
+		}
+	};
+	TArray<FBlockScore> BlockScores;
+
+	int32 MinBlockX = FMath::Max(FMath::Max(Box.MinX, 0) / Level.Factor, Level.OriginX);
+	int32 MinBlockY = FMath::Max(FMath::Max(Box.MinY, 0) / Level.Factor, Level.OriginY);
+	int32 MaxBlockX = FMath::Min(Box.MaxX / Level.Factor, Level.OriginX + Level.Width - 1);
+	int32 MaxBlockY = FMath::Min(Box.MaxY / Level.Factor, Level.OriginY + Level.Height - 1);
+
+	for (int32 BlockY = MinBlockY; BlockY <= MaxBlockY; BlockY++)
+	{
+		for (int32 BlockX = MinBlockX; BlockX <= MaxBlockX; BlockX++)
+		{
+			int32 BlockIndex = (BlockY - Level.OriginY) * Level.Width + (BlockX - Level.OriginX);
+			int32 Representative = Level.RepresentativeCell[BlockIndex];
+			if (Representative == INDEX_NONE || Level.TraversableFraction[BlockIndex] < MinTraversableFraction)
+			{
+				continue;
+			}
+
+			// Note: for blocks straddling the edge of Box, the representative may be just outside it.
+			// It's only used to rank the block; refinement below sticks to Box
+			FCellRef RepresentativeRef(Representative % GridWidth, Representative / GridWidth);
+			BlockScores.Add({ ScoreFunction(RepresentativeRef), BlockIndex });
+			Evaluations++;
+		}
+	}
+
+	// Fine pass over the most promising blocks
+	int32 RefineCount = FMath::Min(FMath::Max(RefineBudget, 1), BlockScores.Num());
+	BlockScores.Sort();
+
+	float BestScore = -MAX_flt;
+	bool bFound = false;
+
+	for (int32 Rank = 0; Rank < RefineCount; Rank++)
+	{
+		int32 BlockIndex = BlockScores[Rank].BlockIndex;
+		int32 BlockX = Level.OriginX + BlockIndex % Level.Width;
+		int32 BlockY = Level.OriginY + BlockIndex / Level.Width;
+
+		int32 MinX = FMath::Max(BlockX * Level.Factor, Box.MinX);
+		int32 MinY = FMath::Max(BlockY * Level.Factor, Box.MinY);
+		int32 MaxX = FMath::Min((BlockX + 1) * Level.Factor - 1, Box.MaxX);
+		int32 MaxY = FMath::Min((BlockY + 1) * Level.Factor - 1, Box.MaxY);
+
+		for (int32 Y = MinY; Y <= MaxY; Y++)
+		{
+			for (int32 X = MinX; X <= MaxX; X++)
+			{
+				FCellRef CellRef(X, Y);
+				if (!IsTraversable(CellRef))
+				{
+					continue;
+				}
+
+				float Score = ScoreFunction(CellRef);
+				Evaluations++;
+
+				if (!bFound || Score > BestScore)
+				{
+					BestScore = Score;
+					BestCellOut = CellRef;
+					bFound = true;
+				}
+			}
+		}
+	}
+
+	if (ScoreEvaluationsOut)
+	{
+		*ScoreEvaluationsOut = Evaluations;
+	}
+
+	return bFound;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AGAGridActor;
+struct FCellRef;
+struct FGridBox;
+
+
+// One downsampled level of the grid. Each coarse cell covers Factor x Factor grid cells.
+struct FGAGridMipLevel
+{
+	int32 Factor = 1;
+
+	// Blocks stored, and the block coordinates of the first one. The origin is only nonzero for a copy of part
+	// of a level (see CopyBlocks)
+	int32 Width = 0;
+	int32 Height = 0;
+	int32 OriginX = 0;
+	int32 OriginY = 0;
+
+	// Fraction of the block's cells that are traversable (overlay included)
+	TArray<float> TraversableFraction;
+
+	// Height range over the block's traversable cells
+	TArray<float> MinHeight;
+	TArray<float> MaxHeight;
+
+	// Grid index of the traversable cell nearest the block's center, or INDEX_NONE if there are none.
+	// This is the cell a coarse query scores on behalf of the whole block
+	TArray<int32> RepresentativeCell;
+
+	// Just the blocks overlapping Box (inclusive cell indices), for queries that run off the game thread while
+	// the grid keeps changing
+	FGAGridMipLevel CopyBlocks(const FGridBox& Box) const;
+};
+
+
+// Downsampled (mip) levels of a grid's traversability and height data, for coarse-to-fine spatial queries.
+// Level i has a factor of 2^(i+1), i.e. 2x2, 4x4, 8x8 ... blocks. Each level is built straight from the full
+// resolution data, so a change to a rectangle of cells only touches the blocks over it.
+class FGAGridMipChain
+{
+public:
+	void Build(const AGAGridActor* Grid, int32 LevelCount = 3);
+
+	// Refresh the blocks over the rectangle (inclusive cell indices)
+	void Update(const AGAGridActor* Grid, const FIntRect& Rect);
+
+	void Reset() { Levels.Reset(); }
+
+	int32 Num() const { return Levels.Num(); }
+	const FGAGridMipLevel& GetLevel(int32 Level) const { return Levels[Level]; }
+
+	// Coarse-to-fine search for the best cell in Box.
+	// Every block of the given level that overlaps Box is scored once, at its representative cell. Only the
+	// RefineBudget best blocks are then scored cell by cell at full resolution. With ScoreFunction costing S,
+	// that's roughly (Box area / Factor^2 + RefineBudget * Factor^2) * S instead of Box area * S.
+	// Blocks with less than MinTraversableFraction traversable cells are skipped.
+	bool FindBestCell(const AGAGridActor* Grid, const FGridBox& Box, int32 Level, int32 RefineBudget,
+		TFunctionRef<float(const FCellRef&)> ScoreFunction, FCellRef& BestCellOut, int32* ScoreEvaluationsOut = nullptr,
+		float MinTraversableFraction = 0.0f) const;
+
+	// FindBestCell over a single level, or a copy of part of one, with traversability supplied by the caller.
+	// Doesn't touch the grid, so it can score against snapshots on another thread
+	static bool FindBestCellInLevel(const FGAGridMipLevel& Level, int32 GridWidth, const FGridBox& Box, int32 RefineBudget,
+		TFunctionRef<bool(const FCellRef&)> IsTraversable, TFunctionRef<float(const FCellRef&)> ScoreFunction,
+		FCellRef& BestCellOut, int32* ScoreEvaluationsOut = nullptr, float MinTraversableFraction = 0.0f);
+
+private:
+	void UpdateBlock(const AGAGridActor* Grid, FGAGridMipLevel& Level, int32 BlockX, int32 BlockY);
+
+	TArray<FGAGridMipLevel> Levels;
+};
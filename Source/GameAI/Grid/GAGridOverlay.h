@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GAGridOverlay.generated.h"
+
+
+// How a registered actor shows up in the grid overlay
+USTRUCT(BlueprintType)
+struct FGAOverlayFootprint
+{
+	GENERATED_BODY()
+
+	FGAOverlayFootprint() : Radius(50.0f), bBlocking(true), Cost(0.0f) {}
+
+	// Cells whose centers are within this (world-space) distance of the actor are stamped
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Radius;
+
+	// If true, stamped cells are not traversable at all. Otherwise they just get more expensive
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bBlocking;
+
+	// Extra traversal cost added to each stamped cell when not blocking
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Cost;
+};
+
+
+// A dynamic layer that sits on top of the static nav-derived cell data.
+// Rather than flags, each cell keeps a count of the blocking footprints covering it and the sum of the extra
+// costs, so overlapping footprints can be stamped and erased independently and in any order.
+struct FGAGridOverlay
+{
+	void Reset(int32 CellCount)
+	{
+		BlockCount.SetNumZeroed(CellCount);
+		ExtraCost.SetNumZeroed(CellCount);
+		BlockedCellCount = 0;
+	}
+
+	bool IsEmpty() const { return BlockCount.Num() == 0; }
+
+	// Is any cell blocked at all? Lets callers skip overlay checks entirely in the common case
+	bool HasBlockedCells() const { return BlockedCellCount > 0; }
+
+	// Sign is +1 to stamp and -1 to erase
+	void Stamp(const TArray<int32>& CellIndices, const FGAOverlayFootprint& Footprint, int32 Sign)
+	{
+		for (int32 CellIndex : CellIndices)
+		{
+			if (Footprint.bBlocking)
+			{
+				int32 PreviousCount = BlockCount[CellIndex];
+				BlockCount[CellIndex] += Sign;
+				check(BlockCount[CellIndex] >= 0);
+				BlockedCellCount += (PreviousCount == 0 && BlockCount[CellIndex] > 0) ? 1 : 0;
+				BlockedCellCount -= (PreviousCount > 0 && BlockCount[CellIndex] == 0) ? 1 : 0;
+			}
+			else
+			{
+				ExtraCost[CellIndex] += float(Sign) * Footprint.Cost;
+				if (BlockCount[CellIndex] == 0 && FMath::IsNearlyZero(ExtraCost[CellIndex]))
+				{
+					// Keep float drift from accumulating after lots of stamp/erase cycles
+					ExtraCost[CellIndex] = 0.0f;
+				}
+			}
+		}
+	}
+
+	FORCEINLINE bool IsBlocked(int32 CellIndex) const { return BlockCount.IsValidIndex(CellIndex) && BlockCount[CellIndex] > 0; }
+	FORCEINLINE float GetExtraCost(int32 CellIndex) const { return ExtraCost.IsValidIndex(CellIndex) ? ExtraCost[CellIndex] : 0.0f; }
+
+	TArray<int32> BlockCount;
+	TArray<float> ExtraCost;
+
+	// Number of cells with BlockCount above zero
+	int32 BlockedCellCount = 0;
+};
+
+
+// Book-keeping for one actor registered with the overlay
+struct FGAOverlayRegistration
+{
+	TWeakObjectPtr<AActor> Actor;
+	FGAOverlayFootprint Footprint;
+
+	// What we stamped last time, so it can be erased exactly
+	TArray<int32> StampedCells;
+	FIntRect StampedRect;
+	int32 StampedCellIndex = INDEX_NONE;
+};
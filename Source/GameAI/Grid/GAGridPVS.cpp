@@ -0,0 +1,150 @@
+#include "GAGridPVS.h"
+
+#include "GAGridActor.h"
+#include "Async/ParallelFor.h"
+
+
+void FGAGridPVS::Reset()
+{
+	GridXCount = GridYCount = 0;
+	BakedDataHash = 0;
+	ClusterXCount = ClusterYCount = 0;
+	WordsPerRow = 0;
+	Bits.Empty();
+	Runs.Empty();
+	RowOffsets.Empty();
+}
+
+bool FGAGridPVS::IsValidFor(const AGAGridActor* Grid) const
+{
+	return Grid && (GridXCount > 0) && (GridXCount == Grid->XCount) && (GridYCount == Grid->YCount) && (BakedDataHash == Grid->GetDataHash());
+}
+
+int32 FGAGridPVS::GetClusterIndex(const FCellRef& CellRef) const
+{
+	return (CellRef.Y / BakedClusterSize) * ClusterXCount + (CellRef.X / BakedClusterSize);
+}
+
+void FGAGridPVS::Bake(const AGAGridActor* Grid)
+{
+	Reset();
+	if (!Grid || Grid->XCount <= 0 || Grid->YCount <= 0)
+	{
+		return;
+	}
+
+	ClusterSize = FMath::Max(ClusterSize, 1);
+	BakedClusterSize = ClusterSize;
+	BakedEncoding = Encoding;
+	GridXCount = Grid->XCount;
+	GridYCount = Grid->YCount;
+	BakedDataHash = Grid->GetDataHash();
+	ClusterXCount = FMath::DivideAndRoundUp(GridXCount, ClusterSize);
+	ClusterYCount = FMath::DivideAndRoundUp(GridYCount, ClusterSize);
+
+	int32 ClusterCount = ClusterXCount * ClusterYCount;
+	WordsPerRow = FMath::DivideAndRoundUp(ClusterCount, 32);
+
+	// Always bake to bits first. Each cluster owns its own row, so the rows can be filled in parallel
+	TArray<uint32> RowBits;
+	RowBits.SetNumZeroed(ClusterCount * WordsPerRow);
+
+	ParallelFor(ClusterCount, [this, Grid, &RowBits](int32 ClusterIndex)
+	{
+		uint32* Row = RowBits.GetData() + ClusterIndex * WordsPerRow;
+		int32 MinX = (ClusterIndex % ClusterXCount) * ClusterSize;
+		int32 MinY = (ClusterIndex / ClusterXCount) * ClusterSize;
+		TBitArray<> Visible;
+
+		for (int32 Y = MinY; Y < FMath::Min(MinY + ClusterSize, GridYCount); Y++)
+		{
+			for (int32 X = MinX; X < FMath::Min(MinX + ClusterSize, GridXCount); X++)
+			{
+				// Blocked cells never see anything, so don't let them widen the cluster's set
+				FCellRef Origin(X, Y);
+				if (!EnumHasAllFlags(Grid->GetCellData(Origin), ECellData::CellDataTraversable))
+				{
+					continue;
+				}
+
+				Grid->ComputeVisibility(Origin, Visible, 0, false);
+				for (TConstSetBitIterator<> It(Visible); It; ++It)
+				{
+					FCellRef Target(It.GetIndex() % GridXCount, It.GetIndex() / GridXCount);
+					int32 TargetCluster = GetClusterIndex(Target);
+					Row[TargetCluster >> 5] |= (1u << (TargetCluster & 31));
+				}
+			}
+		}
+	});
+
+	if (Encoding == EGAPVSEncoding::Bits)
+	{
+		Bits = MoveTemp(RowBits);
+		return;
+	}
+
+	// Run-length encode each row
+	RowOffsets.SetNumUninitialized(ClusterCount + 1);
+	for (int32 ClusterIndex = 0; ClusterIndex < ClusterCount; ClusterIndex++)
+	{
+		RowOffsets[ClusterIndex] = Runs.Num();
+		const uint32* Row = RowBits.GetData() + ClusterIndex * WordsPerRow;
+
+		bool bRunVisible = false;
+		int32 RunLength = 0;
+
+		auto EmitRun = [this](int32 Length)
+		{
+			// Runs longer than a uint16 are split with an empty run of the other kind in between
+			while (Length > MAX_uint16)
+			{
+				Runs.Add(MAX_uint16);
+				Runs.Add(0);
+				Length -= MAX_uint16;
+			}
+			Runs.Add(uint16(Length));
+		};
+
+		for (int32 Target = 0; Target < ClusterCount; Target++)
+		{
+			bool bVisible = (Row[Target >> 5] & (1u << (Target & 31))) != 0;
+			if (bVisible != bRunVisible)
+			{
+				EmitRun(RunLength);
+				bRunVisible = bVisible;
+				RunLength = 0;
+			}
+			RunLength++;
+		}
+		EmitRun(RunLength);
+	}
+	RowOffsets[ClusterCount] = Runs.Num();
+	WordsPerRow = 0;
+}
+
+bool FGAGridPVS::IsVisible(const FCellRef& A, const FCellRef& B) const
+{
+	int32 From = GetClusterIndex(A);
+	int32 To = GetClusterIndex(B);
+
+	if (BakedEncoding == EGAPVSEncoding::Bits)
+	{
+		return (Bits[From * WordsPerRow + (To >> 5)] & (1u << (To & 31))) != 0;
+	}
+
+	// Walk the runs until we pass the target column
+	int32 Position = 0;
+	bool bVisible = false;
+	for (int32 RunIndex = RowOffsets[From]; RunIndex < RowOffsets[From + 1]; RunIndex++)
+	{
+		Position += Runs[RunIndex];
+		if (To < Position)
+		{
+			return bVisible;
+		}
+		bVisible = !bVisible;
+	}
+
+	return false;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GAGridPVS.generated.h"
+
+class AGAGridActor;
+struct FCellRef;
+
+
+UENUM(BlueprintType)
+enum class EGAPVSEncoding : uint8
+{
+	// One bit per (cluster, cluster) pair. Lookups are a shift and a mask.
+	Bits,
+
+	// Each row stored as alternating run lengths (hidden, visible, hidden, ...). Much smaller for levels with
+	// big open or big closed areas, but a lookup has to walk the row's runs.
+	RunLength,
+};
+
+
+// Precomputed potentially-visible set for a static grid.
+//
+// Cells are grouped into ClusterSize x ClusterSize clusters, and for every pair of clusters we store whether
+// any cell in one can see any cell in the other (using the same symmetric shadowcasting as
+// AGAGridActor::ComputeVisibility). IsVisible(A, B) is then a lookup instead of a line walk.
+//
+// Trade-offs:
+//  - Memory for Bits is (CellCount / ClusterSize^2)^2 bits. A 100x100 grid is ~12 MB at ClusterSize 1,
+//    ~780 KB at 2 and ~48 KB at 4. RunLength is usually several times smaller again.
+//  - ClusterSize 1 is exact (it agrees with ComputeVisibility). Larger clusters are conservative: they never
+//    say "hidden" for a visible pair, but may say "visible" for a hidden one, mostly near walls.
+//  - Only the static Data is baked. The dynamic overlay (moving props, robots) is left out, and
+//    AGAGridActor::IsVisible checks the pairs the PVS calls visible against the overlay along the line between them.
+//  - The bake remembers a hash of the Data it was made from, and stops being valid once the data changes
+//    (RefreshDataFromNav, or cells written from code). Bake again after that.
+USTRUCT(BlueprintType)
+struct FGAGridPVS
+{
+	GENERATED_BODY()
+
+	FGAGridPVS() : ClusterSize(2), Encoding(EGAPVSEncoding::Bits), BakedClusterSize(1), BakedEncoding(EGAPVSEncoding::Bits), BakedDataHash(0), GridXCount(0), GridYCount(0), ClusterXCount(0), ClusterYCount(0), WordsPerRow(0) {}
+
+	UPROPERTY(EditAnywhere, meta = (ClampMin = 1))
+	int32 ClusterSize;
+
+	UPROPERTY(EditAnywhere)
+	EGAPVSEncoding Encoding;
+
+	// Bake from the grid's current data. Runs the clusters in parallel
+	void Bake(const AGAGridActor* Grid);
+
+	void Reset();
+
+	// Was this baked from this grid's current dimensions and Data?
+	bool IsValidFor(const AGAGridActor* Grid) const;
+
+	// Both cells must be in bounds. Conservative if ClusterSize > 1 (see above)
+	bool IsVisible(const FCellRef& A, const FCellRef& B) const;
+
+	SIZE_T GetAllocatedSize() const { return Bits.GetAllocatedSize() + Runs.GetAllocatedSize() + RowOffsets.GetAllocatedSize(); }
+
+private:
+	int32 GetClusterIndex(const FCellRef& CellRef) const;
+
+	// ClusterSize and Encoding as they were when baked, in case they're edited afterwards
+	UPROPERTY()
+	int32 BakedClusterSize;
+
+	UPROPERTY()
+	EGAPVSEncoding BakedEncoding;
+
+	// AGAGridActor::GetDataHash at bake time
+	UPROPERTY()
+	uint32 BakedDataHash;
+
+	UPROPERTY()
+	int32 GridXCount;
+
+	UPROPERTY()
+	int32 GridYCount;
+
+	UPROPERTY()
+	int32 ClusterXCount;
+
+	UPROPERTY()
+	int32 ClusterYCount;
+
+	// Bits encoding: one row of WordsPerRow words per cluster
+	UPROPERTY()
+	int32 WordsPerRow;
+
+	UPROPERTY()
+	TArray<uint32> Bits;
+
+	// RunLength encoding: Runs[RowOffsets[Row]] .. Runs[RowOffsets[Row + 1] - 1], starting with a hidden run
+	UPROPERTY()
+	TArray<uint16> Runs;
+
+	UPROPERTY()
+	TArray<int32> RowOffsets;
+};
@@ -0,0 +1,67 @@
+#include "GAAILOD.h"
+
+#include "GAPathComponent.h"
+#include "GameAI/Spatial/GASpatialEvaluator.h"
+
+
+UGAAILODSubsystem::UGAAILODSubsystem()
+{
+	// Close enough to matter, on its way, and everyone else
+	Tiers.Add(FGAAILODTier(2000.0f, 0.0f, EGAAISearchMode::Full, 0, 4));
+	Tiers.Add(FGAAILODTier(5000.0f, 0.25f, EGAAISearchMode::CoarseToFine, 16, 4));
+	Tiers.Add(FGAAILODTier(0.0f, 1.0f, EGAAISearchMode::CoarseToFine, 10, 2));
+
+	OffscreenDistanceScale = 2.0f;
+	MaxUpdatesPerFrame = 32;
+}
+
+int32 UGAAILODSubsystem::ComputeTier(const FVector& AgentLocation, bool bRecentlyRendered, const FVector& PlayerLocation) const
+{
+	float Distance = FVector::Dist(AgentLocation, PlayerLocation);
+	if (!bRecentlyRendered)
+	{
+		Distance *= OffscreenDistanceScale;
+	}
+
+	for (int32 TierIndex = 0; TierIndex < Tiers.Num(); TierIndex++)
+	{
+		if (Tiers[TierIndex].MaxDistance <= 0.0f || Distance <= Tiers[TierIndex].MaxDistance)
+		{
+			return TierIndex;
+		}
+	}
+
+	return FMath::Max(Tiers.Num() - 1, 0);
+}
+
+const FGAAILODTier& UGAAILODSubsystem::GetTier(int32 TierIndex) const
+{
+	return Tiers.IsValidIndex(TierIndex) ? Tiers[TierIndex] : DefaultTier;
+}
+
+double UGAAILODSubsystem::GetStaggeredStartTime(int32 AgentId, int32 TierIndex, double Now) const
+{
+	// Golden ratio sequence: consecutive ids land far apart in [0, 1), however many there are
+	double Phase = FMath::Frac(double(AgentId) * 0.6180339887498949);
+	return Now + Phase * GetTier(TierIndex).UpdateInterval;
+}
+
+void UGAAILODSubsystem::ApplyToQuery(const UGAPathComponent* PathComponent, FGASpatialQuery& Query) const
+{
+	if (!PathComponent || PathComponent->LODTier == INDEX_NONE)
+	{
+		return;
+	}
+
+	const FGAAILODTier& Tier = GetTier(PathComponent->LODTier);
+	if (Tier.SearchRadius > 0)
+	{
+		Query.SearchRadius = FMath::Min(Query.SearchRadius, Tier.SearchRadius);
+	}
+
+	if (Tier.SearchMode == EGAAISearchMode::CoarseToFine)
+	{
+		Query.RefineBudget = Query.bCoarseToFine ? FMath::Min(Query.RefineBudget, Tier.RefineBudget) : Tier.RefineBudget;
+		Query.bCoarseToFine = true;
+	}
+}
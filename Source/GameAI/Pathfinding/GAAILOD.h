@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GAAILOD.generated.h"
+
+class UGAPathComponent;
+struct FGASpatialQuery;
+
+
+// How hard an agent in a given tier is allowed to think about where to go
+UENUM(BlueprintType)
+enum class EGAAISearchMode : uint8
+{
+	Full,			// Score every candidate cell
+	CoarseToFine,	// Score grid mip blocks first, then refine only the best few (see FGASpatialQuery::bCoarseToFine)
+};
+
+
+// One level of detail. Agents are sorted into the first tier whose MaxDistance covers them
+USTRUCT(BlueprintType)
+struct FGAAILODTier
+{
+	GENERATED_BODY()
+
+	FGAAILODTier() : MaxDistance(0.0f), UpdateInterval(0.0f), SearchMode(EGAAISearchMode::Full), SearchRadius(0), RefineBudget(4) {}
+	FGAAILODTier(float InMaxDistance, float InUpdateInterval, EGAAISearchMode InSearchMode, int32 InSearchRadius, int32 InRefineBudget)
+		: MaxDistance(InMaxDistance), UpdateInterval(InUpdateInterval), SearchMode(InSearchMode), SearchRadius(InSearchRadius), RefineBudget(InRefineBudget) {}
+
+	// World units from the player (after the off-screen scaling). <= 0 means no limit
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float MaxDistance;
+
+	// Seconds between path updates. 0 means every frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float UpdateInterval;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EGAAISearchMode SearchMode;
+
+	// Caps FGASpatialQuery::SearchRadius (cells). <= 0 leaves the query alone
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 SearchRadius;
+
+	// Blocks refined at full resolution when SearchMode is CoarseToFine
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 RefineBudget;
+};
+
+
+// Significance-based level of detail for path-following agents.
+// Each agent is scored by its distance to the player, stretched by OffscreenDistanceScale when it hasn't been
+// rendered recently, and put in a tier. The tier decides how often UGAPathFollowingSubsystem updates the agent's
+// path and how much search the spatial evaluator spends on it. Updates are staggered across frames, and at most
+// MaxUpdatesPerFrame run in any one frame (most overdue first), so the total cost stays flat as agents are added.
+UCLASS()
+class UGAAILODSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UGAAILODSubsystem();
+
+	// Nearest first
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TArray<FGAAILODTier> Tiers;
+
+	// Agents not rendered recently count as this much further away
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float OffscreenDistanceScale;
+
+	// Path updates allowed per frame, across all agents. 0 means no limit
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MaxUpdatesPerFrame;
+
+	int32 ComputeTier(const FVector& AgentLocation, bool bRecentlyRendered, const FVector& PlayerLocation) const;
+
+	const FGAAILODTier& GetTier(int32 TierIndex) const;
+
+	// Spreads agents' updates over their tier's interval, so agents that change tier together don't all land
+	// on the same frame. AgentId has to stay the same for the agent's lifetime (see
+	// UGAPathFollowingSubsystem::GetAgentId), or its phase jumps around as other agents come and go
+	double GetStaggeredStartTime(int32 AgentId, int32 TierIndex, double Now) const;
+
+	// Narrows a spatial query according to the path component's current tier
+	void ApplyToQuery(const UGAPathComponent* PathComponent, FGASpatialQuery& Query) const;
+
+private:
+	FGAAILODTier DefaultTier;
+};
@@ -0,0 +1,136 @@
+#include "GAAgentSpatialHash.h"
+
+
+void FGAAgentSpatialHash::Reset()
+{
+	Grid = nullptr;
+	BucketXCount = 0;
+	BucketYCount = 0;
+	Points.Reset();
+	BucketStarts.Reset();
+	Entries.Reset();
+}
+
+FIntPoint FGAAgentSpatialHash::GetBucket(const FCellRef& CellRef) const
+{
+	// Clamped lookups can land one past the last cell
+	return FIntPoint(
+		FMath::Clamp(CellRef.X / BucketCells, 0, BucketXCount - 1),
+		FMath::Clamp(CellRef.Y / BucketCells, 0, BucketYCount - 1));
+}
+
+void FGAAgentSpatialHash::Build(const AGAGridActor* InGrid, TConstArrayView<FVector> Positions, TConstArrayView<uint8> Include, int32 InBucketCells)
+{
+	Reset();
+	if (!InGrid || InGrid->XCount <= 0 || InGrid->YCount <= 0)
+	{
+		return;
+	}
+
+	Grid = InGrid;
+	BucketCells = FMath::Max(InBucketCells, 1);
+	BucketXCount = FMath::DivideAndRoundUp(Grid->XCount, BucketCells);
+	BucketYCount = FMath::DivideAndRoundUp(Grid->YCount, BucketCells);
+	Points = Positions;
+
+	// One batched world-to-cell pass for everyone
+	Grid->GetCellRefs(Positions, PointCells, true);
+
+	// Counting sort by bucket: count, prefix sum, scatter
+	BucketStarts.SetNumZeroed(BucketXCount * BucketYCount + 1);
+	PointBuckets.SetNumUninitialized(Positions.Num());
+
+	int32 IncludedCount = 0;
+	for (int32 Index = 0; Index < Positions.Num(); Index++)
+	{
+		if (Include.Num() > 0 && !Include[Index])
+		{
+			PointBuckets[Index] = INDEX_NONE;
+			continue;
+		}
+
+		FIntPoint Bucket = GetBucket(PointCells[Index]);
+		PointBuckets[Index] = Bucket.Y * BucketXCount + Bucket.X;
+		BucketStarts[PointBuckets[Index] + 1]++;
+		IncludedCount++;
+	}
+
+	for (int32 Bucket = 1; Bucket < BucketStarts.Num(); Bucket++)
+	{
+		BucketStarts[Bucket] += BucketStarts[Bucket - 1];
+	}
+
+	// Scatter, using a copy of the starts as insertion cursors
+	TArray<int32, TInlineAllocator<256>> Cursors(BucketStarts.GetData(), BucketStarts.Num() - 1);
+	Entries.SetNumUninitialized(IncludedCount);
+	for (int32 Index = 0; Index < Positions.Num(); Index++)
+	{
+		if (PointBuckets[Index] != INDEX_NONE)
+		{
+			Entries[Cursors[PointBuckets[Index]]++] = Index;
+		}
+	}
+}
+
+int32 FGAAgentSpatialHash::QueryRadius(const FVector& Point, float Radius, FGANeighbourList& Out, int32 IgnoreIndex) const
+{
+	if (!Grid || Entries.Num() == 0)
+	{
+		return 0;
+	}
+
+	FIntPoint Center = GetBucket(Grid->GetCellRef(Point, true));
+	int32 BucketRadius = FMath::CeilToInt(Radius / (Grid->CellScale * BucketCells));
+	int32 MinX = FMath::Max(Center.X - BucketRadius, 0);
+	int32 MaxX = FMath::Min(Center.X + BucketRadius, BucketXCount - 1);
+	int32 MinY = FMath::Max(Center.Y - BucketRadius, 0);
+	int32 MaxY = FMath::Min(Center.Y + BucketRadius, BucketYCount - 1);
+
+	float RadiusSquared = Radius * Radius;
+	int32 Added = 0;
+
+	for (int32 Y = MinY; Y <= MaxY; Y++)
+	{
+		// Buckets in a row are contiguous in Entries, so a row is one range
+		int32 RowBegin = BucketStarts[Y * BucketXCount + MinX];
+		int32 RowEnd = BucketStarts[Y * BucketXCount + MaxX + 1];
+
+		for (int32 EntryIndex = RowBegin; EntryIndex < RowEnd; EntryIndex++)
+		{
+			int32 Index = Entries[EntryIndex];
+			if (Index != IgnoreIndex && FVector::DistSquared2D(Points[Index], Point) <= RadiusSquared)
+			{
+				Out.Add(Index);
+				Added++;
+			}
+		}
+	}
+
+	return Added;
+}
+
+int32 FGAAgentSpatialHash::QueryNearest(const FVector& Point, int32 K, float MaxRadius, FGANeighbourList& Out, int32 IgnoreIndex) const
+{
+	Out.Reset();
+	if (K <= 0)
+	{
+		return 0;
+	}
+
+	QueryRadius(Point, MaxRadius, Out, IgnoreIndex);
+
+	// Ties broken by index so the result doesn't depend on bucket order
+	Out.Sort([this, &Point](int32 A, int32 B)
+	{
+		float DistA = FVector::DistSquared2D(Points[A], Point);
+		float DistB = FVector::DistSquared2D(Points[B], Point);
+		return DistA < DistB || (DistA == DistB && A < B);
+	});
+
+	if (Out.Num() > K)
+	{
+		Out.SetNum(K, EAllowShrinking::No);
+	}
+
+	return Out.Num();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameAI/Grid/GAGridActor.h"
+
+
+// Neighbour query results. Small enough to stay off the heap for typical queries
+typedef TArray<int32, TInlineAllocator<32>> FGANeighbourList;
+
+
+// A spatial hash of agent positions, rebuilt every frame, with buckets aligned to the grid's cells.
+// Each bucket covers BucketCells x BucketCells grid cells. Agents are counting-sorted by bucket into one flat
+// array (bucket b's agents are Entries[BucketStarts[b] .. BucketStarts[b + 1])), so building is O(agents) with
+// no per-bucket allocation, and a query walks only the buckets its radius overlaps.
+// Queries are read-only and can run from several threads at once.
+class FGAAgentSpatialHash
+{
+public:
+	// Agents whose Include flag is 0 are left out (Include can be empty). Indices handed back by the queries
+	// are indices into Positions
+	void Build(const AGAGridActor* Grid, TConstArrayView<FVector> Positions, TConstArrayView<uint8> Include, int32 BucketCells = 2);
+
+	void Reset();
+
+	// Appends every agent within Radius of Point (2D distance) to Out. Returns how many were added
+	int32 QueryRadius(const FVector& Point, float Radius, FGANeighbourList& Out, int32 IgnoreIndex = INDEX_NONE) const;
+
+	// Up to K agents within MaxRadius of Point, nearest first. Replaces the contents of Out
+	int32 QueryNearest(const FVector& Point, int32 K, float MaxRadius, FGANeighbourList& Out, int32 IgnoreIndex = INDEX_NONE) const;
+
+	int32 Num() const { return Entries.Num(); }
+
+private:
+	FIntPoint GetBucket(const FCellRef& CellRef) const;
+
+	const AGAGridActor* Grid = nullptr;
+	int32 BucketCells = 1;
+	int32 BucketXCount = 0;
+	int32 BucketYCount = 0;
+
+	// Copy of the input positions, for the distance tests
+	TArray<FVector> Points;
+
+	TArray<int32> BucketStarts;
+	TArray<int32> Entries;
+
+	// Scratch for Build
+	TArray<FCellRef> PointCells;
+	TArray<int32> PointBuckets;
+};
@@ -0,0 +1,262 @@
+#include "GADynamicDistanceMap.h"
+
+#include "GAPathComponent.h"
+
+
+FGADynamicDistanceMap::FGADynamicDistanceMap()
+	: XCount(0), YCount(0), Distances(MakeShared<FGAGridMap, ESPMode::ThreadSafe>()), bSourceChanged(false)
+{
+}
+
+FGADynamicDistanceMap::~FGADynamicDistanceMap()
+{
+	UnbindFromGrid();
+}
+
+void FGADynamicDistanceMap::Initialize(const AGAGridActor* InGrid, const FCellRef& InSourceCell)
+{
+	UnbindFromGrid();
+
+	Grid = InGrid;
+	XCount = InGrid->XCount;
+	YCount = InGrid->YCount;
+	SourceCell = InSourceCell;
+	bSourceChanged = false;
+	PendingRects.Reset();
+	Queue.Reset();
+
+	// A fresh map, so whoever holds the old one keeps it
+	Distances = MakeShared<FGAGridMap, ESPMode::ThreadSafe>(InGrid, FGridBox(0, XCount - 1, 0, YCount - 1), INFINITY);
+	RHS.Init(INFINITY, XCount * YCount);
+
+	if (InGrid->IsCellRefInBounds(SourceCell))
+	{
+		int32 SourceIndex = InGrid->CellRefToIndex(SourceCell);
+		RHS[SourceIndex] = 0.0f;
+		Enqueue(SourceIndex);
+	}
+
+	// The first update is just a plain Dijkstra flood
+	Update();
+}
+
+void FGADynamicDistanceMap::BindToGrid()
+{
+	UnbindFromGrid();
+	if (const AGAGridActor* GridActor = Grid.Get())
+	{
+		CellsChangedHandle = GridActor->OnCellsChanged.AddRaw(this, &FGADynamicDistanceMap::NotifyCellsChanged);
+	}
+}
+
+void FGADynamicDistanceMap::UnbindFromGrid()
+{
+	if (CellsChangedHandle.IsValid())
+	{
+		if (const AGAGridActor* GridActor = Grid.Get())
+		{
+			GridActor->OnCellsChanged.Remove(CellsChangedHandle);
+		}
+		CellsChangedHandle.Reset();
+	}
+}
+
+void FGADynamicDistanceMap::SetSource(const FCellRef& NewSourceCell)
+{
+	if (NewSourceCell == SourceCell)
+	{
+		return;
+	}
+
+	// Only remember the first old source -- if it moves several times between updates, that's the one whose
+	// RHS is stale
+	if (!bSourceChanged)
+	{
+		PreviousSourceCell = SourceCell;
+		bSourceChanged = true;
+	}
+	SourceCell = NewSourceCell;
+}
+
+void FGADynamicDistanceMap::NotifyCellsChanged(const FIntRect& Rect)
+{
+	PendingRects.Add(Rect);
+}
+
+float FGADynamicDistanceMap::ComputeRHS(int32 CellIndex) const
+{
+	const AGAGridActor* GridActor = Grid.Get();
+	FCellRef CellRef(CellIndex % XCount, CellIndex / XCount);
+
+	if (CellRef == SourceCell)
+	{
+		return 0.0f;
+	}
+
+	// Same rules as Dijkstra: you pay the cost of the cell you step into, and can't step into blocked cells
+	if (!GridActor->IsCellTraversable(CellRef))
+	{
+		return INFINITY;
+	}
+
+	const float* G = Distances->Data.GetData();
+	float Best = INFINITY;
+	if (CellRef.X > 0)				Best = FMath::Min(Best, G[CellIndex - 1]);
+	if (CellRef.X < XCount - 1)		Best = FMath::Min(Best, G[CellIndex + 1]);
+	if (CellRef.Y > 0)				Best = FMath::Min(Best, G[CellIndex - XCount]);
+	if (CellRef.Y < YCount - 1)		Best = FMath::Min(Best, G[CellIndex + XCount]);
+
+	return (Best == INFINITY) ? INFINITY : Best + GridActor->GetCellCost(CellRef);
+}
+
+void FGADynamicDistanceMap::Enqueue(int32 CellIndex)
+{
+	// Stale entries for the same cell stay in the heap and get skipped when popped
+	Queue.HeapPush({ FMath::Min(Distances->Data[CellIndex], RHS[CellIndex]), CellIndex });
+}
+
+void FGADynamicDistanceMap::DetachDistances()
+{
+	// Nobody can pick up a new reference while we hold the only one, so this can't race with readers
+	if (!Distances.IsUnique())
+	{
+		Distances = MakeShared<FGAGridMap, ESPMode::ThreadSafe>(*Distances);
+	}
+}
+
+void FGADynamicDistanceMap::UpdateCell(int32 CellIndex)
+{
+	RHS[CellIndex] = ComputeRHS(CellIndex);
+	if (Distances->Data[CellIndex] != RHS[CellIndex])
+	{
+		Enqueue(CellIndex);
+	}
+}
+
+int32 FGADynamicDistanceMap::Update()
+{
+	const AGAGridActor* GridActor = Grid.Get();
+	if (!GridActor)
+	{
+		return 0;
+	}
+
+	// Grid got resized under us -- start over
+	if (GridActor->XCount != XCount || GridActor->YCount != YCount)
+	{
+		bool bWasBound = CellsChangedHandle.IsValid();
+		Initialize(GridActor, SourceCell);
+		if (bWasBound)
+		{
+			BindToGrid();
+		}
+		return XCount * YCount;
+	}
+
+	// Queue up everything whose RHS may have changed
+	if (bSourceChanged)
+	{
+		if (GridActor->IsCellRefInBounds(PreviousSourceCell))
+		{
+			UpdateCell(GridActor->CellRefToIndex(PreviousSourceCell));
+		}
+		if (GridActor->IsCellRefInBounds(SourceCell))
+		{
+			UpdateCell(GridActor->CellRefToIndex(SourceCell));
+		}
+		bSourceChanged = false;
+	}
+
+	for (const FIntRect& Rect : PendingRects)
+	{
+		for (int32 Y = FMath::Max(Rect.Min.Y, 0); Y <= FMath::Min(Rect.Max.Y, YCount - 1); Y++)
+		{
+			for (int32 X = FMath::Max(Rect.Min.X, 0); X <= FMath::Min(Rect.Max.X, XCount - 1); X++)
+			{
+				UpdateCell(Y * XCount + X);
+			}
+		}
+	}
+	PendingRects.Reset();
+
+	if (Queue.Num() == 0)
+	{
+		return 0;
+	}
+
+	// Standard LPA* repair loop, with no goal: run until every cell is consistent
+	DetachDistances();
+	float* G = Distances->Data.GetData();
+	int32 Rewrites = 0;
+
+	auto UpdateNeighbors = [this](int32 CellIndex)
+	{
+		int32 X = CellIndex % XCount;
+		int32 Y = CellIndex / XCount;
+		if (X > 0)				UpdateCell(CellIndex - 1);
+		if (X < XCount - 1)		UpdateCell(CellIndex + 1);
+		if (Y > 0)				UpdateCell(CellIndex - XCount);
+		if (Y < YCount - 1)		UpdateCell(CellIndex + XCount);
+	};
+
+	while (Queue.Num() > 0)
+	{
+		FQueueEntry Entry;
+		Queue.HeapPop(Entry, EAllowShrinking::No);
+
+		int32 CellIndex = Entry.CellIndex;
+		float CellG = G[CellIndex];
+		float CellRHS = RHS[CellIndex];
+
+		// Skip stale entries
+		if (CellG == CellRHS || Entry.Key != FMath::Min(CellG, CellRHS))
+		{
+			continue;
+		}
+
+		Rewrites++;
+		if (CellG > CellRHS)
+		{
+			// Got cheaper: lock it in and let the neighbours know
+			G[CellIndex] = CellRHS;
+			UpdateNeighbors(CellIndex);
+		}
+		else
+		{
+			// Got more expensive: invalidate, then let it and its neighbours find a new best
+			G[CellIndex] = INFINITY;
+			UpdateCell(CellIndex);
+			UpdateNeighbors(CellIndex);
+		}
+	}
+
+	return Rewrites;
+}
+
+#if !UE_BUILD_SHIPPING
+bool FGADynamicDistanceMap::ValidateAgainstDijkstra() const
+{
+	const AGAGridActor* GridActor = Grid.Get();
+	if (!GridActor || !GridActor->IsCellRefInBounds(SourceCell))
+	{
+		return false;
+	}
+
+	FGAGridMap Reference(GridActor, FGridBox(0, XCount - 1, 0, YCount - 1), INFINITY);
+	GetDefault<UGAPathComponent>()->Dijkstra(GridActor->GetCellPosition(SourceCell), Reference, GridActor);
+
+	for (int32 CellIndex = 0; CellIndex < Reference.Data.Num(); CellIndex++)
+	{
+		float Expected = Reference.Data[CellIndex];
+		float Actual = Distances->Data[CellIndex];
+		if (Expected != Actual && !FMath::IsNearlyEqual(Expected, Actual, 1.0e-3f))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FGADynamicDistanceMap: cell (%d, %d) is %f, Dijkstra says %f"),
+				CellIndex % XCount, CellIndex / XCount, Actual, Expected);
+			return false;
+		}
+	}
+
+	return true;
+}
+#endif
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameAI/Grid/GAGridActor.h"
+#include "GameAI/Grid/GAGridMapCache.h"
+
+
+// A distance map (the same thing UGAPathComponent::Dijkstra produces) that is kept up to date incrementally.
+//
+// This is Lifelong Planning A* without a goal (or equivalently, a dynamic single-source shortest path): every
+// cell keeps its current distance G and a one-step lookahead RHS = min over neighbours of (G + step cost).
+// When the source moves, or cells change traversability or cost, only the cells whose RHS changes are queued,
+// and the repair only touches cells whose distance actually changes. Once Update() returns, G matches a full
+// Dijkstra from the current source.
+//
+// What that saves depends on the change. A local change with the source staying put (an overlay stamp, a door)
+// only rewrites the cells routed through it, which is usually a small fraction of the map. Moving the source
+// changes the distance of nearly every reachable cell, so a source move still rewrites most of the map; it skips
+// unreachable space and the allocation, but isn't much cheaper than a fresh flood.
+//
+// The distances are handed out as a shared handle rather than copied. Update() writes them in place when nobody
+// else holds a handle, and only copies the map first if an older handle is still alive, so a reader on another
+// thread keeps a consistent snapshot.
+//
+// If bound to a grid with BindToGrid, changes broadcast by AGAGridActor::OnCellsChanged are picked up
+// automatically on the next Update().
+class FGADynamicDistanceMap
+{
+public:
+	FGADynamicDistanceMap();
+	~FGADynamicDistanceMap();
+
+	// Sets up the map for the given grid and does the initial full flood from SourceCell
+	void Initialize(const AGAGridActor* Grid, const FCellRef& SourceCell);
+
+	// Listen to the grid's OnCellsChanged so traversability changes get repaired
+	void BindToGrid();
+	void UnbindFromGrid();
+
+	bool IsInitialized() const { return Grid.IsValid() && Distances->Data.Num() > 0; }
+
+	// Move the source. The repair happens in Update()
+	void SetSource(const FCellRef& NewSourceCell);
+	const FCellRef& GetSource() const { return SourceCell; }
+
+	// Tell the map that the cells in Rect (inclusive cell indices) changed traversability or cost
+	void NotifyCellsChanged(const FIntRect& Rect);
+
+	// Repair everything that changed since the last call. Returns the number of cells whose distance was rewritten
+	int32 Update();
+
+	const AGAGridActor* GetGrid() const { return Grid.Get(); }
+
+	// Distances from the source, INFINITY where unreachable. Only valid after Update()
+	const FGAGridMap& GetDistanceMap() const { return *Distances; }
+
+	// The same map as a handle that stays valid (and unchanged) across later updates
+	FGAGridMapHandle GetDistanceMapHandle() const { return Distances; }
+
+#if !UE_BUILD_SHIPPING
+	// Runs a full Dijkstra and checks it agrees with us. For testing
+	bool ValidateAgainstDijkstra() const;
+#endif
+
+private:
+	struct FQueueEntry
+	{
+		float Key;
+		int32 CellIndex;
+
+		// Min-heap on key, ties broken by index so the order is deterministic
+		bool operator<(const FQueueEntry& Other) const
+		{
+			return (Key < Other.Key) || (Key == Other.Key && CellIndex < Other.CellIndex);
+		}
+	};
+
+	void UpdateCell(int32 CellIndex);
+	float ComputeRHS(int32 CellIndex) const;
+	void Enqueue(int32 CellIndex);
+
+	// Copies Distances if a handle to them is still out, so the writes that follow don't show through it
+	void DetachDistances();
+
+	TWeakObjectPtr<const AGAGridActor> Grid;
+	FDelegateHandle CellsChangedHandle;
+	FCellRef SourceCell;
+	int32 XCount;
+	int32 YCount;
+
+	// G values. Kept directly in a grid map, so readers don't need a copy
+	TSharedPtr<FGAGridMap, ESPMode::ThreadSafe> Distances;
+	TArray<float> RHS;
+	TArray<FQueueEntry> Queue;
+
+	// Changes reported since the last Update
+	TArray<FIntRect> PendingRects;
+	bool bSourceChanged;
+	FCellRef PreviousSourceCell;
+};
@@ -1,5 +1,10 @@
 #include "GAPathComponent.h"
 
+#include "GameAI/Pathfinding/GAPathFollowingSubsystem.h"
+#include "GameAI/Grid/GAGridMapOps.h"
+#include "GameAI/GameAIStats.h"
+#include "GACoreLine.h"
+#include "Misc/ScopeExit.h"
 #include "GameMapsSettings.h"
 #include "VectorTypes.h"
 #include "GameFramework/NavMovementComponent.h"
@@ -12,6 +17,14 @@ UGAPathComponent::UGAPathComponent(const FObjectInitializer& ObjectInitializer)
 	State = GAPS_None;
 	bDestinationValid = false;
 	ArrivalDistance = 100.0f;
+	bUseTickManager = true;
+	bManagedByTickManager = false;
+	LODTier = INDEX_NONE;
+	bHasPathBounds = false;
+	SegmentStart = FVector::ZeroVector;
+	bReplanRequested = false;
+	LastReplanTime = -BIG_NUMBER;
+	LastVisibilityCheckTime = -BIG_NUMBER;
 
 	// A bit of Unreal magic to make TickComponent below get called
 	PrimaryComponentTick.bCanEverTick = true;
@@ -43,16 +56,26 @@ const AGAGridActor* UGAPathComponent::GetGridActor() const
 	}
 }
 
+AGAGridActor* UGAPathComponent::GetMutableGridActor()
+{
+	// Fills in the cache if need be
+	GetGridActor();
+	return GridActor.Get();
+}
+
 /**
- *  A setter for steps
+ *  A setter for steps. An empty path means there's nothing to follow, so the destination is dropped with it
  * @param steps 
  */
 void UGAPathComponent::SetSteps(TArray<FPathStep>& steps)
 {
+	if (steps.Num() == 0)
+	{
+		ClearDestination();
+		return;
+	}
 
-	if (steps.Num() > 0)
 	Steps = steps;
-	
 }
 
 /**
@@ -88,11 +111,50 @@ APawn* UGAPathComponent::GetOwnerPawn()
 }
 
 
+void UGAPathComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	BindToGridChanges();
+
+	UGAPathFollowingSubsystem* TickManager = GetWorld() ? GetWorld()->GetSubsystem<UGAPathFollowingSubsystem>() : nullptr;
+	if (bUseTickManager && TickManager)
+	{
+		TickManager->RegisterComponent(this);
+		bManagedByTickManager = true;
+
+		// Nothing left for our own tick to do, unless Blueprint wants its Tick event
+		if (!GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UGAPathComponent, ReceiveTick)))
+		{
+			SetComponentTickEnabled(false);
+		}
+	}
+}
+
+void UGAPathComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bManagedByTickManager)
+	{
+		if (UGAPathFollowingSubsystem* TickManager = GetWorld() ? GetWorld()->GetSubsystem<UGAPathFollowingSubsystem>() : nullptr)
+		{
+			TickManager->UnregisterComponent(this);
+		}
+		bManagedByTickManager = false;
+	}
+
+	UnbindFromGridChanges();
+	Super::EndPlay(EndPlayReason);
+}
+
 void UGAPathComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
-	if (bDestinationValid)
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_PathTick);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGAPathComponent::TickComponent);
+
+	APawn* Pawn = GetOwnerPawn();
+	if (bDestinationValid && !bManagedByTickManager && Pawn)
 	{
-		RefreshPath();
+		UpdatePathFrom(Pawn->GetActorLocation(), GetWorld()->GetTimeSeconds());
 
 		if (State == GAPS_Active)
 		{
@@ -112,8 +174,13 @@ EGAPathState UGAPathComponent::RefreshPath()
 {
 
 	AActor* Owner = GetOwnerPawn();
-	FVector StartPoint = Owner->GetActorLocation();
+	return RefreshPathFrom(Owner->GetActorLocation());
+}
+
+EGAPathState UGAPathComponent::RefreshPathFrom(const FVector& StartPoint)
+{
 	check(bDestinationValid);
+	GAMEAI_TRACE_AGENT_SCOPE(GetOwner());
 
 	float DistanceToDestination = FVector::Dist(StartPoint, Destination);
 
@@ -131,14 +198,13 @@ EGAPathState UGAPathComponent::RefreshPath()
 		State = SmoothPath(StartPoint, UnsmoothedSteps, Steps);
 		
 	}
+
+	SegmentStart = StartPoint;
+	RefreshPathBounds(StartPoint);
+	FGameAIStats::RecordPathRefresh(Steps.Num());
 	
 	return State;
 }
-float Heuristic(const FCellRef& A, const FCellRef& B) 
-{
-	return FMath::Abs(A.X - B.X) + FMath::Abs(A.Y - B.Y);
-}
-
 TArray<FCellRef> GetNeighbors(const FCellRef& CurrentCell) 
 {
 	TArray<FCellRef> Neighbors;
@@ -149,34 +215,14 @@ TArray<FCellRef> GetNeighbors(const FCellRef& CurrentCell)
 	return Neighbors;
 }
 
-//Function to create Array of Fpathsteps from startcell to destination cell
-void ReconstructPath(const TMap<FCellRef, FCellRef>& CameFrom, FCellRef Current, const AGAGridActor* Grid, TArray<FPathStep>& StepsOut) 
+EGAPathState UGAPathComponent::AStar(const FVector& StartPoint, TArray<FPathStep>& StepsOut) const
 {
-	StepsOut.Empty(); 
-
-	TArray<FCellRef> Path;
-	Path.Add(Current);
-
-	while (CameFrom.Contains(Current))
-	{
-		Current = CameFrom[Current]; 
-		Path.Insert(Current, 0); 
-	}
-Path.Remove(Current);
-	
-	for (const FCellRef& Cell : Path)
-	{
-		FVector WorldLocation = Grid->GetCellPosition(Cell); 
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_AStar);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGAPathComponent::AStar);
 
-		FPathStep Step;
-		Step.Set(WorldLocation, Cell); 
-		StepsOut.Add(Step);
-		
-	}
-}
+	GACore::FSearchStats Stats;
+	ON_SCOPE_EXIT { FGameAIStats::RecordSearch(Stats.NodesExpanded, Stats.HeapPushes); };
 
-EGAPathState UGAPathComponent::AStar(const FVector& StartPoint, TArray<FPathStep>& StepsOut) const
-{
 	const AGAGridActor* Grid = GetGridActor();
     
     // Ensure grid exists
@@ -185,79 +231,33 @@ EGAPathState UGAPathComponent::AStar(const FVector& StartPoint, TArray<FPathStep
 		return GAPS_Invalid; 
 	}
 
-	FCellRef StartCell = Grid->GetCellRef(StartPoint);
-	TArray<FCellRef> OpenSet;
-	TMap<FCellRef, FCellRef> CameFrom; 
-	TMap<FCellRef, float> GScore;     
-	TMap<FCellRef, float> FScore;   
-
-	// GScore of the Start Cell is 0.
-	GScore.Add(StartCell, 0);
-
-	// FScore = GScore + H. Since GScore=0, FScore[start_cell] = Heuristic
-	FScore.Add(StartCell, Heuristic(StartCell, DestinationCell));
+	// Searches run on worker threads (and on the CDO, from the benchmark), so the buffers are per thread
+	static thread_local GACore::FSearchScratch Scratch;
+	static thread_local std::vector<int32_t> PathIndices;
 
-	// Override the comparator so that it adds Cells to heap ans sorts based on lower FScore
-	OpenSet.HeapPush(StartCell, [&FScore](const FCellRef& A, const FCellRef& B) {
-		return FScore[A] < FScore[B]; 
-	});
-
-	//Loop until we finally reach the target i.e. the bot catches the main character
-	while (OpenSet.Num() > 0)
+	FCellRef StartCell = Grid->GetCellRef(StartPoint);
+	if (GACore::FindPath(Grid->GetCoreGrid(), StartCell.X, StartCell.Y, DestinationCell.X, DestinationCell.Y, Scratch, PathIndices, &Stats))
 	{
-		FCellRef Current;
-		OpenSet.HeapPop(Current, [&FScore](const FCellRef& A, const FCellRef& B) {
-			return FScore[A] < FScore[B]; 
-		});
-
-		//If we find the destination, we need to end our A* algorithm and reconstruct this path from the start cell to the destination cell.
-		if (Current == DestinationCell)
+		// Empty if we're already in the destination cell
+		TArray<FCellRef, TInlineAllocator<64>> Path;
+		Path.Reserve(int32(PathIndices.size()));
+		for (int32_t Index : PathIndices)
 		{
-			
-			ReconstructPath(CameFrom, Current,Grid, StepsOut);
-			return GAPS_Active;
+			Path.Add(FCellRef(Index % Grid->XCount, Index / Grid->XCount));
 		}
 
-		//Until we find destination, we need to explore the neighbors of the current cell. We explore cell as long as it isnt out of bounds or a non traversable cell (wall/box)
-		TArray<FCellRef> Neighbors = GetNeighbors(Current);
-		for (const FCellRef& Neighbor : Neighbors)
-		{
-			ECellData Flags = Grid->GetCellData(Neighbor);
-
-			if (!EnumHasAllFlags(Flags, ECellData::CellDataTraversable) || !Grid->IsCellRefInBounds(Neighbor))
-			{
-				continue; 
-			}
-			float TentativeGScore = GScore[Current] + 1; 
+		TArray<FVector> WorldLocations;
+		Grid->GetCellPositions(Path, WorldLocations);
 
-			if (!GScore.Contains(Neighbor) || TentativeGScore < GScore[Neighbor])
-			{
-				CameFrom.Add(Neighbor, Current);
-				GScore.Add(Neighbor, TentativeGScore);
-				//FScore = GScore + H
-				FScore.Add(Neighbor, TentativeGScore + Heuristic(Neighbor, DestinationCell));
-
-				if (!OpenSet.Contains(Neighbor))
-				{
-					OpenSet.HeapPush(Neighbor, [&FScore](const FCellRef& A, const FCellRef& B) {
-						return FScore[A] < FScore[B];
-					});
-				}
-			}
+		StepsOut.SetNum(Path.Num());
+		for (int32 StepIndex = 0; StepIndex < Path.Num(); StepIndex++)
+		{
+			StepsOut[StepIndex].Set(WorldLocations[StepIndex], Path[StepIndex]);
 		}
-
+		return GAPS_Active;
 	}
 
-	
-
-	// Assignment 2 Part3: replace this with an A* search!
-	// HINT 1: you made need a heap structure. A TArray can be accessed as a heap -- just add/remove elements using
-	// the TArray::HeapPush() and TArray::HeapPop() methods.
-	// Note that whatever you push or pop needs to implement the 'less than' operator (operator<)
-	// HINT 2: UE has some useful flag testing function. For example you can test for traversability by doing this:
-	// ECellData Flags = Grid->GetCellData(CellRef);
-	// bool bIsCellTraversable = EnumHasAllFlags(Flags, ECellData::CellDataTraversable)
-
+	// No route: head straight for the destination, and let the next refresh try again
 	StepsOut.SetNum(1);
 	StepsOut[0].Set(Destination, DestinationCell);
 	
@@ -268,6 +268,10 @@ EGAPathState UGAPathComponent::AStar(const FVector& StartPoint, TArray<FPathStep
 
 bool LineTrace(const FVector& Start, const FVector& End, const AGAGridActor* Grid) 
 {
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_LineTrace);
+	TRACE_CPUPROFILER_EVENT_SCOPE(LineTrace);
+	INC_DWORD_STAT(STAT_GameAI_LineTraces);
+
 	if (!Grid)
 	{
 		return false; 
@@ -281,31 +285,19 @@ bool LineTrace(const FVector& Start, const FVector& End, const AGAGridActor* Gri
 		return true; 
 	}
 
-	
-	FVector Direction = End - Start;
-	const float Distance = Direction.Size();
-	Direction.Normalize();  
-
-	// Traverse from start cell in ditection of end cell with a step size of 10 units. 
-	for (float i = 0; i < Distance; i += 10)  
-	{
-		FVector CurrentPosition = Start + Direction * i;
-
-		FCellRef CurrentCell = Grid->GetCellRef(CurrentPosition);
-
-		ECellData Flags = Grid->GetCellData(CurrentCell);
-
-		if (!EnumHasAllFlags(Flags, ECellData::CellDataTraversable))
-		{
-			return true; 
-		}
-	}
-
-	return false;
+	// Walks every cell the segment crosses, in cell space, rather than sampling along it
+	const FVector2f A = Grid->GetCellSpacePosition(Start);
+	const FVector2f B = Grid->GetCellSpacePosition(End);
+	return !GACore::IsSegmentClear(Grid->GetCoreGrid(), A.X, A.Y, B.X, B.Y);
 }
 
 EGAPathState UGAPathComponent::SmoothPath(const FVector& StartPoint, const TArray<FPathStep>& UnsmoothedSteps, TArray<FPathStep>& SmoothedStepsOut) const
 {
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_SmoothPath);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGAPathComponent::SmoothPath);
+
+	int32 TraceCount = 0;
+	ON_SCOPE_EXIT { FGameAIStats::RecordLineTraces(TraceCount); };
 	
 	SmoothedStepsOut.Empty();
 
@@ -321,6 +313,7 @@ EGAPathState UGAPathComponent::SmoothPath(const FVector& StartPoint, const TArra
 	}
 
 	FPathStep CurrentStep =  UnsmoothedSteps[0];
+	TraceCount++;
 	if (!LineTrace(StartPoint, Grid->GetCellPosition(UnsmoothedSteps.Last().CellRef), Grid))
 	{
 		SmoothedStepsOut.Add(UnsmoothedSteps.Last());
@@ -344,6 +337,7 @@ EGAPathState UGAPathComponent::SmoothPath(const FVector& StartPoint, const TArra
 		{
 			FVector CurrentPosition = Grid->GetCellPosition(CurrentStep.CellRef);
 
+			TraceCount++;
 			if (LineTrace(CurrentPosition, Grid->GetCellPosition(UnsmoothedSteps[i].CellRef), Grid))
 			{
 				NextIndex = i - 1; 
@@ -362,6 +356,164 @@ EGAPathState UGAPathComponent::SmoothPath(const FVector& StartPoint, const TArra
 }
 
 
+/**
+ * Cheap per-tick path upkeep. The expensive part (RefreshPathFrom) only runs when ReplanPolicy says so.
+ * @param Position Where the pawn is now
+ * @param Now World time, in seconds
+ */
+EGAPathState UGAPathComponent::UpdatePathFrom(const FVector& Position, double Now)
+{
+	if (!bDestinationValid)
+	{
+		return State;
+	}
+
+	if (!ReplanPolicy.bEnabled)
+	{
+		ReplanStats.Refreshes++;
+		return RefreshPathFrom(Position);
+	}
+
+	if (AdvancePathFrom(Position))
+	{
+		return State;
+	}
+
+	const bool bCoolingDown = (Now - LastReplanTime) < ReplanPolicy.Cooldown;
+	bool bReplan = bReplanRequested || State != GAPS_Active || Steps.Num() == 0;
+
+	// The on-demand triggers aren't worth checking while we couldn't act on them anyway
+	if (!bReplan && !bCoolingDown)
+	{
+		if (FMath::PointDistToSegment(Position, SegmentStart, Steps[0].Point) > ReplanPolicy.DriftDistance)
+		{
+			ReplanStats.DriftTriggers++;
+			bReplan = true;
+		}
+		else if (Now - LastVisibilityCheckTime >= ReplanPolicy.VisibilityCheckInterval)
+		{
+			LastVisibilityCheckTime = Now;
+			if (LineTrace(Position, Steps[0].Point, GetGridActor()))
+			{
+				ReplanStats.VisibilityTriggers++;
+				bReplan = true;
+			}
+		}
+
+		if (!bReplan && ReplanPolicy.MaxInterval > 0.0f && Now - LastReplanTime >= ReplanPolicy.MaxInterval)
+		{
+			ReplanStats.IntervalTriggers++;
+			bReplan = true;
+		}
+	}
+
+	if (!bReplan)
+	{
+		ReplanStats.SkippedRefreshes++;
+		return State;
+	}
+
+	if (bCoolingDown)
+	{
+		// Keep it pending until the cooldown is over
+		bReplanRequested = true;
+		ReplanStats.CooldownDeferrals++;
+		ReplanStats.SkippedRefreshes++;
+		return State;
+	}
+
+	bReplanRequested = false;
+	LastReplanTime = Now;
+	ReplanStats.Refreshes++;
+	return RefreshPathFrom(Position);
+}
+
+bool UGAPathComponent::AdvancePathFrom(const FVector& Position)
+{
+	if (!bDestinationValid)
+	{
+		return false;
+	}
+
+	if (FVector::Dist(Position, Destination) <= ArrivalDistance)
+	{
+		State = GAPS_Finished;
+		return true;
+	}
+
+	// Reaching a waypoint doesn't need a replan, just move on to the next one
+	while (Steps.Num() > 1 && FVector::Dist2D(Position, Steps[0].Point) <= ArrivalDistance)
+	{
+		SegmentStart = Steps[0].Point;
+		Steps.RemoveAt(0);
+	}
+
+	return false;
+}
+
+void UGAPathComponent::RefreshPathBounds(const FVector& Position)
+{
+	const AGAGridActor* Grid = GetGridActor();
+	FCellRef AgentCell = Grid ? Grid->GetCellRef(Position, true) : FCellRef::Invalid;
+	if (!AgentCell.IsValid())
+	{
+		bHasPathBounds = false;
+		return;
+	}
+
+	PathBounds = FIntRect(AgentCell.X, AgentCell.Y, AgentCell.X, AgentCell.Y);
+	for (const FPathStep& Step : Steps)
+	{
+		FCellRef StepCell = Step.CellRef.IsValid() ? Step.CellRef : Grid->GetCellRef(Step.Point, true);
+		PathBounds.Include(FIntPoint(StepCell.X, StepCell.Y));
+	}
+	bHasPathBounds = true;
+}
+
+void UGAPathComponent::BindToGridChanges()
+{
+	const AGAGridActor* Grid = GetGridActor();
+	if (Grid == BoundGrid.Get())
+	{
+		return;
+	}
+
+	UnbindFromGridChanges();
+	if (Grid)
+	{
+		GridChangedHandle = Grid->OnCellsChanged.AddUObject(this, &UGAPathComponent::OnGridCellsChanged);
+		BoundGrid = Grid;
+	}
+}
+
+void UGAPathComponent::UnbindFromGridChanges()
+{
+	if (const AGAGridActor* Grid = BoundGrid.Get())
+	{
+		Grid->OnCellsChanged.Remove(GridChangedHandle);
+	}
+	GridChangedHandle.Reset();
+	BoundGrid = nullptr;
+}
+
+void UGAPathComponent::OnGridCellsChanged(const FIntRect& DirtyRect)
+{
+	if (!bDestinationValid || !bHasPathBounds || bReplanRequested)
+	{
+		return;
+	}
+
+	// Both rects are inclusive
+	int32 Margin = ReplanPolicy.GridChangeMargin;
+	if (DirtyRect.Min.X <= PathBounds.Max.X + Margin && DirtyRect.Max.X >= PathBounds.Min.X - Margin
+		&& DirtyRect.Min.Y <= PathBounds.Max.Y + Margin && DirtyRect.Max.Y >= PathBounds.Min.Y - Margin)
+	{
+		ReplanStats.GridChangeTriggers++;
+		bReplanRequested = true;
+	}
+}
+
+
 void UGAPathComponent::FollowPath()
 {
 	AActor* Owner = GetOwnerPawn();
@@ -386,20 +538,38 @@ void UGAPathComponent::FollowPath()
 
 EGAPathState UGAPathComponent::SetDestination(const FVector &DestinationPoint)
 {
+	const AGAGridActor* Grid = GetGridActor();
+	FCellRef CellRef = Grid ? Grid->GetCellRef(DestinationPoint) : FCellRef::Invalid;
+
+	// Small moves of an active destination don't warrant a new path
+	if (ReplanPolicy.bEnabled && bDestinationValid && State == GAPS_Active && CellRef.IsValid() && DestinationCell.IsValid()
+		&& FMath::Max(FMath::Abs(CellRef.X - DestinationCell.X), FMath::Abs(CellRef.Y - DestinationCell.Y)) <= ReplanPolicy.DestinationCellTolerance)
+	{
+		Destination = DestinationPoint;
+		ReplanStats.SkippedRefreshes++;
+		return State;
+	}
+
 	Destination = DestinationPoint;
 
 	State = GAPS_Invalid;
 	bDestinationValid = true;
 
-	const AGAGridActor* Grid = GetGridActor();
+	// The grid may not have been around at BeginPlay
+	BindToGridChanges();
+
 	if (Grid)
 	{
-		FCellRef CellRef = Grid->GetCellRef(Destination);
 		if (CellRef.IsValid())
 		{
 			DestinationCell = CellRef;
 			bDestinationValid = true;
 
+			ReplanStats.DestinationTriggers++;
+			ReplanStats.Refreshes++;
+			bReplanRequested = false;
+			LastReplanTime = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0;
+
 			RefreshPath();
 		}
 	}
@@ -407,6 +577,15 @@ EGAPathState UGAPathComponent::SetDestination(const FVector &DestinationPoint)
 	return State;
 }
 
+void UGAPathComponent::ClearDestination()
+{
+	bDestinationValid = false;
+	bReplanRequested = false;
+	bHasPathBounds = false;
+	State = GAPS_None;
+	Steps.Empty();
+}
+
 /**
  * Reconstructs path using the Distance Map obtained from Dijkstra's algorithm
  * @param DistanceMap Dijkstra's distance map
@@ -415,8 +594,10 @@ EGAPathState UGAPathComponent::SetDestination(const FVector &DestinationPoint)
  * @param StepsOut 
  * @param Grid 
  */
-void UGAPathComponent::ReconstructDijkstra(FGAGridMap DistanceMap, FCellRef& StartCell, FCellRef Current,  TArray<FPathStep>& StepsOut, const AGAGridActor* Grid) const
+void UGAPathComponent::ReconstructDijkstra(const FGAGridMap& DistanceMap, const FCellRef& StartCell, FCellRef Current,  TArray<FPathStep>& StepsOut, const AGAGridActor* Grid) const
 {
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_ReconstructDijkstra);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGAPathComponent::ReconstructDijkstra);
 
 
 	if (!Grid)
@@ -447,9 +628,8 @@ void UGAPathComponent::ReconstructDijkstra(FGAGridMap DistanceMap, FCellRef& Sta
 
 		for (const FCellRef& Neighbor : Neighbors)
 		{
-			ECellData Flags = Grid->GetCellData(Neighbor);
-
-			if (!EnumHasAllFlags(Flags, ECellData::CellDataTraversable) || !Grid->IsCellRefInBounds(Neighbor))
+			// Note: this also takes the dynamic overlay into account
+			if (!Grid->IsCellTraversable(Neighbor))
 			{
 				continue; 
 			}
@@ -485,14 +665,13 @@ void UGAPathComponent::ReconstructDijkstra(FGAGridMap DistanceMap, FCellRef& Sta
 	Path.Remove(Current);
 
 	//Get path from steps.
-	for (const FCellRef& Cell : Path)
-	{
-		FVector WorldLocation = Grid->GetCellPosition(Cell); 
+	TArray<FVector> WorldLocations;
+	Grid->GetCellPositions(Path, WorldLocations);
 
-		FPathStep Step;
-		Step.Set(WorldLocation, Cell); 
-		StepsOut.Add(Step);
-		
+	StepsOut.SetNum(Path.Num());
+	for (int32 StepIndex = 0; StepIndex < Path.Num(); StepIndex++)
+	{
+		StepsOut[StepIndex].Set(WorldLocations[StepIndex], Path[StepIndex]);
 	}
 }
 
@@ -505,58 +684,143 @@ void UGAPathComponent::ReconstructDijkstra(FGAGridMap DistanceMap, FCellRef& Sta
  */
 bool UGAPathComponent::Dijkstra(const FVector &StartPoint, FGAGridMap &DistanceMapOut,const  AGAGridActor* Grid) const
 {
-	
-    
-	
-	// Min heap comparator
-	auto Comparator = [&DistanceMapOut](const FCellRef& A, const FCellRef& B) {
-		float valA, valB;
-		DistanceMapOut.GetValue(A, valA);
-		DistanceMapOut.GetValue(B, valB);
-		return valA > valB; 
-	};
-	
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_Dijkstra);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGAPathComponent::Dijkstra);
+
+	GACore::FSearchStats Stats;
+	ON_SCOPE_EXIT { FGameAIStats::RecordSearch(Stats.NodesExpanded, Stats.HeapPushes); };
+
+	// Only the heap is used, but it's worth keeping warm: this runs for every tactical query layer
+	static thread_local GACore::FSearchScratch Scratch;
+
+	// The distance map covers GridBounds, which doesn't have to be the whole grid
+	const FGridBox& Bounds = DistanceMapOut.GridBounds;
+	GACore::FGridWindow Window(Bounds.MinX, Bounds.MinY, Bounds.MaxX - Bounds.MinX + 1, Bounds.MaxY - Bounds.MinY + 1);
+	check(DistanceMapOut.Data.Num() == Window.GetCellCount());
+
 	FCellRef StartCell = Grid->GetCellRef(StartPoint);
-	
-	TArray<FCellRef> OpenSet;
-	
-	DistanceMapOut.SetValue(StartCell,0);
-	
-	OpenSet.HeapPush(StartCell, Comparator);
-	while (OpenSet.Num() > 0)
+	return GACore::FloodDistances(Grid->GetCoreGrid(), StartCell.X, StartCell.Y, Window, DistanceMapOut.Data.GetData(), Scratch, &Stats);
+}
+
+
+float FGADijkstraResult::GetDistance(const FCellRef& CellRef) const
+{
+	float Distance = INFINITY;
+	if (DistanceMap.IsSet())
 	{
-		FCellRef Current;
-		OpenSet.HeapPop(Current, Comparator);
-		float currValue;
-		DistanceMapOut.GetValue(Current, currValue);
+		DistanceMap->GetValue(CellRef, Distance);
+	}
+	return Distance;
+}
 
-		//Get neighbours
-		TArray<FCellRef> Neighbors = GetNeighbors(Current);
+/**
+ * Bounded Dijkstra using a Dial bucket queue. Since step costs are small integers, the open list can be an
+ * array of buckets indexed by distance, and we just sweep the buckets in order -- no heap at all.
+ * Cells can still end up in a later bucket more than once if a cheaper route turns up; those stale entries
+ * are skipped when their bucket comes around.
+ * @param StartCell Where to flood from
+ * @param Grid 
+ * @param ResultOut Distances, predecessors and stats
+ * @param MaxDistance Don't go further than this (<= 0 for no limit)
+ * @param MaxNodes Stop after settling this many cells (<= 0 for no limit)
+ * @return false if the start cell isn't traversable
+ */
+bool UGAPathComponent::DijkstraBounded(const FCellRef& StartCell, const AGAGridActor* Grid, FGADijkstraResult& ResultOut, int32 MaxDistance, int32 MaxNodes) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_DijkstraBounded);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGAPathComponent::DijkstraBounded);
 
-		for (const FCellRef& Neighbor : Neighbors)
-		{
-			
-			ECellData Flags = Grid->GetCellData(Neighbor);
+	// Bucket pushes stand in for heap pushes here
+	int32 BucketPushes = 0;
+	ON_SCOPE_EXIT { FGameAIStats::RecordSearch(ResultOut.NodesSettled, BucketPushes); };
 
-			if (!EnumHasAllFlags(Flags, ECellData::CellDataTraversable) || !Grid->IsCellRefInBounds(Neighbor))
-			{
-				continue; 
-			}
+	ResultOut.StartCell = StartCell;
+	ResultOut.NodesSettled = 0;
+	ResultOut.bHitNodeLimit = false;
 
-			float neighValue;
-			DistanceMapOut.GetValue(Neighbor, neighValue);
+	if (!Grid || !Grid->IsCellTraversable(StartCell))
+	{
+		ResultOut.DistanceMap.Release();
+		return false;
+	}
 
-			float newDistance = currValue + 1;
+	// Every step costs at least 1, so nothing further than MaxDistance cells away (Manhattan) can be reached
+	FGridBox Box(0, Grid->XCount - 1, 0, Grid->YCount - 1);
+	if (MaxDistance > 0)
+	{
+		Box = FGridBox(
+			FMath::Max(StartCell.X - MaxDistance, 0), FMath::Min(StartCell.X + MaxDistance, Grid->XCount - 1),
+			FMath::Max(StartCell.Y - MaxDistance, 0), FMath::Min(StartCell.Y + MaxDistance, Grid->YCount - 1));
+	}
 
-			// Check if neighbor has been visited or if the new distance is shorter
-			if (neighValue == INFINITY || newDistance < neighValue)
-			{
-				DistanceMapOut.SetValue(Neighbor, newDistance);
-				OpenSet.HeapPush(Neighbor, Comparator);
-			}
-		}
-		
+	int32 Width = Box.MaxX - Box.MinX + 1;
+	int32 Height = Box.MaxY - Box.MinY + 1;
+
+	ResultOut.DistanceMap = FGAGridMapPool::Get().Acquire(Box, INFINITY);
+	float* Distances = ResultOut.DistanceMap->Data.GetData();
+
+	// Filled in by the search, INDEX_NONE included
+	TArray<int32>& Predecessors = ResultOut.Predecessors;
+	Predecessors.SetNumUninitialized(Width * Height, EAllowShrinking::No);
+
+	// Per thread, like AStar's: this gets called on the CDO from worker tasks
+	static thread_local GACore::FBucketQueue Queue;
+
+	GACore::FBoundedFloodStats Stats;
+	GACore::FloodDistancesBounded(Grid->GetCoreGrid(), StartCell.X, StartCell.Y, GACore::FGridWindow(Box.MinX, Box.MinY, Width, Height),
+		MaxDistance, MaxNodes, Distances, Predecessors.GetData(), Queue, Stats);
+
+	ResultOut.NodesSettled = Stats.NodesSettled;
+	ResultOut.bHitNodeLimit = Stats.bHitNodeLimit;
+	BucketPushes = Stats.BucketPushes;
+
+	return true;
+}
+
+/**
+ * Builds the path from the start of a DijkstraBounded search to Goal by following predecessors.
+ * @param Result A finished DijkstraBounded search
+ * @param Goal Where we want to go
+ * @param StepsOut The path, not including the start cell
+ * @param Grid 
+ * @return false if Goal wasn't reached by the search
+ */
+bool UGAPathComponent::ReconstructDijkstra(const FGADijkstraResult& Result, const FCellRef& Goal, TArray<FPathStep>& StepsOut, const AGAGridActor* Grid) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_ReconstructDijkstra);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGAPathComponent::ReconstructDijkstra);
+
+	StepsOut.Reset();
+
+	if (!Grid || !Result.IsValid() || !FGAGridMapOps::IsInBounds(*Result.DistanceMap, Goal))
+	{
+		return false;
+	}
+
+	const FGAGridMap& DistanceMap = *Result.DistanceMap;
+	int32 MapIndex = FGAGridMapOps::CellRefToIndex(DistanceMap, Goal);
+	if (DistanceMap.Data[MapIndex] == INFINITY)
+	{
+		return false;
+	}
+
+	// Walk back to the start, then flip
+	TArray<FCellRef> Path;
+	while (Result.Predecessors[MapIndex] != INDEX_NONE)
+	{
+		Path.Add(FGAGridMapOps::IndexToCellRef(DistanceMap, MapIndex));
+		MapIndex = Result.Predecessors[MapIndex];
+	}
+	Algo::Reverse(Path);
+
+	TArray<FVector> WorldLocations;
+	Grid->GetCellPositions(Path, WorldLocations);
+
+	StepsOut.SetNum(Path.Num());
+	for (int32 StepIndex = 0; StepIndex < Path.Num(); StepIndex++)
+	{
+		StepsOut[StepIndex].Set(WorldLocations[StepIndex], Path[StepIndex]);
 	}
 
 	return true;
-}
\ No newline at end of file
+}
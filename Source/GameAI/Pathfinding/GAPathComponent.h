@@ -3,6 +3,8 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "GameAI/Grid/GAGridActor.h"
+#include "GameAI/Grid/GAGridMapPool.h"
+#include "GACoreSearch.h"
 #include "GAPathComponent.generated.h"
 
 
@@ -27,6 +29,31 @@ struct FPathStep
 	FCellRef CellRef;
 };
 
+// Output of UGAPathComponent::DijkstraBounded.
+// Keep one of these around and pass it back in to reuse its buffers.
+struct FGADijkstraResult
+{
+	// Distances from StartCell, over the box the search could possibly reach. Unreached cells are INFINITY
+	FGAPooledGridMap DistanceMap;
+
+	// For each cell of DistanceMap (same indexing), the map index of the cell we came from.
+	// INDEX_NONE for the start cell and for unreached cells
+	TArray<int32> Predecessors;
+
+	FCellRef StartCell;
+
+	// How many cells had their final distance fixed
+	int32 NodesSettled = 0;
+
+	// True if the search stopped because of MaxNodes rather than running out of cells
+	bool bHitNodeLimit = false;
+
+	bool IsValid() const { return DistanceMap.IsSet() && StartCell.IsValid(); }
+
+	// INFINITY if the cell wasn't reached
+	float GetDistance(const FCellRef& CellRef) const;
+};
+
 // Note the UMeta -- DisplayName is just a nice way to show the name in the editor
 UENUM(BlueprintType)
 enum EGAPathState
@@ -38,6 +65,79 @@ enum EGAPathState
 };
 
 
+// When a path component bothers to refresh its path. Anything not listed here only costs a few distance checks
+USTRUCT(BlueprintType)
+struct FGAReplanPolicy
+{
+	GENERATED_BODY()
+
+	FGAReplanPolicy()
+		: bEnabled(true), DestinationCellTolerance(0), GridChangeMargin(2), DriftDistance(150.0f),
+		  VisibilityCheckInterval(0.25f), Cooldown(0.2f), MaxInterval(0.0f) {}
+
+	// If false, the path is refreshed every tick, like it used to be
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bEnabled;
+
+	// Replan when the destination moves more than this many cells (0: to any other cell)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 DestinationCellTolerance;
+
+	// Replan when the grid changes within this many cells of the path's bounding box
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 GridChangeMargin;
+
+	// Replan when the agent is further than this (world units) from the segment it's following
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float DriftDistance;
+
+	// How often (seconds) to check that the next waypoint is still visible. 0 checks every tick
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float VisibilityCheckInterval;
+
+	// Minimum seconds between two replans. Triggers that fire during the cooldown wait for it to end
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Cooldown;
+
+	// Replan at least this often even without a trigger. 0 means never
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float MaxInterval;
+};
+
+// Why paths were (or weren't) refreshed, since the component started
+USTRUCT(BlueprintType)
+struct FGAReplanStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Refreshes = 0;
+
+	// Ticks that would have refreshed unconditionally before the policy existed
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 SkippedRefreshes = 0;
+
+	// Refreshes held back by the cooldown
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 CooldownDeferrals = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 DestinationTriggers = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 GridChangeTriggers = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 DriftTriggers = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 VisibilityTriggers = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 IntervalTriggers = 0;
+};
+
+
 // Our custom path following component, which will rely on the data
 // contained in the GridActor
 // Note the meta-specific "BlueprintSpawnableComponnet". This will allow us
@@ -56,6 +156,9 @@ class UGAPathComponent : public UActorComponent
 	UFUNCTION(BlueprintCallable)
 	const AGAGridActor *GetGridActor() const;
 
+	// Same lookup, for callers that write to the grid (debug maps and the like)
+	AGAGridActor *GetMutableGridActor();
+
 	// It is super easy to forget: this component will usually be attached to the CONTROLLER, not the pawn it's controlling
 	// A lot of times we want access to the pawn (e.g. when sending signals to its movement component).
 	UFUNCTION(BlueprintCallable, BlueprintPure)
@@ -64,15 +167,53 @@ class UGAPathComponent : public UActorComponent
 
 	// State Update ------------------------
 
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
+	// If true, path following is driven by UGAPathFollowingSubsystem along with every other agent, rather than
+	// by this component's own tick (which stays on only if a Blueprint subclass implements Tick)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	bool bUseTickManager;
+
 	EGAPathState RefreshPath();
 
+	// RefreshPath, for a caller that already knows where the pawn is. Doesn't touch the pawn, so the tick
+	// manager can run it off the game thread
+	EGAPathState RefreshPathFrom(const FVector& StartPoint);
+
+	// Per-tick update: checks for arrival, advances past reached waypoints, and refreshes the path only if
+	// ReplanPolicy says something relevant changed. Like RefreshPathFrom, safe off the game thread
+	EGAPathState UpdatePathFrom(const FVector& Position, double Now);
+
+	// The cheap part of UpdatePathFrom: arrival and moving on past reached waypoints, never a search. The tick
+	// manager runs this every frame for agents whose LOD tier isn't due a full update. Returns true once arrived
+	bool AdvancePathFrom(const FVector& Position);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FGAReplanPolicy ReplanPolicy;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FGAReplanStats ReplanStats;
+
+	// Level of detail tier assigned by UGAAILODSubsystem, when driven by the tick manager. INDEX_NONE otherwise
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 LODTier;
+
 	EGAPathState AStar(const FVector& StartPoint, TArray<FPathStep>& StepsOut) const;
 
 	EGAPathState SmoothPath(const FVector& StartPoint, const TArray<FPathStep>& UnsmoothedSteps, TArray<FPathStep>& SmoothedStepsOut) const;
 	bool Dijkstra(const FVector &StartPoint, FGAGridMap &DistanceMapOut, const AGAGridActor* Grid) const;
-	void ReconstructDijkstra(FGAGridMap DistanceMap, FCellRef& StartCell, FCellRef Current,  TArray<FPathStep>& StepsOut,  const AGAGridActor* Grid) const;
+	void ReconstructDijkstra(const FGAGridMap& DistanceMap, const FCellRef& StartCell, FCellRef Current,  TArray<FPathStep>& StepsOut,  const AGAGridActor* Grid) const;
+
+	// Dijkstra with a Dial bucket queue. Step costs are rounded to integers (at least 1).
+	// Stops expanding past MaxDistance and after MaxNodes cells have been settled (<= 0 means no limit), and only
+	// allocates a map big enough for the cells within MaxDistance. Maps come from FGAGridMapPool.
+	bool DijkstraBounded(const FCellRef& StartCell, const AGAGridActor* Grid, FGADijkstraResult& ResultOut, int32 MaxDistance = 0, int32 MaxNodes = 0) const;
+
+	// Follows the stored predecessors back from Goal. O(path length)
+	bool ReconstructDijkstra(const FGADijkstraResult& Result, const FCellRef& Goal, TArray<FPathStep>& StepsOut, const AGAGridActor* Grid) const;
+
 	void FollowPath();
 	void SetSteps(TArray<FPathStep>& steps);
 	// Parameters ------------------------
@@ -86,6 +227,10 @@ class UGAPathComponent : public UActorComponent
 	UFUNCTION(BlueprintCallable)
 	EGAPathState SetDestination(const FVector &DestinationPoint);
 
+	// Stop following: forget the destination and the path
+	UFUNCTION(BlueprintCallable)
+	void ClearDestination();
+
 	UPROPERTY(BlueprintReadOnly)
 	bool bDestinationValid;
 
@@ -104,5 +249,31 @@ class UGAPathComponent : public UActorComponent
 	TArray<FPathStep> Steps;
 	void SetState();
 
+private:
+	// Registered with UGAPathFollowingSubsystem
+	bool bManagedByTickManager;
+
+	// Replan bookkeeping ------------------------
+
+	void BindToGridChanges();
+	void UnbindFromGridChanges();
+	void OnGridCellsChanged(const FIntRect& DirtyRect);
+	void RefreshPathBounds(const FVector& Position);
+
+	TWeakObjectPtr<const AGAGridActor> BoundGrid;
+	FDelegateHandle GridChangedHandle;
+
+	// Cells covered by the agent and its steps, as of the last refresh
+	FIntRect PathBounds;
+	bool bHasPathBounds;
+
+	// Where the current segment (towards Steps[0]) started
+	FVector SegmentStart;
+
+	// Set by the triggers that can't be checked on demand (destination, grid changes)
+	bool bReplanRequested;
+	double LastReplanTime;
+	double LastVisibilityCheckTime;
+
 
 };
\ No newline at end of file
@@ -0,0 +1,334 @@
+#include "GAPathFollowingSubsystem.h"
+
+#include "GAPathComponent.h"
+#include "GAAILOD.h"
+#include "GameAI/GameAIStats.h"
+#include "Kismet/GameplayStatics.h"
+#include "Async/ParallelFor.h"
+#include "GameFramework/NavMovementComponent.h"
+#include "GameFramework/Controller.h"
+
+
+TStatId UGAPathFollowingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGAPathFollowingSubsystem, STATGROUP_Tickables);
+}
+
+void UGAPathFollowingSubsystem::RegisterComponent(UGAPathComponent* Component)
+{
+	if (!Component || Components.Contains(Component))
+	{
+		return;
+	}
+
+	Components.Add(Component);
+	AgentIds.Add(NextAgentId);
+	NextAgentId = (NextAgentId == MAX_int32) ? 0 : NextAgentId + 1;
+	Pawns.AddDefaulted();
+	Controllers.Add(Cast<AController>(Component->GetOwner()));
+	MovementComponents.AddDefaulted();
+	Positions.Add(FVector::ZeroVector);
+	Velocities.Add(FVector::ZeroVector);
+	Waypoints.Add(FVector::ZeroVector);
+	MoveDirections.Add(FVector::ZeroVector);
+	PresentFlags.Add(0);
+	ActiveFlags.Add(0);
+	UpdateFlags.Add(0);
+	WaypointFlags.Add(0);
+	LODTiers.Add(INDEX_NONE);
+	NextUpdateTimes.Add(0.0);
+
+	ResolveAgent(Components.Num() - 1);
+}
+
+void UGAPathFollowingSubsystem::UnregisterComponent(UGAPathComponent* Component)
+{
+	int32 Index = Components.IndexOfByKey(Component);
+	if (Index != INDEX_NONE)
+	{
+		RemoveAgentAt(Index);
+	}
+}
+
+int32 UGAPathFollowingSubsystem::GetAgentId(const UGAPathComponent* Component) const
+{
+	int32 Index = Components.IndexOfByKey(Component);
+	return (Index != INDEX_NONE) ? AgentIds[Index] : INDEX_NONE;
+}
+
+void UGAPathFollowingSubsystem::RemoveAgentAt(int32 Index)
+{
+	// Swap-remove every array the same way so the slots stay lined up
+	Components.RemoveAtSwap(Index);
+	AgentIds.RemoveAtSwap(Index);
+	Pawns.RemoveAtSwap(Index);
+	Controllers.RemoveAtSwap(Index);
+	MovementComponents.RemoveAtSwap(Index);
+	Positions.RemoveAtSwap(Index);
+	Velocities.RemoveAtSwap(Index);
+	Waypoints.RemoveAtSwap(Index);
+	MoveDirections.RemoveAtSwap(Index);
+	PresentFlags.RemoveAtSwap(Index);
+	ActiveFlags.RemoveAtSwap(Index);
+	UpdateFlags.RemoveAtSwap(Index);
+	WaypointFlags.RemoveAtSwap(Index);
+	LODTiers.RemoveAtSwap(Index);
+	NextUpdateTimes.RemoveAtSwap(Index);
+}
+
+bool UGAPathFollowingSubsystem::ResolveAgent(int32 Index)
+{
+	UGAPathComponent* Component = Components[Index].Get();
+	if (!Component)
+	{
+		return false;
+	}
+
+	// A pawn owner never changes, so it's only looked up again if it goes away. A controller can possess a
+	// different pawn at any time, so that's re-read every tick. The component lookup only happens when the pawn
+	// actually changed
+	APawn* Pawn = Pawns[Index].Get();
+	if (AController* Controller = Controllers[Index].Get())
+	{
+		Pawn = Controller->GetPawn();
+	}
+	else if (!Pawn)
+	{
+		Pawn = Component->GetOwnerPawn();
+	}
+
+	if (Pawn != Pawns[Index].Get())
+	{
+		Pawns[Index] = Pawn;
+		MovementComponents[Index] = Pawn ? Pawn->FindComponentByClass<UNavMovementComponent>() : nullptr;
+	}
+
+	return Pawn != nullptr;
+}
+
+void UGAPathFollowingSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_PathFollowingTick);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGAPathFollowingSubsystem::Tick);
+
+	Super::Tick(DeltaTime);
+
+	// Gather, on the game thread
+	const AGAGridActor* Grid = nullptr;
+	for (int32 Index = Components.Num() - 1; Index >= 0; Index--)
+	{
+		UGAPathComponent* Component = Components[Index].Get();
+		if (!Component)
+		{
+			RemoveAgentAt(Index);
+			continue;
+		}
+
+		// Agents without a destination still take up space, so everyone with a pawn gets a position
+		PresentFlags[Index] = ResolveAgent(Index);
+		if (PresentFlags[Index])
+		{
+			Positions[Index] = Pawns[Index]->GetActorLocation();
+			Velocities[Index] = Pawns[Index]->GetVelocity();
+		}
+
+		// Also makes sure the grid actor is cached before the workers ask for it
+		const AGAGridActor* ComponentGrid = Component->GetGridActor();
+		Grid = Grid ? Grid : ComponentGrid;
+		ActiveFlags[Index] = Component->bDestinationValid && ComponentGrid && PresentFlags[Index];
+
+		// Steps can change outside of our updates (SetDestination, SetSteps), so re-read the waypoint every frame
+		WaypointFlags[Index] = ActiveFlags[Index] && Component->State == GAPS_Active && Component->Steps.Num() > 0;
+		if (WaypointFlags[Index])
+		{
+			Waypoints[Index] = Component->Steps[0].Point;
+		}
+	}
+
+	if (Steering.bEnabled)
+	{
+		AgentHash.Build(Grid, Positions, PresentFlags, Steering.BucketCells);
+	}
+	else
+	{
+		AgentHash.Reset();
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	SelectAgentsToUpdate(Now);
+
+	// Update and steer. Each agent only touches its own component and slot
+	auto UpdateAgent = [this, Now](int32 Index)
+	{
+		MoveDirections[Index] = FVector::ZeroVector;
+		if (!ActiveFlags[Index])
+		{
+			return;
+		}
+
+		// Arrival and waypoints are checked every frame. Only the replan checks wait for the agent's LOD turn
+		UGAPathComponent* Component = Components[Index].Get();
+		if (UpdateFlags[Index])
+		{
+			Component->UpdatePathFrom(Positions[Index], Now);
+		}
+		else
+		{
+			Component->AdvancePathFrom(Positions[Index]);
+		}
+
+		WaypointFlags[Index] = (Component->State == GAPS_Active && Component->Steps.Num() > 0);
+		if (WaypointFlags[Index])
+		{
+			Waypoints[Index] = Component->Steps[0].Point;
+		}
+
+		if (WaypointFlags[Index])
+		{
+			MoveDirections[Index] = ApplySteering(Index, (Waypoints[Index] - Positions[Index]).GetSafeNormal());
+		}
+	};
+
+	const bool bParallel = ParallelAgentThreshold > 0 && Components.Num() >= ParallelAgentThreshold;
+	ParallelFor(Components.Num(), UpdateAgent, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+	// Apply, on the game thread
+	for (int32 Index = 0; Index < Components.Num(); Index++)
+	{
+		if (!ActiveFlags[Index] || MoveDirections[Index].IsZero())
+		{
+			continue;
+		}
+
+		if (UNavMovementComponent* MovementComponent = MovementComponents[Index].Get())
+		{
+			MovementComponent->RequestPathMove(MoveDirections[Index]);
+		}
+	}
+}
+
+void UGAPathFollowingSubsystem::SelectAgentsToUpdate(double Now)
+{
+	const UGAAILODSubsystem* LOD = GetWorld()->GetSubsystem<UGAAILODSubsystem>();
+	const APawn* Player = UGameplayStatics::GetPlayerPawn(this, 0);
+
+	// Without LOD (or a player to measure from), everyone updates every frame
+	if (!LOD || !Player)
+	{
+		for (int32 Index = 0; Index < Components.Num(); Index++)
+		{
+			UpdateFlags[Index] = ActiveFlags[Index];
+		}
+		return;
+	}
+
+	const FVector PlayerLocation = Player->GetActorLocation();
+	DueAgents.Reset();
+
+	for (int32 Index = 0; Index < Components.Num(); Index++)
+	{
+		UpdateFlags[Index] = 0;
+		if (!ActiveFlags[Index])
+		{
+			continue;
+		}
+
+		const APawn* Pawn = Pawns[Index].Get();
+		int32 Tier = LOD->ComputeTier(Positions[Index], Pawn->WasRecentlyRendered(0.2f), PlayerLocation);
+		if (Tier != LODTiers[Index])
+		{
+			// Don't let a promotion wait out the old, longer interval
+			NextUpdateTimes[Index] = FMath::Min(NextUpdateTimes[Index], LOD->GetStaggeredStartTime(AgentIds[Index], Tier, Now));
+			LODTiers[Index] = Tier;
+			Components[Index]->LODTier = Tier;
+		}
+
+		if (Now >= NextUpdateTimes[Index])
+		{
+			DueAgents.Add(Index);
+		}
+	}
+
+	// Over budget: the most overdue go first, the rest wait for a later frame
+	if (LOD->MaxUpdatesPerFrame > 0 && DueAgents.Num() > LOD->MaxUpdatesPerFrame)
+	{
+		DueAgents.Sort([this](int32 A, int32 B) { return NextUpdateTimes[A] < NextUpdateTimes[B]; });
+		DueAgents.SetNum(LOD->MaxUpdatesPerFrame, EAllowShrinking::No);
+	}
+
+	for (int32 Index : DueAgents)
+	{
+		UpdateFlags[Index] = 1;
+		NextUpdateTimes[Index] = Now + LOD->GetTier(LODTiers[Index]).UpdateInterval;
+	}
+}
+
+FVector UGAPathFollowingSubsystem::ApplySteering(int32 Index, const FVector& DesiredDirection) const
+{
+	if (!Steering.bEnabled || AgentHash.Num() <= 1 || DesiredDirection.IsZero())
+	{
+		return DesiredDirection;
+	}
+
+	FGANeighbourList Neighbours;
+	AgentHash.QueryNearest(Positions[Index], Steering.MaxNeighbours, Steering.NeighbourRadius, Neighbours, Index);
+
+	const FVector Position = Positions[Index];
+	const FVector Velocity = Velocities[Index];
+	const float CombinedRadius = 2.0f * Steering.AgentRadius;
+	FVector Separation = FVector::ZeroVector;
+	FVector Avoidance = FVector::ZeroVector;
+
+	for (int32 Other : Neighbours)
+	{
+		// Separation: linear falloff to zero at the edge of the neighbourhood
+		FVector Offset = Position - Positions[Other];
+		Offset.Z = 0.0f;
+		float Distance = Offset.Size();
+		if (Distance < KINDA_SMALL_NUMBER)
+		{
+			// Exactly on top of each other. Split them apart along an axis both agree on
+			Offset = (Index < Other) ? FVector(1.0f, 0.0f, 0.0f) : FVector(-1.0f, 0.0f, 0.0f);
+			Distance = 1.0f;
+		}
+		Separation += (Offset / Distance) * (1.0f - FMath::Min(Distance / Steering.NeighbourRadius, 1.0f));
+
+		// Avoidance: where will the neighbour be, relative to us, at the time of closest approach?
+		FVector RelativePosition = Positions[Other] - Position;
+		FVector RelativeVelocity = Velocity - Velocities[Other];
+		RelativePosition.Z = 0.0f;
+		RelativeVelocity.Z = 0.0f;
+
+		float SpeedSquared = RelativeVelocity.SizeSquared();
+		if (SpeedSquared < KINDA_SMALL_NUMBER)
+		{
+			continue;
+		}
+
+		float TimeToClosest = (RelativePosition | RelativeVelocity) / SpeedSquared;
+		if (TimeToClosest <= 0.0f || TimeToClosest > Steering.AvoidanceTimeHorizon)
+		{
+			continue;
+		}
+
+		FVector ClosestOffset = RelativePosition - RelativeVelocity * TimeToClosest;
+		float ClosestDistance = ClosestOffset.Size();
+		if (ClosestDistance < CombinedRadius)
+		{
+			// Sidestep away from where they'll be, harder the sooner it happens. Dead-on collisions pick a side
+			FVector Away = (ClosestDistance > KINDA_SMALL_NUMBER) ? -ClosestOffset / ClosestDistance : FVector(-RelativeVelocity.Y, RelativeVelocity.X, 0.0f).GetSafeNormal();
+			Avoidance += Away * (1.0f - TimeToClosest / Steering.AvoidanceTimeHorizon);
+		}
+	}
+
+	FVector Result = DesiredDirection + Separation * Steering.SeparationWeight + Avoidance * Steering.AvoidanceWeight;
+	Result.Z = DesiredDirection.Z;
+
+	// Never let the crowd turn us completely around
+	if ((Result | DesiredDirection) <= 0.0f)
+	{
+		return DesiredDirection;
+	}
+
+	return Result.GetSafeNormal();
+}
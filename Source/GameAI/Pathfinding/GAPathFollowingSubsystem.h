@@ -0,0 +1,130 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GAAgentSpatialHash.h"
+#include "GAPathFollowingSubsystem.generated.h"
+
+class UGAPathComponent;
+class UNavMovementComponent;
+class AController;
+
+
+// Local avoidance applied on top of path following, so agents chasing the same target don't pile up
+USTRUCT(BlueprintType)
+struct FGASteeringSettings
+{
+	GENERATED_BODY()
+
+	FGASteeringSettings()
+		: bEnabled(true), NeighbourRadius(250.0f), MaxNeighbours(8), SeparationWeight(1.0f), AgentRadius(50.0f),
+		  AvoidanceTimeHorizon(0.75f), AvoidanceWeight(0.75f), BucketCells(2) {}
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bEnabled;
+
+	// Only agents this close (world units) are considered at all
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float NeighbourRadius;
+
+	// Nearest neighbours considered per agent
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MaxNeighbours;
+
+	// Push away from neighbours, stronger the closer they are
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float SeparationWeight;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AgentRadius;
+
+	// Look this many seconds ahead for neighbours we're on course to hit, and sidestep them
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AvoidanceTimeHorizon;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AvoidanceWeight;
+
+	// Spatial hash bucket size, in grid cells
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 BucketCells;
+};
+
+
+// Drives every registered UGAPathComponent from one tick, instead of one tick function per component.
+//
+// Per-agent state lives in parallel arrays (structure of arrays) indexed by agent slot, so the hot loops walk
+// contiguous memory. Each tick:
+//   1. Gather (game thread): owner pawn positions and current waypoints. The pawn (or, for components on a
+//      controller, the controller) is cached at registration. A controller's pawn is re-read every tick since it
+//      can possess another one at any time, and the movement component is only looked up again when the pawn changes.
+//   2. Update and steer (parallel if enabled): advance each active path, replanning only when its policy says
+//      so, and work out the move direction.
+//      This only reads the grid and writes the agent's own component and slot.
+//   3. Apply (game thread): hand the directions to the movement components.
+//
+// Between 1 and 2, every agent with a pawn goes into a grid-aligned spatial hash, and step 2 adds separation and
+// predictive avoidance against each agent's nearest neighbours, so the whole crowd costs O(agents * neighbours).
+//
+// If there's a UGAAILODSubsystem, step 2 only runs the full update (with its replan checks) for agents that are due
+// according to their LOD tier, within the per-frame budget. Every other active agent still checks for arrival and
+// moves on past reached waypoints each frame (UGAPathComponent::AdvancePathFrom); only the replanning is staggered.
+UCLASS()
+class UGAPathFollowingSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterComponent(UGAPathComponent* Component);
+	void UnregisterComponent(UGAPathComponent* Component);
+
+	int32 GetAgentCount() const { return Components.Num(); }
+
+	// Assigned at registration and kept until the agent unregisters, unlike its slot, which moves whenever
+	// another agent leaves. INDEX_NONE if the component isn't registered
+	int32 GetAgentId(const UGAPathComponent* Component) const;
+
+	// Run the refresh/steer step across worker threads once there are at least this many agents.
+	// 0 disables parallelism
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 ParallelAgentThreshold = 16;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FGASteeringSettings Steering;
+
+	// Rebuilt every tick from the registered agents. Indices are agent slots
+	const FGAAgentSpatialHash& GetAgentHash() const { return AgentHash; }
+
+protected:
+	void RemoveAgentAt(int32 Index);
+	void SelectAgentsToUpdate(double Now);
+	bool ResolveAgent(int32 Index);
+	FVector ApplySteering(int32 Index, const FVector& DesiredDirection) const;
+
+	// Agent state, one slot per registered component
+	TArray<TWeakObjectPtr<UGAPathComponent>> Components;
+	TArray<int32> AgentIds;
+	TArray<TWeakObjectPtr<APawn>> Pawns;
+	TArray<TWeakObjectPtr<AController>> Controllers;
+	TArray<TWeakObjectPtr<UNavMovementComponent>> MovementComponents;
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+	TArray<FVector> Waypoints;
+	TArray<FVector> MoveDirections;
+	TArray<uint8> PresentFlags;
+	TArray<uint8> ActiveFlags;
+	TArray<uint8> UpdateFlags;
+	TArray<uint8> WaypointFlags;
+	TArray<int32> LODTiers;
+	TArray<double> NextUpdateTimes;
+
+	FGAAgentSpatialHash AgentHash;
+
+	int32 NextAgentId = 0;
+
+	// Scratch for the per-frame budget
+	TArray<int32> DueAgents;
+};
@@ -10,6 +10,9 @@
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputActionValue.h"
+#include "GameAI/Combat/GAProjectile.h"
+#include "GameAI/Combat/GAProjectilePool.h"
+#include "GameAI/Spatial/GAInfluenceMap.h"
 
 DEFINE_LOG_CATEGORY(LogTemplatePlayer);
 
@@ -52,6 +55,14 @@ AGAPlayerCharacter::AGAPlayerCharacter()
 
 	// Note: The skeletal mesh and anim blueprint references on the Mesh component (inherited from Character) 
 	// are set in the derived blueprint asset named ThirdPersonCharacter (to avoid direct content references in C++)
+
+	// Combat
+	ProjectileClass = AGAProjectile::StaticClass();
+	MuzzleOffset = FVector(100.0f, 0.0f, 50.0f);
+	FireInterval = 0.15f;
+	ProjectilePrewarmCount = 32;
+	LastFireTime = -BIG_NUMBER;
+	InfluenceStrength = 1.0f;
 }
 
 void AGAPlayerCharacter::BeginPlay()
@@ -67,6 +78,30 @@ void AGAPlayerCharacter::BeginPlay()
 			Subsystem->AddMappingContext(DefaultMappingContext, 0);
 		}
 	}
+
+	// Fill the projectile pool now, rather than spawning during the first firefight
+	if (UGAProjectilePoolSubsystem* Pool = GetWorld()->GetSubsystem<UGAProjectilePoolSubsystem>())
+	{
+		Pool->Prewarm(ProjectileClass, ProjectilePrewarmCount);
+	}
+
+	if (InfluenceStrength > 0.0f)
+	{
+		if (UGAInfluenceMapSubsystem* InfluenceMap = GetWorld()->GetSubsystem<UGAInfluenceMapSubsystem>())
+		{
+			InfluenceMap->RegisterSource(this, GAIC_Player, InfluenceStrength);
+		}
+	}
+}
+
+void AGAPlayerCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UGAInfluenceMapSubsystem* InfluenceMap = GetWorld()->GetSubsystem<UGAInfluenceMapSubsystem>())
+	{
+		InfluenceMap->UnregisterSource(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -86,6 +121,12 @@ void AGAPlayerCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputC
 
 		// Looking
 		EnhancedInputComponent->BindAction(LookAction, ETriggerEvent::Triggered, this, &AGAPlayerCharacter::Look);
+
+		// Firing
+		if (FireAction)
+		{
+			EnhancedInputComponent->BindAction(FireAction, ETriggerEvent::Triggered, this, &AGAPlayerCharacter::FireInput);
+		}
 	}
 	else
 	{
@@ -127,4 +168,30 @@ void AGAPlayerCharacter::Look(const FInputActionValue& Value)
 		AddControllerYawInput(LookAxisVector.X);
 		AddControllerPitchInput(LookAxisVector.Y);
 	}
-}
\ No newline at end of file
+}
+
+void AGAPlayerCharacter::FireInput(const FInputActionValue& Value)
+{
+	Fire();
+}
+
+AGAProjectile* AGAPlayerCharacter::Fire()
+{
+	UWorld* World = GetWorld();
+	UGAProjectilePoolSubsystem* Pool = World ? World->GetSubsystem<UGAProjectilePoolSubsystem>() : nullptr;
+	if (!Pool || World->GetTimeSeconds() - LastFireTime < FireInterval)
+	{
+		return nullptr;
+	}
+
+	// Aim where the camera is looking, from the muzzle
+	const FRotator AimRotation = Controller ? Controller->GetControlRotation() : GetActorRotation();
+	const FVector MuzzleLocation = GetActorLocation() + FRotator(0.0f, AimRotation.Yaw, 0.0f).RotateVector(MuzzleOffset);
+
+	AGAProjectile* Projectile = Pool->FireProjectile(ProjectileClass, MuzzleLocation, AimRotation, this, this);
+	if (Projectile)
+	{
+		LastFireTime = World->GetTimeSeconds();
+	}
+	return Projectile;
+}
@@ -11,6 +11,7 @@ class USpringArmComponent;
 class UCameraComponent;
 class UInputMappingContext;
 class UInputAction;
+class AGAProjectile;
 struct FInputActionValue;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogTemplatePlayer, Log, All);
@@ -44,8 +45,36 @@ class AGAPlayerCharacter : public ACharacter
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (AllowPrivateAccess = "true"))
 	UInputAction* LookAction;
 
+	/** Fire Input Action */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (AllowPrivateAccess = "true"))
+	UInputAction* FireAction;
+
 public:
 	AGAPlayerCharacter();
+
+	/** Projectile fired by Fire, taken from the projectile pool */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat)
+	TSubclassOf<AGAProjectile> ProjectileClass;
+
+	/** Where shots leave from, relative to the character */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat)
+	FVector MuzzleOffset;
+
+	/** Minimum seconds between shots */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat)
+	float FireInterval;
+
+	/** Projectiles put in the pool at BeginPlay */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat)
+	int32 ProjectilePrewarmCount;
+
+	/** Fires one projectile in the direction the camera is facing */
+	UFUNCTION(BlueprintCallable, Category = Combat)
+	AGAProjectile* Fire();
+
+	/** Strength of the Player influence the character gives off. 0 for none */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat)
+	float InfluenceStrength;
 	
 
 protected:
@@ -55,6 +84,11 @@ protected:
 
 	/** Called for looking input */
 	void Look(const FInputActionValue& Value);
+
+	/** Called for fire input */
+	void FireInput(const FInputActionValue& Value);
+
+	double LastFireTime;
 			
 
 protected:
@@ -64,6 +98,8 @@ protected:
 	// To add mapping context
 	virtual void BeginPlay();
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
@@ -0,0 +1,311 @@
+#include "GAInfluenceMap.h"
+#include "GameAI/GameAIStats.h"
+
+#include "EngineUtils.h"
+#include "Async/ParallelFor.h"
+
+
+// Influence that has faded below this is flushed to 0, so an idle map settles rather than decaying forever
+static constexpr float MinInfluence = 1.e-4f;
+
+void UGAInfluenceMapSubsystem::Deinitialize()
+{
+	// The task writes into our buffers
+	UpdateTask.Wait();
+
+	if (AGAGridActor* Grid = GridActor.Get())
+	{
+		Grid->OnCellsChanged.Remove(CellsChangedHandle);
+	}
+	GridActor.Reset();
+
+	Super::Deinitialize();
+}
+
+TStatId UGAInfluenceMapSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGAInfluenceMapSubsystem, STATGROUP_Tickables);
+}
+
+void UGAInfluenceMapSubsystem::RegisterSource(AActor* Actor, EGAInfluenceChannel Channel, float Strength)
+{
+	if (!Actor || Channel >= GAIC_Count)
+	{
+		return;
+	}
+
+	for (FSource& Source : Sources)
+	{
+		if (Source.Actor == Actor)
+		{
+			Source.Channel = Channel;
+			Source.Strength = Strength;
+			return;
+		}
+	}
+
+	Sources.Add({ Actor, Channel, Strength });
+}
+
+void UGAInfluenceMapSubsystem::UnregisterSource(AActor* Actor)
+{
+	Sources.RemoveAllSwap([Actor](const FSource& Source) { return Source.Actor == Actor; });
+}
+
+AGAGridActor* UGAInfluenceMapSubsystem::FindGrid()
+{
+	if (!GridActor.IsValid())
+	{
+		TActorIterator<AGAGridActor> It(GetWorld());
+		GridActor = It ? *It : nullptr;
+
+		// A new grid needs a whole new snapshot
+		Traversability.Reset();
+		bHasPendingDirtyRect = false;
+		if (GridActor.IsValid())
+		{
+			CellsChangedHandle = GridActor->OnCellsChanged.AddUObject(this, &UGAInfluenceMapSubsystem::OnGridCellsChanged);
+		}
+	}
+	return GridActor.Get();
+}
+
+void UGAInfluenceMapSubsystem::OnGridCellsChanged(const FIntRect& DirtyRect)
+{
+	if (bHasPendingDirtyRect)
+	{
+		PendingDirtyRect.Union(DirtyRect);
+	}
+	else
+	{
+		PendingDirtyRect = DirtyRect;
+		bHasPendingDirtyRect = true;
+	}
+}
+
+void UGAInfluenceMapSubsystem::RefreshTraversability(const AGAGridActor* Grid)
+{
+	const bool bSameSize = Traversability.IsValid() && Traversability->XCount == Grid->XCount && Traversability->YCount == Grid->YCount;
+	if (bSameSize && Traversability->GridVersion == Grid->GetGridVersion())
+	{
+		return;
+	}
+
+	// Build a new snapshot rather than editing the old one, which a running task may still be reading
+	TSharedPtr<FTraversability, ESPMode::ThreadSafe> NewTraversability = MakeShared<FTraversability, ESPMode::ThreadSafe>();
+	NewTraversability->XCount = Grid->XCount;
+	NewTraversability->YCount = Grid->YCount;
+	NewTraversability->GridVersion = Grid->GetGridVersion();
+
+	// Normally only the cells the grid told us about need reading back, and the rest of the bits carry over.
+	// Without a rect to go on (first snapshot, resize), read the lot
+	FIntRect Rect(0, 0, Grid->XCount - 1, Grid->YCount - 1);
+	if (bSameSize && bHasPendingDirtyRect)
+	{
+		NewTraversability->Traversable = Traversability->Traversable;
+		Rect = FIntRect(
+			FMath::Max(PendingDirtyRect.Min.X, 0), FMath::Max(PendingDirtyRect.Min.Y, 0),
+			FMath::Min(PendingDirtyRect.Max.X, Grid->XCount - 1), FMath::Min(PendingDirtyRect.Max.Y, Grid->YCount - 1));
+	}
+	else
+	{
+		NewTraversability->Traversable.Init(false, Grid->XCount * Grid->YCount);
+	}
+
+	for (int32 Y = Rect.Min.Y; Y <= Rect.Max.Y; Y++)
+	{
+		for (int32 X = Rect.Min.X; X <= Rect.Max.X; X++)
+		{
+			FCellRef CellRef(X, Y);
+			NewTraversability->Traversable[Grid->CellRefToIndex(CellRef)] = Grid->IsCellTraversable(CellRef);
+		}
+	}
+
+	Traversability = NewTraversability;
+	bHasPendingDirtyRect = false;
+}
+
+void UGAInfluenceMapSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_InfluenceMap);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGAInfluenceMapSubsystem::Tick);
+
+	Super::Tick(DeltaTime);
+
+	TimeSinceUpdate += DeltaTime;
+
+	// Never block the game thread on the worker. If the last update is still going, try again next frame
+	if (!UpdateTask.IsCompleted() || TimeSinceUpdate < Settings.UpdateInterval)
+	{
+		return;
+	}
+
+	AGAGridActor* Grid = FindGrid();
+	if (!Grid || Grid->XCount <= 0 || Grid->YCount <= 0)
+	{
+		return;
+	}
+
+	RefreshTraversability(Grid);
+
+	// Sample sources here, on the game thread. The worker never touches an actor
+	TArray<FSourceSample> Samples;
+	Samples.Reserve(Sources.Num());
+	for (int32 SourceIndex = Sources.Num() - 1; SourceIndex >= 0; SourceIndex--)
+	{
+		const FSource& Source = Sources[SourceIndex];
+		const AActor* Actor = Source.Actor.Get();
+		if (!Actor)
+		{
+			Sources.RemoveAtSwap(SourceIndex);
+			continue;
+		}
+
+		FCellRef CellRef = Grid->GetCellRef(Actor->GetActorLocation());
+		if (CellRef.IsValid())
+		{
+			Samples.Add({ Grid->CellRefToIndex(CellRef), int32(Source.Channel), Source.Strength });
+		}
+	}
+
+	// The front buffer is only read from here on, and the back buffer is ours: no reader can still hold it,
+	// since they're only good until this tick
+	int32 Front = FrontIndex.load(std::memory_order_relaxed);
+	int32 Back = 1 - Front;
+
+	// Nothing to add and nothing left to fade out: another step would publish the same all-zero buffer
+	const FGAInfluenceBuffer& FrontBuffer = Buffers[Front];
+	if (Samples.Num() == 0 && FrontBuffer.IsValid() && FrontBuffer.MaxValue <= 0.0f
+		&& FrontBuffer.XCount == Grid->XCount && FrontBuffer.YCount == Grid->YCount)
+	{
+		return;
+	}
+
+	TimeSinceUpdate = 0.0f;
+
+	UpdateTask = UE::Tasks::Launch(UE_SOURCE_LOCATION,
+		[this, Front, Back, Samples = MoveTemp(Samples), SharedTraversability = Traversability, TaskSettings = Settings]()
+		{
+			Propagate(Buffers[Front], Buffers[Back], *SharedTraversability, Samples, TaskSettings);
+			Buffers[Back].Serial = Buffers[Front].Serial + 1;
+
+			// Publish. Release so that readers who see the new index also see everything written above
+			FrontIndex.store(Back, std::memory_order_release);
+		});
+}
+
+void UGAInfluenceMapSubsystem::Propagate(const FGAInfluenceBuffer& Previous, FGAInfluenceBuffer& Next, const FTraversability& Traversability,
+	const TArray<FSourceSample>& Samples, const FGAInfluenceSettings& Settings)
+{
+	const int32 XCount = Traversability.XCount;
+	const int32 YCount = Traversability.YCount;
+	const int32 CellCount = XCount * YCount;
+
+	Next.XCount = XCount;
+	Next.YCount = YCount;
+	Next.Values.SetNumUninitialized(CellCount * GAIC_Count);
+
+	// Start over if the grid changed size under us
+	const bool bHasPrevious = (Previous.XCount == XCount && Previous.YCount == YCount && Previous.IsValid());
+
+	const float Momentum = FMath::Clamp(Settings.Momentum, 0.0f, 1.0f);
+	const float StraightFalloff = FMath::Exp(-Settings.Decay);
+	const float DiagonalFalloff = FMath::Exp(-Settings.Decay * UE_SQRT_2);
+
+	// Each row's largest value, reduced below
+	TArray<float> RowMaxValues;
+	RowMaxValues.SetNumZeroed(GAIC_Count * YCount);
+
+	// One step of spread: each cell takes the strongest decayed neighbour, blended with its own previous value.
+	// Every row only reads Previous and writes its own row of Next, so rows are independent
+	ParallelFor(GAIC_Count * YCount, [&](int32 RowIndex)
+	{
+		const int32 Channel = RowIndex / YCount;
+		const int32 Y = RowIndex % YCount;
+		const float* PreviousChannel = bHasPrevious ? Previous.Values.GetData() + Channel * CellCount : nullptr;
+		float* NextRow = Next.Values.GetData() + Channel * CellCount + Y * XCount;
+		float& RowMaxValue = RowMaxValues[RowIndex];
+
+		for (int32 X = 0; X < XCount; X++)
+		{
+			const int32 CellIndex = Y * XCount + X;
+			if (!PreviousChannel || !Traversability.Traversable[CellIndex])
+			{
+				NextRow[X] = 0.0f;
+				continue;
+			}
+
+			float Strongest = 0.0f;
+			for (int32 DY = -1; DY <= 1; DY++)
+			{
+				const int32 NY = Y + DY;
+				if (NY < 0 || NY >= YCount)
+				{
+					continue;
+				}
+
+				for (int32 DX = -1; DX <= 1; DX++)
+				{
+					const int32 NX = X + DX;
+					if ((DX == 0 && DY == 0) || NX < 0 || NX >= XCount)
+					{
+						continue;
+					}
+
+					const float Falloff = (DX != 0 && DY != 0) ? DiagonalFalloff : StraightFalloff;
+					Strongest = FMath::Max(Strongest, PreviousChannel[NY * XCount + NX] * Falloff);
+				}
+			}
+
+			const float Value = FMath::Lerp(Strongest, PreviousChannel[CellIndex], Momentum);
+			NextRow[X] = (Value >= MinInfluence) ? Value : 0.0f;
+			RowMaxValue = FMath::Max(RowMaxValue, NextRow[X]);
+		}
+	});
+
+	Next.MaxValue = 0.0f;
+	for (float RowMaxValue : RowMaxValues)
+	{
+		Next.MaxValue = FMath::Max(Next.MaxValue, RowMaxValue);
+	}
+
+	// Sources pin their own cell
+	for (const FSourceSample& Sample : Samples)
+	{
+		float& Value = Next.Values[Sample.Channel * CellCount + Sample.CellIndex];
+		Value = FMath::Max(Value, Sample.Strength);
+		Next.MaxValue = FMath::Max(Next.MaxValue, Value);
+	}
+}
+
+float UGAInfluenceMapSubsystem::GetInfluence(EGAInfluenceChannel Channel, const FCellRef& CellRef) const
+{
+	const FGAInfluenceBuffer& Buffer = GetFrontBuffer();
+	if (!Buffer.IsValid() || Channel >= GAIC_Count
+		|| CellRef.X < 0 || CellRef.X >= Buffer.XCount || CellRef.Y < 0 || CellRef.Y >= Buffer.YCount)
+	{
+		return 0.0f;
+	}
+
+	return Buffer.Get(Channel, CellRef.Y * Buffer.XCount + CellRef.X);
+}
+
+float UGAInfluenceMapSubsystem::GetInfluenceAtPoint(EGAInfluenceChannel Channel, const FVector& Point) const
+{
+	const AGAGridActor* Grid = GridActor.Get();
+	return Grid ? GetInfluence(Channel, Grid->GetCellRef(Point)) : 0.0f;
+}
+
+bool UGAInfluenceMapSubsystem::GetInfluenceMap(EGAInfluenceChannel Channel, FGAGridMap& MapOut) const
+{
+	const AGAGridActor* Grid = GridActor.Get();
+	const FGAInfluenceBuffer& Buffer = GetFrontBuffer();
+	if (!Grid || !Buffer.IsValid() || Channel >= GAIC_Count || Buffer.XCount != Grid->XCount || Buffer.YCount != Grid->YCount)
+	{
+		return false;
+	}
+
+	MapOut = FGAGridMap(Grid, FGridBox(0, Grid->XCount - 1, 0, Grid->YCount - 1), 0.0f);
+	FMemory::Memcpy(MapOut.Data.GetData(), Buffer.GetChannel(Channel), Buffer.XCount * Buffer.YCount * sizeof(float));
+	return true;
+}
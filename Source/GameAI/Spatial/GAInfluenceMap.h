@@ -0,0 +1,157 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Task.h"
+#include "GameAI/Grid/GAGridActor.h"
+#include "GAInfluenceMap.generated.h"
+
+
+// Influence channels. Sources add into one channel each, and channels propagate independently
+UENUM(BlueprintType)
+enum EGAInfluenceChannel
+{
+	GAIC_Player				UMETA(DisplayName = "Player"),		// The player and anything on their side
+	GAIC_Robots				UMETA(DisplayName = "Robots"),		// Robot agents
+	GAIC_Threat				UMETA(DisplayName = "Threat"),		// Short-lived danger, e.g. projectiles in flight
+	GAIC_Count				UMETA(Hidden)
+};
+
+
+// A complete, published influence snapshot. Values are channel-major, each channel indexed like the grid's Data
+struct FGAInfluenceBuffer
+{
+	int32 XCount = 0;
+	int32 YCount = 0;
+	TArray<float> Values;
+
+	// Incremented every time a buffer is published
+	uint32 Serial = 0;
+
+	// The largest value in any channel. Values that fade below a small threshold are flushed to 0, so this reaches
+	// 0 once every source is gone and their influence has died out
+	float MaxValue = 0.0f;
+
+	bool IsValid() const { return Values.Num() > 0; }
+
+	float Get(EGAInfluenceChannel Channel, int32 CellIndex) const { return Values[int32(Channel) * XCount * YCount + CellIndex]; }
+
+	const float* GetChannel(EGAInfluenceChannel Channel) const { return Values.GetData() + int32(Channel) * XCount * YCount; }
+};
+
+
+// Propagation parameters
+USTRUCT(BlueprintType)
+struct FGAInfluenceSettings
+{
+	GENERATED_BODY()
+
+	FGAInfluenceSettings() : Decay(0.3f), Momentum(0.6f), UpdateInterval(0.0f) {}
+
+	// Influence falls off by exp(-Decay * distance in cells) as it spreads
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Decay;
+
+	// How much of a cell's previous value is kept each update, [0,1]. Higher means influence lingers
+	// after its source has moved on
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Momentum;
+
+	// Minimum seconds between updates. 0 means every frame (as long as the previous update has finished)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float UpdateInterval;
+};
+
+
+// Propagates team/threat influence over the grid off the game thread.
+//
+// Every tick, the game thread samples the registered sources into a flat list and, if the previous update has
+// finished, launches a task that propagates one step from the front buffer into the back buffer. When the task
+// is done it publishes the back buffer by atomically swapping the front index. Readers never take a lock and
+// always see a complete buffer.
+//
+// The buffer returned by GetFrontBuffer() stays untouched until this subsystem's next tick (which is the earliest
+// a new update can start writing into it), so hold on to it for the current frame only.
+//
+// With no sources registered and nothing left to fade, no update is launched at all. The traversability the worker
+// reads is a snapshot, patched from the grid's OnCellsChanged rects rather than read back whole when the grid changes.
+UCLASS()
+class UGAInfluenceMapSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Sources --------------------------------
+
+	UFUNCTION(BlueprintCallable)
+	void RegisterSource(AActor* Actor, EGAInfluenceChannel Channel, float Strength = 1.0f);
+
+	UFUNCTION(BlueprintCallable)
+	void UnregisterSource(AActor* Actor);
+
+	// Reading --------------------------------
+
+	const FGAInfluenceBuffer& GetFrontBuffer() const { return Buffers[FrontIndex.load(std::memory_order_acquire)]; }
+
+	UFUNCTION(BlueprintCallable)
+	float GetInfluenceAtPoint(EGAInfluenceChannel Channel, const FVector& Point) const;
+
+	float GetInfluence(EGAInfluenceChannel Channel, const FCellRef& CellRef) const;
+
+	// Copy one channel of the front buffer into a grid map, e.g. for the debug texture
+	UFUNCTION(BlueprintCallable)
+	bool GetInfluenceMap(EGAInfluenceChannel Channel, FGAGridMap& MapOut) const;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FGAInfluenceSettings Settings;
+
+protected:
+	struct FSource
+	{
+		TWeakObjectPtr<AActor> Actor;
+		EGAInfluenceChannel Channel;
+		float Strength;
+	};
+
+	struct FSourceSample
+	{
+		int32 CellIndex;
+		int32 Channel;
+		float Strength;
+	};
+
+	// Immutable after creation, shared with the worker so grid edits on the game thread can't race it
+	struct FTraversability
+	{
+		int32 XCount = 0;
+		int32 YCount = 0;
+		uint32 GridVersion = 0;
+		TBitArray<> Traversable;
+	};
+
+	AGAGridActor* FindGrid();
+	void RefreshTraversability(const AGAGridActor* Grid);
+	void OnGridCellsChanged(const FIntRect& DirtyRect);
+
+	static void Propagate(const FGAInfluenceBuffer& Previous, FGAInfluenceBuffer& Next, const FTraversability& Traversability,
+		const TArray<FSourceSample>& Samples, const FGAInfluenceSettings& Settings);
+
+	TArray<FSource> Sources;
+	TWeakObjectPtr<AGAGridActor> GridActor;
+	FDelegateHandle CellsChangedHandle;
+	TSharedPtr<const FTraversability, ESPMode::ThreadSafe> Traversability;
+
+	// Cells changed since Traversability was taken, if it's still the right size
+	FIntRect PendingDirtyRect;
+	bool bHasPendingDirtyRect = false;
+
+	FGAInfluenceBuffer Buffers[2];
+	std::atomic<int32> FrontIndex = 0;
+
+	UE::Tasks::FTask UpdateTask;
+	float TimeSinceUpdate = 0.0f;
+};
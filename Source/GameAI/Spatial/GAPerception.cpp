@@ -0,0 +1,234 @@
+#include "GAPerception.h"
+#include "GameAI/GameAIStats.h"
+
+#include "EngineUtils.h"
+#include "Kismet/GameplayStatics.h"
+
+
+TStatId UGAPerceptionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGAPerceptionSubsystem, STATGROUP_Tickables);
+}
+
+void UGAPerceptionSubsystem::RegisterObserver(AActor* Observer, float SightRadius)
+{
+	if (!Observer)
+	{
+		return;
+	}
+
+	int32 Index = Observers.IndexOfByPredicate([Observer](const TWeakObjectPtr<AActor>& Existing) { return Existing.Get() == Observer; });
+	if (Index != INDEX_NONE)
+	{
+		SightRadii[Index] = SightRadius;
+		CachedCells[Index] = FCellRef::Invalid;
+		return;
+	}
+
+	Observers.Add(Observer);
+	SightRadii.Add(SightRadius);
+	ObserverPositions.Add(Observer->GetActorLocation());
+	ObserverCells.Add(FCellRef::Invalid);
+	CachedCells.Add(FCellRef::Invalid);
+	VisibleFlags.Add(0);
+	PendingTraceFlags.Add(0);
+}
+
+void UGAPerceptionSubsystem::UnregisterObserver(AActor* Observer)
+{
+	int32 Index = Observers.IndexOfByPredicate([Observer](const TWeakObjectPtr<AActor>& Existing) { return Existing.Get() == Observer; });
+	if (Index != INDEX_NONE)
+	{
+		RemoveObserverAt(Index);
+	}
+}
+
+void UGAPerceptionSubsystem::RemoveObserverAt(int32 Index)
+{
+	Observers.RemoveAtSwap(Index);
+	SightRadii.RemoveAtSwap(Index);
+	ObserverPositions.RemoveAtSwap(Index);
+	ObserverCells.RemoveAtSwap(Index);
+	CachedCells.RemoveAtSwap(Index);
+	VisibleFlags.RemoveAtSwap(Index);
+	PendingTraceFlags.RemoveAtSwap(Index);
+}
+
+void UGAPerceptionSubsystem::SetTarget(AActor* InTarget)
+{
+	Target = InTarget;
+
+	// Everyone looks again
+	TargetCell = FCellRef::Invalid;
+}
+
+AActor* UGAPerceptionSubsystem::GetTarget() const
+{
+	return Target.IsValid() ? Target.Get() : UGameplayStatics::GetPlayerPawn(this, 0);
+}
+
+bool UGAPerceptionSubsystem::CanSeeTarget(const AActor* Observer) const
+{
+	int32 Index = Observers.IndexOfByPredicate([Observer](const TWeakObjectPtr<AActor>& Existing) { return Existing.Get() == Observer; });
+	return Index != INDEX_NONE && VisibleFlags[Index] != 0;
+}
+
+AGAGridActor* UGAPerceptionSubsystem::FindGrid()
+{
+	if (!GridActor.IsValid())
+	{
+		TActorIterator<AGAGridActor> It(GetWorld());
+		GridActor = It ? *It : nullptr;
+	}
+	return GridActor.Get();
+}
+
+bool UGAPerceptionSubsystem::IsAmbiguous(const AGAGridActor* Grid, const FCellRef& CellRef) const
+{
+	// Standing somewhere the grid calls blocked (a dynamic obstacle's footprint, say)
+	if (!Grid->IsCellTraversable(CellRef) || TargetVisibility.Num() != Grid->XCount * Grid->YCount)
+	{
+		return true;
+	}
+
+	// On the edge of a shadow: some walkable neighbour disagrees
+	bool bVisible = TargetVisibility[Grid->CellRefToIndex(CellRef)];
+	for (int32 DY = -1; DY <= 1; DY++)
+	{
+		for (int32 DX = -1; DX <= 1; DX++)
+		{
+			FCellRef Neighbour(CellRef.X + DX, CellRef.Y + DY);
+			if ((DX != 0 || DY != 0) && Grid->IsCellTraversable(Neighbour) && TargetVisibility[Grid->CellRefToIndex(Neighbour)] != bVisible)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+bool UGAPerceptionSubsystem::TraceToTarget(const AActor* Observer, const AActor* TargetActor) const
+{
+	const APawn* ObserverPawn = Cast<APawn>(Observer);
+	const APawn* TargetPawn = Cast<APawn>(TargetActor);
+	FVector Start = ObserverPawn ? ObserverPawn->GetPawnViewLocation() : Observer->GetActorLocation();
+	FVector End = TargetPawn ? TargetPawn->GetPawnViewLocation() : TargetActor->GetActorLocation();
+
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(GAPerceptionTrace), false, Observer);
+	Params.AddIgnoredActor(TargetActor);
+
+	FHitResult Hit;
+	return !GetWorld()->LineTraceSingleByChannel(Hit, Start, End, TraceChannel, Params);
+}
+
+void UGAPerceptionSubsystem::SetVisible(int32 Index, bool bVisible)
+{
+	if ((VisibleFlags[Index] != 0) != bVisible)
+	{
+		VisibleFlags[Index] = bVisible ? 1 : 0;
+		OnVisibilityChanged.Broadcast(Observers[Index].Get(), bVisible);
+	}
+}
+
+void UGAPerceptionSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_Perception);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGAPerceptionSubsystem::Tick);
+
+	Stats = FGAPerceptionStats();
+
+	for (int32 Index = Observers.Num() - 1; Index >= 0; Index--)
+	{
+		if (!Observers[Index].IsValid())
+		{
+			RemoveObserverAt(Index);
+		}
+	}
+
+	AGAGridActor* Grid = FindGrid();
+	AActor* TargetActor = GetTarget();
+	if (!Grid || !TargetActor || Observers.Num() == 0)
+	{
+		return;
+	}
+
+	// The shadowcast only needs to reach as far as the furthest-sighted observer
+	int32 Radius = 0;
+	for (float SightRadius : SightRadii)
+	{
+		if (SightRadius <= 0.0f)
+		{
+			Radius = 0;
+			break;
+		}
+		Radius = FMath::Max(Radius, FMath::CeilToInt(SightRadius / Grid->CellScale));
+	}
+
+	// One shadowcast from the target answers every cell at once
+	FCellRef NewTargetCell = Grid->GetCellRef(TargetActor->GetActorLocation(), true);
+	bool bRebuild = !(NewTargetCell == TargetCell) || Grid->GetGridVersion() != TargetVisibilityVersion || Radius != TargetVisibilityRadius;
+	if (bRebuild)
+	{
+		TargetCell = NewTargetCell;
+		TargetVisibilityVersion = Grid->GetGridVersion();
+		TargetVisibilityRadius = Radius;
+		Grid->ComputeVisibility(TargetCell, TargetVisibility, Radius);
+		Stats.bVisibilityRebuilt = true;
+	}
+
+	for (int32 Index = 0; Index < Observers.Num(); Index++)
+	{
+		ObserverPositions[Index] = Observers[Index]->GetActorLocation();
+	}
+	Grid->GetCellRefs(ObserverPositions, ObserverCells, true);
+
+	for (int32 Index = 0; Index < Observers.Num(); Index++)
+	{
+		const FCellRef& Cell = ObserverCells[Index];
+		if (!bRebuild && Cell == CachedCells[Index])
+		{
+			Stats.CacheHits++;
+			continue;
+		}
+
+		CachedCells[Index] = Cell;
+		PendingTraceFlags[Index] = 0;
+
+		if (SightRadii[Index] > 0.0f && Cell.Distance(TargetCell) * Grid->CellScale > SightRadii[Index])
+		{
+			SetVisible(Index, false);
+			Stats.GridAnswers++;
+		}
+		else if (IsAmbiguous(Grid, Cell))
+		{
+			PendingTraceFlags[Index] = 1;
+		}
+		else
+		{
+			SetVisible(Index, TargetVisibility[Grid->CellRefToIndex(Cell)]);
+			Stats.GridAnswers++;
+		}
+	}
+
+	// Settle ambiguous observers with real traces, round-robin within the budget
+	int32 Count = Observers.Num();
+	int32 Budget = MaxTracesPerFrame;
+	for (int32 Step = 0; Step < Count && Budget > 0; Step++)
+	{
+		int32 Index = (TraceCursor + Step) % Count;
+		if (PendingTraceFlags[Index])
+		{
+			SetVisible(Index, TraceToTarget(Observers[Index].Get(), TargetActor));
+			PendingTraceFlags[Index] = 0;
+			Stats.Traces++;
+			Budget--;
+			TraceCursor = Index + 1;
+		}
+	}
+
+	for (uint8 Pending : PendingTraceFlags)
+	{
+		Stats.PendingTraces += Pending;
+	}
+}
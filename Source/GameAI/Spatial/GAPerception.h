@@ -0,0 +1,115 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameAI/Grid/GAGridActor.h"
+#include "GAPerception.generated.h"
+
+
+// Where this frame's answers came from
+USTRUCT(BlueprintType)
+struct FGAPerceptionStats
+{
+	GENERATED_BODY()
+
+	// Observers whose answer was kept because neither they nor the target changed cell
+	UPROPERTY(BlueprintReadOnly)
+	int32 CacheHits = 0;
+
+	// Answers read straight off the grid's visibility
+	UPROPERTY(BlueprintReadOnly)
+	int32 GridAnswers = 0;
+
+	// Physics traces for cells on the edge of a shadow, where the grid's answer is unreliable
+	UPROPERTY(BlueprintReadOnly)
+	int32 Traces = 0;
+
+	// Ambiguous observers still waiting for a trace (they keep their previous answer until then)
+	UPROPERTY(BlueprintReadOnly)
+	int32 PendingTraces = 0;
+
+	// Whether the target's visibility had to be recomputed this frame
+	UPROPERTY(BlueprintReadOnly)
+	bool bVisibilityRebuilt = false;
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FGAOnVisibilityChanged, AActor* /* Observer */, bool /* bCanSee */);
+
+
+// Answers "can this observer see the target?" for every registered observer at once, instead of one line trace
+// per observer per frame.
+//
+// Grid visibility is symmetric (see AGAGridActor::ComputeVisibility), so one shadowcast from the target's cell
+// tells us, for every cell, whether it can see the target. That's recomputed only when the target changes cell
+// or the grid changes. Each observer's answer is then cached, and only looked at again when the observer changes
+// cell (or the target's visibility was recomputed).
+//
+// The grid is coarse, so cells right on the edge of a shadow (some neighbour disagrees), and observers standing in
+// a cell the grid considers blocked, are treated as ambiguous and settled with a physics trace instead. At most
+// MaxTracesPerFrame of those run per frame; the rest keep their previous answer until their turn.
+UCLASS()
+class UGAPerceptionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// SightRadius in world units. 0 means unlimited
+	UFUNCTION(BlueprintCallable)
+	void RegisterObserver(AActor* Observer, float SightRadius = 0.0f);
+
+	UFUNCTION(BlueprintCallable)
+	void UnregisterObserver(AActor* Observer);
+
+	// Who everyone is looking for. Defaults to the first player's pawn
+	UFUNCTION(BlueprintCallable)
+	void SetTarget(AActor* InTarget);
+
+	// As of this frame's update
+	UFUNCTION(BlueprintCallable)
+	bool CanSeeTarget(const AActor* Observer) const;
+
+	const FGAPerceptionStats& GetStats() const { return Stats; }
+
+	// Fires when an observer gains or loses sight of the target
+	FGAOnVisibilityChanged OnVisibilityChanged;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MaxTracesPerFrame = 8;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+
+protected:
+	AGAGridActor* FindGrid();
+	AActor* GetTarget() const;
+	void RemoveObserverAt(int32 Index);
+	bool IsAmbiguous(const AGAGridActor* Grid, const FCellRef& CellRef) const;
+	bool TraceToTarget(const AActor* Observer, const AActor* TargetActor) const;
+	void SetVisible(int32 Index, bool bVisible);
+
+	TWeakObjectPtr<AGAGridActor> GridActor;
+	TWeakObjectPtr<AActor> Target;
+
+	// Cells that can see the target's cell, indexed like the grid's Data
+	TBitArray<> TargetVisibility;
+	FCellRef TargetCell;
+	uint32 TargetVisibilityVersion = 0;
+	int32 TargetVisibilityRadius = 0;
+
+	// Observer state, one slot per registered observer
+	TArray<TWeakObjectPtr<AActor>> Observers;
+	TArray<float> SightRadii;
+	TArray<FVector> ObserverPositions;
+	TArray<FCellRef> ObserverCells;
+	TArray<FCellRef> CachedCells;
+	TArray<uint8> VisibleFlags;
+	TArray<uint8> PendingTraceFlags;
+
+	// Where the trace budget picks up next frame, so everyone gets a turn
+	int32 TraceCursor = 0;
+
+	FGAPerceptionStats Stats;
+};
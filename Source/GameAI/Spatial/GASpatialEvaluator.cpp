@@ -0,0 +1,683 @@
+#include "GASpatialEvaluator.h"
+
+#include "Async/ParallelFor.h"
+#include "GameAI/Pathfinding/GAPathComponent.h"
+#include "GameAI/Pathfinding/GAAILOD.h"
+#include "GameAI/Spatial/GAInfluenceMap.h"
+#include "GACoreSearch.h"
+#include "GameAI/GameAIStats.h"
+
+
+void UGASpatialEvaluatorSubsystem::Deinitialize()
+{
+	for (const FBoundGrid& Bound : BoundGrids)
+	{
+		if (const AGAGridActor* Grid = Bound.Grid.Get())
+		{
+			Grid->OnCellsChanged.Remove(Bound.CellsChangedHandle);
+		}
+	}
+	BoundGrids.Reset();
+
+	// Nothing cached here should outlive the world it was computed in
+	FrameLayers.Reset();
+	LayerCache.Empty();
+	TargetPathDistance.UnbindFromGrid();
+
+	Super::Deinitialize();
+}
+
+
+// Layers -------------------------------------------------------------------------
+
+const FGAGridMap& UGASpatialEvaluatorSubsystem::GetLayer(const AGAGridActor* Grid, EGASpatialLayer Layer, const FCellRef& SourceCell)
+{
+	return *GetLayerHandle(Grid, Layer, SourceCell);
+}
+
+FGAGridMapHandle UGASpatialEvaluatorSubsystem::GetLayerHandle(const AGAGridActor* Grid, EGASpatialLayer Layer, const FCellRef& SourceCell)
+{
+	if (FGAGridMapHandle Found = FindLayerHandle(Grid, Layer, SourceCell))
+	{
+		return Found;
+	}
+
+	FGAGridMapHandle Handle;
+	if (Layer == GASL_TargetPathDistance)
+	{
+		Handle = UpdateTargetPathDistance(Grid, SourceCell);
+	}
+	else if (Layer == GASL_Threat)
+	{
+		// Changes with every influence update, so it's only pinned for the frame, never cached
+		FGAGridMap ThreatMap;
+		ComputeThreatLayer(Grid, ThreatMap);
+		Handle = MakeShared<const FGAGridMap, ESPMode::ThreadSafe>(MoveTemp(ThreatMap));
+	}
+	else
+	{
+		FGAGridMap Map;
+		ComputeLayer(Grid, Grid->GetCoreGrid(), Layer, SourceCell, Map);
+		Handle = LayerCache.Add(FGAGridMapCacheKey(Grid, int32(Layer), SourceCell), MoveTemp(Map));
+	}
+
+	FrameLayers.Add(FGAGridMapCacheKey(Grid, int32(Layer), SourceCell), Handle);
+	return Handle;
+}
+
+FGAGridMapHandle UGASpatialEvaluatorSubsystem::FindLayerHandle(const AGAGridActor* Grid, EGASpatialLayer Layer, const FCellRef& SourceCell)
+{
+	// Only pin layers for the frame they were asked for in. Past that they live in the shared cache
+	if (FrameLayersFrame != GFrameCounter)
+	{
+		FrameLayers.Reset();
+		FrameLayersFrame = GFrameCounter;
+	}
+
+	FGAGridMapCacheKey Key(Grid, int32(Layer), SourceCell);
+	if (FGAGridMapHandle* Existing = FrameLayers.Find(Key))
+	{
+		LayerReuseCount++;
+		return *Existing;
+	}
+
+	BindGrid(Grid);
+
+	// The rest are kept on the game thread, never in the shared cache
+	if (!CanBuildOffGameThread(Layer))
+	{
+		return FGAGridMapHandle();
+	}
+
+	FGAGridMapHandle Cached = LayerCache.Find(Key);
+	if (Cached)
+	{
+		LayerReuseCount++;
+		FrameLayers.Add(Key, Cached);
+	}
+	return Cached;
+}
+
+bool UGASpatialEvaluatorSubsystem::CanBuildOffGameThread(EGASpatialLayer Layer)
+{
+	return Layer == GASL_TargetLOS || Layer == GASL_TargetDistance || Layer == GASL_AgentPathDistance;
+}
+
+void UGASpatialEvaluatorSubsystem::BindGrid(const AGAGridActor* Grid)
+{
+	for (const FBoundGrid& Bound : BoundGrids)
+	{
+		if (Bound.Grid.Get() == Grid)
+		{
+			return;
+		}
+	}
+
+	// Grids that went away take their entries with them
+	for (int32 Index = BoundGrids.Num() - 1; Index >= 0; Index--)
+	{
+		if (!BoundGrids[Index].Grid.IsValid())
+		{
+			LayerCache.Invalidate(BoundGrids[Index].GridKey, [](const FGAGridMapCacheKey&, const FGAGridMap&) { return true; });
+			BoundGrids.RemoveAtSwap(Index);
+		}
+	}
+
+	FBoundGrid& Bound = BoundGrids.AddDefaulted_GetRef();
+	Bound.Grid = Grid;
+	Bound.GridKey = FObjectKey(Grid);
+	Bound.DataVersion = Grid->GetDataVersion();
+	Bound.CellsChangedHandle = Grid->OnCellsChanged.AddUObject(this, &UGASpatialEvaluatorSubsystem::OnGridCellsChanged, TWeakObjectPtr<const AGAGridActor>(Grid));
+}
+
+void UGASpatialEvaluatorSubsystem::OnGridCellsChanged(const FIntRect& DirtyRect, TWeakObjectPtr<const AGAGridActor> WeakGrid)
+{
+	const AGAGridActor* Grid = WeakGrid.Get();
+	FBoundGrid* Bound = BoundGrids.FindByPredicate([Grid](const FBoundGrid& Entry) { return Entry.Grid.Get() == Grid; });
+	if (!Grid || !Bound)
+	{
+		return;
+	}
+
+	FObjectKey GridKey(Grid);
+	auto ShouldEvict = [&](const FGAGridMapCacheKey& Key, const FGAGridMap& Map)
+	{
+		// Static data changed: every entry for this grid is keyed on the old version and can't be hit again
+		return (Key.DataVersion != Grid->GetDataVersion()) || IsLayerAffected(EGASpatialLayer(Key.LayerType), Map, DirtyRect);
+	};
+
+	Bound->DataVersion = Grid->GetDataVersion();
+	LayerCache.Invalidate(GridKey, ShouldEvict);
+
+	// Layers pinned for this frame aren't keyed on the overlay either
+	for (auto It = FrameLayers.CreateIterator(); It; ++It)
+	{
+		if (It.Key().Grid == GridKey && ShouldEvict(It.Key(), *It.Value()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool UGASpatialEvaluatorSubsystem::IsLayerAffected(EGASpatialLayer Layer, const FGAGridMap& Map, const FIntRect& DirtyRect)
+{
+	// Only look at the part of the map the change could reach
+	auto AnyInRect = [&Map](const FIntRect& Rect, TFunctionRef<bool(float)> Test)
+	{
+		const FGridBox& Bounds = Map.GridBounds;
+		int32 Width = Bounds.MaxX - Bounds.MinX + 1;
+		for (int32 Y = FMath::Max(Rect.Min.Y, Bounds.MinY); Y <= FMath::Min(Rect.Max.Y, Bounds.MaxY); Y++)
+		{
+			for (int32 X = FMath::Max(Rect.Min.X, Bounds.MinX); X <= FMath::Min(Rect.Max.X, Bounds.MaxX); X++)
+			{
+				if (Test(Map.Data[(Y - Bounds.MinY) * Width + (X - Bounds.MinX)]))
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	};
+
+	switch (Layer)
+	{
+	case GASL_TargetDistance:
+		// Straight-line, doesn't look at the cells at all
+		return false;
+
+	case GASL_Threat:
+		// A copy of the influence map, which catches up with the grid on its own next update
+		return false;
+
+	case GASL_TargetLOS:
+		// Blocking a cell only shadows what's behind it if it was visible. An unblocked cell that wasn't visible
+		// (walls bordering visible space count as visible) stays hidden behind whatever hid it
+		return AnyInRect(DirtyRect, [](float Value) { return Value > 0.0f; });
+
+	default:
+		// Distance fields: a changed cell matters if it was reached (blocked or made more expensive), or if it's next
+		// to a reached cell (unblocked). Unreached space elsewhere can't shorten or lengthen any path
+		return AnyInRect(FIntRect(DirtyRect.Min - FIntPoint(1, 1), DirtyRect.Max + FIntPoint(1, 1)), [](float Value) { return Value < BIG_NUMBER; });
+	}
+}
+
+FGAGridMapHandle UGASpatialEvaluatorSubsystem::UpdateTargetPathDistance(const AGAGridActor* Grid, const FCellRef& SourceCell)
+{
+	// A different grid actor can have the same dimensions, so check which one the map was built for.
+	// Resizes of the same grid are picked up by Update itself
+	if (!TargetPathDistance.IsInitialized() || TargetPathDistance.GetGrid() != Grid)
+	{
+		TargetPathDistance.Initialize(Grid, SourceCell);
+		TargetPathDistance.BindToGrid();
+	}
+	else
+	{
+		TargetPathDistance.SetSource(SourceCell);
+		TargetPathDistance.Update();
+	}
+
+	// The map's own distances, not a copy (see FGADynamicDistanceMap)
+	return TargetPathDistance.GetDistanceMapHandle();
+}
+
+void UGASpatialEvaluatorSubsystem::ComputeLayer(const AGAGridActor* Grid, const GACore::FGridView& Cells, EGASpatialLayer Layer, const FCellRef& SourceCell, FGAGridMap& LayerOut)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGASpatialEvaluatorSubsystem::ComputeLayer);
+
+	FGridBox FullBox(0, Cells.Width - 1, 0, Cells.Height - 1);
+
+	switch (Layer)
+	{
+	case GASL_TargetLOS:
+	{
+		// One shadowcasting pass covers the whole grid
+		LayerOut = FGAGridMap(Grid, FullBox, 0.0f);
+		if (Cells.IsInBounds(SourceCell.X, SourceCell.Y))
+		{
+			TBitArray<> Visible;
+			AGAGridActor::ComputeVisibility(Cells, SourceCell, Visible);
+			for (TConstSetBitIterator<> It(Visible); It; ++It)
+			{
+				LayerOut.Data[It.GetIndex()] = 1.0f;
+			}
+		}
+		break;
+	}
+
+	case GASL_TargetDistance:
+	{
+		LayerOut = FGAGridMap(Grid, FullBox, 0.0f);
+		float* LayerData = LayerOut.Data.GetData();
+		for (int32 Y = 0; Y < Cells.Height; Y++)
+		{
+			for (int32 X = 0; X < Cells.Width; X++)
+			{
+				LayerData[Y * Cells.Width + X] = SourceCell.Distance(FCellRef(X, Y));
+			}
+		}
+		break;
+	}
+
+	// The target's is normally kept incrementally (see UpdateTargetPathDistance); this is the from-scratch version
+	case GASL_TargetPathDistance:
+	case GASL_AgentPathDistance:
+	{
+		// Dijkstra expects unvisited cells to start at infinity
+		LayerOut = FGAGridMap(Grid, FullBox, INFINITY);
+		if (Cells.IsTraversable(SourceCell.X, SourceCell.Y))
+		{
+			// Only the heap is used, but it's worth keeping warm on whichever thread this runs on
+			static thread_local GACore::FSearchScratch Scratch;
+			GACore::FloodDistances(Cells, SourceCell.X, SourceCell.Y, GACore::FGridWindow::Full(Cells),
+				LayerOut.Data.GetData(), Scratch);
+		}
+		break;
+	}
+
+	case GASL_Threat:
+		// Not from the cells at all, see ComputeThreatLayer
+		LayerOut = FGAGridMap(Grid, FullBox, 0.0f);
+		break;
+	}
+}
+
+void UGASpatialEvaluatorSubsystem::ComputeThreatLayer(const AGAGridActor* Grid, FGAGridMap& LayerOut) const
+{
+	// The same for every source cell. Zero if there's no influence map for this grid (yet)
+	const FGridBox FullBox(0, Grid->XCount - 1, 0, Grid->YCount - 1);
+	const UGAInfluenceMapSubsystem* InfluenceMap = GetWorld() ? GetWorld()->GetSubsystem<UGAInfluenceMapSubsystem>() : nullptr;
+	if (!InfluenceMap || !InfluenceMap->GetInfluenceMap(GAIC_Threat, LayerOut)
+		|| LayerOut.GridBounds.MaxX != FullBox.MaxX || LayerOut.GridBounds.MaxY != FullBox.MaxY)
+	{
+		LayerOut = FGAGridMap(Grid, FullBox, 0.0f);
+	}
+}
+
+
+// Evaluation -------------------------------------------------------------------------
+
+bool UGASpatialEvaluatorSubsystem::FindBestCell(UGAPathComponent* PathComponent, const FGASpatialQuery& Query, FCellRef& BestCellOut, FGAGridMap* ScoreMapOut)
+{
+	FGAPreparedSpatialQuery Prepared;
+	if (!PrepareQuery(PathComponent, Query, Prepared))
+	{
+		return false;
+	}
+
+	BuildPendingLayers(Prepared);
+	CacheBuiltLayers(Prepared.Grid, Prepared);
+	return EvaluatePreparedQuery(Prepared, BestCellOut, ScoreMapOut);
+}
+
+bool UGASpatialEvaluatorSubsystem::PrepareQuery(UGAPathComponent* PathComponent, const FGASpatialQuery& Query, FGAPreparedSpatialQuery& PreparedOut)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_SpatialQuery);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGASpatialEvaluatorSubsystem::PrepareQuery);
+
+	PreparedOut = FGAPreparedSpatialQuery();
+
+	const AGAGridActor* Grid = PathComponent ? PathComponent->GetGridActor() : nullptr;
+	APawn* Pawn = PathComponent ? PathComponent->GetOwnerPawn() : nullptr;
+	if (!Grid || !Pawn)
+	{
+		return false;
+	}
+
+	// Less significant agents get a smaller, coarser search
+	PreparedOut.Query = Query;
+	if (const UGAAILODSubsystem* LOD = GetWorld()->GetSubsystem<UGAAILODSubsystem>())
+	{
+		LOD->ApplyToQuery(PathComponent, PreparedOut.Query);
+	}
+
+	FCellRef AgentCell = Grid->GetCellRef(Pawn->GetActorLocation(), true);
+	FCellRef TargetCell = Grid->GetCellRef(Query.TargetPoint, true);
+	int32 SearchRadius = PreparedOut.Query.SearchRadius;
+
+	PreparedOut.Grid = Grid;
+	PreparedOut.GridWidth = Grid->XCount;
+	PreparedOut.AgentCell = AgentCell;
+	PreparedOut.TargetCell = TargetCell;
+
+	// Candidate region
+	const FGridBox Box(
+		FMath::Max(AgentCell.X - SearchRadius, 0),
+		FMath::Min(AgentCell.X + SearchRadius, Grid->XCount - 1),
+		FMath::Max(AgentCell.Y - SearchRadius, 0),
+		FMath::Min(AgentCell.Y + SearchRadius, Grid->YCount - 1));
+	PreparedOut.Box = Box;
+
+	// The grid can change while the query is scored elsewhere, so it gets its own copy of the little it reads
+	const GACore::FGridView Cells = Grid->GetCoreGrid();
+	PreparedOut.BoxTraversable.Init(false, FMath::Max(Box.MaxX - Box.MinX + 1, 0) * FMath::Max(Box.MaxY - Box.MinY + 1, 0));
+	int32 BitIndex = 0;
+	for (int32 Y = Box.MinY; Y <= Box.MaxY; Y++)
+	{
+		for (int32 X = Box.MinX; X <= Box.MaxX; X++)
+		{
+			PreparedOut.BoxTraversable[BitIndex++] = Cells.IsTraversable(X, Y);
+		}
+	}
+
+	const FGAGridMipChain& MipChain = Grid->GetMipChain();
+	const FGASpatialQuery& PreparedQuery = PreparedOut.Query;
+	if (PreparedQuery.bCoarseToFine && PreparedQuery.CoarseLevel >= 0 && PreparedQuery.CoarseLevel < MipChain.Num())
+	{
+		PreparedOut.CoarseLevel = MipChain.GetLevel(PreparedQuery.CoarseLevel).CopyBlocks(Box);
+	}
+
+	// Take what's cached, and leave the rest to BuildPendingLayers (the Dijkstra and shadowcasting are what's slow).
+	// Layers kept on this thread are fetched as usual
+	auto FetchLayer = [&](EGASpatialLayer Layer, const FCellRef& SourceCell)
+	{
+		if (!CanBuildOffGameThread(Layer))
+		{
+			return GetLayerHandle(Grid, Layer, SourceCell);
+		}
+
+		FGAGridMapHandle Handle = FindLayerHandle(Grid, Layer, SourceCell);
+		if (!Handle && !PreparedOut.PendingLayers.ContainsByPredicate(
+			[Layer, &SourceCell](const FGAPreparedSpatialQuery::FPendingLayer& Pending) { return Pending.Layer == Layer && Pending.SourceCell == SourceCell; }))
+		{
+			FGAPreparedSpatialQuery::FPendingLayer& Pending = PreparedOut.PendingLayers.AddDefaulted_GetRef();
+			Pending.Layer = Layer;
+			Pending.SourceCell = SourceCell;
+			Pending.Key = FGAGridMapCacheKey(Grid, int32(Layer), SourceCell);
+		}
+		return Handle;
+	};
+
+	bool bNeedsReachability = false;
+	for (const FGASpatialTerm& Term : PreparedOut.Query.Terms)
+	{
+		bool bFromAgent = (Term.Layer == GASL_AgentPathDistance);
+		PreparedOut.TermLayers.Add(FetchLayer(Term.Layer, bFromAgent ? AgentCell : TargetCell));
+		bNeedsReachability |= bFromAgent;
+	}
+
+	// Candidates the agent can't reach are skipped outright, if we know about them
+	if (bNeedsReachability)
+	{
+		PreparedOut.Reachability = FetchLayer(GASL_AgentPathDistance, AgentCell);
+	}
+
+	// Shared with every other search started before the grid next changes
+	if (PreparedOut.PendingLayers.Num() > 0)
+	{
+		PreparedOut.GridSnapshot = Grid->GetSharedCoreGrid();
+		PreparedOut.SnapshotGridVersion = Grid->GetGridVersion();
+	}
+
+	return true;
+}
+
+void UGASpatialEvaluatorSubsystem::BuildPendingLayers(FGAPreparedSpatialQuery& Prepared)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_SpatialQuery);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGASpatialEvaluatorSubsystem::BuildPendingLayers);
+
+	if (!Prepared.GridSnapshot.IsValid())
+	{
+		return;
+	}
+
+	const GACore::FGridView Cells = Prepared.GridSnapshot->GetView();
+	for (FGAPreparedSpatialQuery::FPendingLayer& Pending : Prepared.PendingLayers)
+	{
+		if (!Pending.Map)
+		{
+			FGAGridMap Map;
+			ComputeLayer(Prepared.Grid, Cells, Pending.Layer, Pending.SourceCell, Map);
+			Pending.Map = MakeShared<const FGAGridMap, ESPMode::ThreadSafe>(MoveTemp(Map));
+		}
+	}
+
+	auto FindBuilt = [&Prepared](EGASpatialLayer Layer, const FCellRef& SourceCell)
+	{
+		const FGAPreparedSpatialQuery::FPendingLayer* Pending = Prepared.PendingLayers.FindByPredicate(
+			[Layer, &SourceCell](const FGAPreparedSpatialQuery::FPendingLayer& Entry) { return Entry.Layer == Layer && Entry.SourceCell == SourceCell; });
+		return Pending ? Pending->Map : FGAGridMapHandle();
+	};
+
+	bool bNeedsReachability = false;
+	for (int32 TermIndex = 0; TermIndex < Prepared.Query.Terms.Num(); TermIndex++)
+	{
+		EGASpatialLayer Layer = Prepared.Query.Terms[TermIndex].Layer;
+		bool bFromAgent = (Layer == GASL_AgentPathDistance);
+		if (!Prepared.TermLayers[TermIndex])
+		{
+			Prepared.TermLayers[TermIndex] = FindBuilt(Layer, bFromAgent ? Prepared.AgentCell : Prepared.TargetCell);
+		}
+		bNeedsReachability |= bFromAgent;
+	}
+
+	if (bNeedsReachability && !Prepared.Reachability)
+	{
+		Prepared.Reachability = FindBuilt(GASL_AgentPathDistance, Prepared.AgentCell);
+	}
+}
+
+void UGASpatialEvaluatorSubsystem::CacheBuiltLayers(const AGAGridActor* Grid, const FGAPreparedSpatialQuery& Prepared)
+{
+	// The cache only holds layers for the grid as it is now. If the cells changed since the snapshot, overlay
+	// evictions for the change have already been and gone, and these would never be evicted for it
+	if (!Grid || Grid != Prepared.Grid || !Prepared.GridSnapshot.IsValid() || Grid->GetGridVersion() != Prepared.SnapshotGridVersion)
+	{
+		return;
+	}
+
+	for (const FGAPreparedSpatialQuery::FPendingLayer& Pending : Prepared.PendingLayers)
+	{
+		if (Pending.Map)
+		{
+			LayerCache.Add(Pending.Key, Pending.Map);
+		}
+	}
+}
+
+bool UGASpatialEvaluatorSubsystem::EvaluatePreparedQuery(const FGAPreparedSpatialQuery& Prepared, FCellRef& BestCellOut, FGAGridMap* ScoreMapOut)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_SpatialQuery);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGASpatialEvaluatorSubsystem::EvaluatePreparedQuery);
+
+	const AGAGridActor* Grid = Prepared.Grid;
+	const int32 GridWidth = Prepared.GridWidth;
+	const FGASpatialQuery& Query = Prepared.Query;
+	const FGridBox& Box = Prepared.Box;
+	const FGAGridMap* Reachability = Prepared.Reachability.Get();
+	if (!Grid || GridWidth <= 0)
+	{
+		return false;
+	}
+
+	TArray<const FGAGridMap*, TInlineAllocator<8>> TermLayers;
+	for (const FGAGridMapHandle& Layer : Prepared.TermLayers)
+	{
+		// Still pending: BuildPendingLayers has to run first
+		if (!Layer)
+		{
+			return false;
+		}
+		TermLayers.Add(Layer.Get());
+	}
+
+	FGAGridMap ScoreMap(Grid, Box, -BIG_NUMBER);
+	float* ScoreData = ScoreMap.Data.GetData();
+	int32 Width = Box.MaxX - Box.MinX + 1;
+	int32 Height = Box.MaxY - Box.MinY + 1;
+
+	// From the copy taken by PrepareQuery, never the live grid
+	auto IsTraversable = [&](const FCellRef& CellRef)
+	{
+		return CellRef.X >= Box.MinX && CellRef.X <= Box.MaxX && CellRef.Y >= Box.MinY && CellRef.Y <= Box.MaxY
+			&& Prepared.BoxTraversable[(CellRef.Y - Box.MinY) * Width + (CellRef.X - Box.MinX)];
+	};
+
+	// Score for one traversable cell, or -BIG_NUMBER if it can't be reached. All the layers cover the full grid.
+	// Only the coarse-to-fine search scores cells one by one; the full search below does whole rows with the
+	// FGAGridMapOps row ops, which give the same values as Evaluate
+	auto ScoreCell = [&](int32 GridIndex)
+	{
+		if (Reachability && Reachability->Data[GridIndex] >= BIG_NUMBER)
+		{
+			return -BIG_NUMBER;
+		}
+
+		float Score = 0.0f;
+		for (int32 TermIndex = 0; TermIndex < Query.Terms.Num(); TermIndex++)
+		{
+			const FGASpatialTerm& Term = Query.Terms[TermIndex];
+			float Value = TermLayers[TermIndex]->Data[GridIndex];
+			if (Term.Curve.Points.Num() > 0)
+			{
+				Value = Term.Curve.Evaluate(Value);
+			}
+			Score += Term.Weight * Value;
+		}
+		return Score;
+	};
+
+	if (Query.bCoarseToFine && Prepared.CoarseLevel.Width > 0)
+	{
+		// Serial: the point is to score few enough cells that it isn't worth fanning out
+		FCellRef BestCell;
+		bool bFound = FGAGridMipChain::FindBestCellInLevel(Prepared.CoarseLevel, GridWidth, Box, Query.RefineBudget, IsTraversable,
+			[&](const FCellRef& CellRef)
+			{
+				float Score = ScoreCell(CellRef.Y * GridWidth + CellRef.X);
+
+				// Representatives can sit just outside Box
+				if (CellRef.X >= Box.MinX && CellRef.X <= Box.MaxX && CellRef.Y >= Box.MinY && CellRef.Y <= Box.MaxY)
+				{
+					ScoreData[(CellRef.Y - Box.MinY) * Width + (CellRef.X - Box.MinX)] = Score;
+				}
+				return Score;
+			},
+			BestCell);
+
+		// The best refined cell can still be unreachable, if they all were
+		bFound = bFound && ScoreData[(BestCell.Y - Box.MinY) * Width + (BestCell.X - Box.MinX)] > -BIG_NUMBER;
+
+		if (ScoreMapOut)
+		{
+			*ScoreMapOut = MoveTemp(ScoreMap);
+		}
+
+		if (!bFound)
+		{
+			return false;
+		}
+
+		BestCellOut = BestCell;
+		return true;
+	}
+
+	// Each range of rows keeps its own best. Ranges are fixed by row count (not thread count),
+	// so the reduction below always sees the same partition
+	constexpr int32 RowsPerRange = 8;
+	int32 RangeCount = FMath::DivideAndRoundUp(Height, RowsPerRange);
+
+	struct FRangeBest
+	{
+		float Score = -BIG_NUMBER;
+		int32 Index = INDEX_NONE;
+	};
+	TArray<FRangeBest> RangeBests;
+	RangeBests.SetNum(RangeCount);
+
+	ParallelFor(RangeCount, [&](int32 RangeIndex)
+	{
+		FRangeBest& Best = RangeBests[RangeIndex];
+		int32 RowEnd = FMath::Min((RangeIndex + 1) * RowsPerRange, Height);
+
+		// Curved layer values go through here a row at a time, since the layers themselves are shared
+		TArray<float, TInlineAllocator<128>> CurvedRow;
+		CurvedRow.SetNumUninitialized(Width);
+
+		for (int32 Row = RangeIndex * RowsPerRange; Row < RowEnd; Row++)
+		{
+			int32 GridRowStart = (Box.MinY + Row) * GridWidth + Box.MinX;
+			float* RowScores = ScoreData + Row * Width;
+
+			FMemory::Memzero(RowScores, Width * sizeof(float));
+			for (int32 TermIndex = 0; TermIndex < Query.Terms.Num(); TermIndex++)
+			{
+				const FGASpatialTerm& Term = Query.Terms[TermIndex];
+				const float* LayerRow = TermLayers[TermIndex]->Data.GetData() + GridRowStart;
+				if (Term.Curve.Points.Num() > 0)
+				{
+					FMemory::Memcpy(CurvedRow.GetData(), LayerRow, Width * sizeof(float));
+					FGAGridMapOps::ApplyResponseCurve(CurvedRow.GetData(), Width, Term.Curve);
+					LayerRow = CurvedRow.GetData();
+				}
+				FGAGridMapOps::AddScaled(RowScores, RowScores, LayerRow, Term.Weight, Width);
+			}
+
+			// Blocked and unreachable cells are out, and so is anything that scored -BIG_NUMBER or less (or NaN)
+			for (int32 Column = 0; Column < Width; Column++)
+			{
+				if (!Prepared.BoxTraversable[Row * Width + Column]
+					|| (Reachability && Reachability->Data[GridRowStart + Column] >= BIG_NUMBER)
+					|| !(RowScores[Column] > -BIG_NUMBER))
+				{
+					RowScores[Column] = -BIG_NUMBER;
+				}
+			}
+
+			// ArgMax takes the first of equal scores, and rows are walked in order with a strict greater, so ties go to the lowest index
+			float RowBest = -BIG_NUMBER;
+			int32 Column = FGAGridMapOps::ArgMax(RowScores, Width, RowBest);
+			if (Column != INDEX_NONE && RowBest > Best.Score)
+			{
+				Best.Score = RowBest;
+				Best.Index = Row * Width + Column;
+			}
+		}
+	});
+
+	FRangeBest Best;
+	for (const FRangeBest& RangeBest : RangeBests)
+	{
+		if (RangeBest.Index != INDEX_NONE && RangeBest.Score > Best.Score)
+		{
+			Best = RangeBest;
+		}
+	}
+
+	if (ScoreMapOut)
+	{
+		*ScoreMapOut = MoveTemp(ScoreMap);
+	}
+
+	if (Best.Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	BestCellOut = FCellRef(Box.MinX + Best.Index % Width, Box.MinY + Best.Index / Width);
+	return true;
+}
+
+bool UGASpatialEvaluatorSubsystem::K2_FindBestCell(UGAPathComponent* PathComponent, const FGASpatialQuery& Query, FCellRef& BestCellOut, FVector& BestPointOut)
+{
+	FGAGridMap ScoreMap;
+	bool bResult = FindBestCell(PathComponent, Query, BestCellOut, &ScoreMap);
+
+	if (bResult)
+	{
+		AGAGridActor* Grid = PathComponent->GetMutableGridActor();
+		BestPointOut = Grid->GetCellPosition(BestCellOut);
+
+		// Show the scores when debugging
+		if (Grid->bDebug)
+		{
+			// Unscored cells are -BIG_NUMBER, which the debug texture can't show
+			FGAGridMapOps::Clamp(ScoreMap, 0.0f, BIG_NUMBER);
+
+			Grid->SetDebugGridMap(ScoreMap);
+			Grid->RefreshDebugTexture();
+		}
+	}
+
+	return bResult;
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameAI/Grid/GAGridActor.h"
+#include "GameAI/Grid/GAGridMapOps.h"
+#include "GameAI/Grid/GAGridMapCache.h"
+#include "GameAI/Pathfinding/GADynamicDistanceMap.h"
+#include "GASpatialEvaluator.generated.h"
+
+class UGAPathComponent;
+
+
+// The raw layers a spatial function can be built out of
+UENUM(BlueprintType)
+enum EGASpatialLayer
+{
+	GASL_TargetLOS				UMETA(DisplayName = "Target LOS"),				// 1 where the target can see the cell, 0 elsewhere
+	GASL_TargetDistance			UMETA(DisplayName = "Target Distance"),			// Straight-line distance to the target, in cells
+	GASL_TargetPathDistance		UMETA(DisplayName = "Target Path Distance"),	// Path distance from the target (Dijkstra)
+	GASL_AgentPathDistance		UMETA(DisplayName = "Agent Path Distance"),		// Path distance from the agent (Dijkstra)
+	GASL_Threat					UMETA(DisplayName = "Threat"),					// The influence map's Threat channel (projectiles in flight)
+};
+
+
+// One term of a spatial function: Weight * Curve(Layer)
+USTRUCT(BlueprintType)
+struct FGASpatialTerm
+{
+	GENERATED_BODY()
+
+	FGASpatialTerm() : Layer(GASL_TargetLOS), Weight(1.0f) {}
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TEnumAsByte<EGASpatialLayer> Layer;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Weight;
+
+	// Optional. If empty, the raw layer value is used
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FGAResponseCurve Curve;
+};
+
+
+// A spatial function: the terms to sum, and where to look
+USTRUCT(BlueprintType)
+struct FGASpatialQuery
+{
+	GENERATED_BODY()
+
+	FGASpatialQuery() : TargetPoint(FVector::ZeroVector), SearchRadius(20), bCoarseToFine(false), CoarseLevel(1), RefineBudget(4) {}
+
+	// Usually the player
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FVector TargetPoint;
+
+	// Only cells within this many cells of the agent are candidates
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 SearchRadius;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TArray<FGASpatialTerm> Terms;
+
+	// Score one representative cell per block of the grid's mip level CoarseLevel (level 1 = 4x4 blocks), then
+	// only the RefineBudget best blocks at full resolution. Much cheaper for large radii, but can miss a lone
+	// good cell in a block whose representative scores badly
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bCoarseToFine;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "bCoarseToFine"))
+	int32 CoarseLevel;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "bCoarseToFine"))
+	int32 RefineBudget;
+};
+
+
+// A query with its cached layers fetched and everything else it needs copied in, so it can be carried over to another
+// thread (or frame) while the grid keeps changing. There, UGASpatialEvaluatorSubsystem::BuildPendingLayers computes
+// the layers that weren't cached from a snapshot of the grid, and EvaluatePreparedQuery scores it.
+// Holding the layer handles keeps the maps alive
+struct FGAPreparedSpatialQuery
+{
+	// For the caller, to turn the result into a position. Neither building nor scoring reads its cells
+	const AGAGridActor* Grid = nullptr;
+	int32 GridWidth = 0;
+
+	// After level-of-detail adjustment
+	FGASpatialQuery Query;
+
+	FCellRef AgentCell;
+	FCellRef TargetCell;
+
+	FGridBox Box;
+
+	// One per term, and the agent's path distance if any term needs it. Empty handles are pending layers
+	TArray<FGAGridMapHandle, TInlineAllocator<8>> TermLayers;
+	FGAGridMapHandle Reachability;
+
+	// Layers that weren't cached, to be built from GridSnapshot (taken at SnapshotGridVersion)
+	struct FPendingLayer
+	{
+		EGASpatialLayer Layer = GASL_TargetLOS;
+		FCellRef SourceCell;
+		FGAGridMapCacheKey Key;
+		FGAGridMapHandle Map;
+	};
+	TArray<FPendingLayer, TInlineAllocator<4>> PendingLayers;
+	TSharedPtr<const GACore::FGridStorage, ESPMode::ThreadSafe> GridSnapshot;
+	uint32 SnapshotGridVersion = 0;
+
+	// Traversability of the cells in Box (overlay included) when the query was prepared, row by row
+	TBitArray<> BoxTraversable;
+
+	// The blocks of the mip level over Box, for a coarse-to-fine query
+	FGAGridMipLevel CoarseLevel;
+};
+
+
+// Evaluates spatial functions (hold/hide/flee position selection etc.) natively.
+// Candidate cells are scored in parallel, each worker owning a contiguous range of rows of the score map and scoring
+// it a row at a time with the FGAGridMapOps row ops. The per-range winners are reduced in a fixed order so the result
+// doesn't depend on thread timing.
+// Layers are shared through an FGAGridMapCache, keyed by source cell and the grid's static data version, so agents
+// asking for the same layer from the same cell (the target's, usually) share one map until it gets evicted.
+// Overlay changes evict only the layers they can affect (see IsLayerAffected), and the cache goes with the world.
+UCLASS()
+class UGASpatialEvaluatorSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Scores the cells around the path component's owner and returns the best one.
+	// If ScoreMapOut is given, it receives the scores of the candidate region (unscored cells are -BIG_NUMBER).
+	bool FindBestCell(UGAPathComponent* PathComponent, const FGASpatialQuery& Query, FCellRef& BestCellOut, FGAGridMap* ScoreMapOut = nullptr);
+
+	// FindBestCell in pieces. PrepareQuery fetches the cached layers and copies the grid data the rest needs, and
+	// must run on the game thread. BuildPendingLayers computes the uncached layers (the Dijkstra and shadowcasting
+	// ones, usually) and EvaluatePreparedQuery scores; both only read what was prepared, and can run on any thread.
+	// Back on the game thread, CacheBuiltLayers shares what was built with everyone else
+	bool PrepareQuery(UGAPathComponent* PathComponent, const FGASpatialQuery& Query, FGAPreparedSpatialQuery& PreparedOut);
+	static void BuildPendingLayers(FGAPreparedSpatialQuery& Prepared);
+	static bool EvaluatePreparedQuery(const FGAPreparedSpatialQuery& Prepared, FCellRef& BestCellOut, FGAGridMap* ScoreMapOut = nullptr);
+	void CacheBuiltLayers(const AGAGridActor* Grid, const FGAPreparedSpatialQuery& Prepared);
+
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Find Best Cell"))
+	bool K2_FindBestCell(UGAPathComponent* PathComponent, const FGASpatialQuery& Query, FCellRef& BestCellOut, FVector& BestPointOut);
+
+	// Returns the given layer as seen from SourceCell, computing it if it isn't cached.
+	// The reference is good until the end of the frame
+	const FGAGridMap& GetLayer(const AGAGridActor* Grid, EGASpatialLayer Layer, const FCellRef& SourceCell);
+	FGAGridMapHandle GetLayerHandle(const AGAGridActor* Grid, EGASpatialLayer Layer, const FCellRef& SourceCell);
+
+	// How many times a layer was reused rather than recomputed (from this frame or the shared cache), since the subsystem started
+	int32 GetLayerReuseCount() const { return LayerReuseCount; }
+
+	FGAGridMapCache& GetLayerCache() { return LayerCache; }
+
+protected:
+	// Computes a layer from scratch into LayerOut, from Cells (the live grid's, or a snapshot of them). Touches nothing
+	// else, so it's safe to call from a cache miss or another thread. Not for GASL_Threat, see ComputeThreatLayer
+	static void ComputeLayer(const AGAGridActor* Grid, const GACore::FGridView& Cells, EGASpatialLayer Layer, const FCellRef& SourceCell, FGAGridMap& LayerOut);
+
+	// A copy of the influence map's Threat channel. Game thread only
+	void ComputeThreatLayer(const AGAGridActor* Grid, FGAGridMap& LayerOut) const;
+
+	// Can this layer be built by BuildPendingLayers? The others are kept by (or read from) the game thread
+	static bool CanBuildOffGameThread(EGASpatialLayer Layer);
+
+	// The layer if it's pinned this frame or in the shared cache, without computing it
+	FGAGridMapHandle FindLayerHandle(const AGAGridActor* Grid, EGASpatialLayer Layer, const FCellRef& SourceCell);
+
+	// Moves TargetPathDistance's source to SourceCell (starting over if the grid changed) and repairs it
+	FGAGridMapHandle UpdateTargetPathDistance(const AGAGridActor* Grid, const FCellRef& SourceCell);
+
+	// Listen for changes to a grid we've cached layers for
+	void BindGrid(const AGAGridActor* Grid);
+	void OnGridCellsChanged(const FIntRect& DirtyRect, TWeakObjectPtr<const AGAGridActor> WeakGrid);
+
+	// Could an overlay change over DirtyRect have changed this layer? Conservative
+	static bool IsLayerAffected(EGASpatialLayer Layer, const FGAGridMap& Map, const FIntRect& DirtyRect);
+
+	FGAGridMapCache LayerCache;
+
+	struct FBoundGrid
+	{
+		TWeakObjectPtr<const AGAGridActor> Grid;
+		FObjectKey GridKey;
+		FDelegateHandle CellsChangedHandle;
+		uint32 DataVersion = 0;
+	};
+	TArray<FBoundGrid> BoundGrids;
+
+	// Layers used this frame. Holding the handles keeps the maps alive even if the cache evicts them meanwhile
+	TMap<FGAGridMapCacheKey, FGAGridMapHandle> FrameLayers;
+	uint64 FrameLayersFrame = 0;
+	int32 LayerReuseCount = 0;
+
+	// The path distance from the target is repaired incrementally as the target moves between cells or the grid
+	// changes, rather than flooded from scratch. Its layer is handed out straight from the map, not the shared cache
+	FGADynamicDistanceMap TargetPathDistance;
+};
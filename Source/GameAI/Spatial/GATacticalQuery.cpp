@@ -0,0 +1,642 @@
+#include "GATacticalQuery.h"
+
+#include "Algo/StableSort.h"
+#include "GASpatialEvaluator.h"
+#include "GameAI/GameAIStats.h"
+
+
+float FGATacticalTest::GetScore(float Value) const
+{
+	float Range = ScoreMax - ScoreMin;
+	float T = (Range != 0.0f) ? FMath::Clamp((Value - ScoreMin) / Range, 0.0f, 1.0f) : (Value >= ScoreMax ? 1.0f : 0.0f);
+	return Weight * (Curve.Points.Num() > 0 ? Curve.Evaluate(T) : T);
+}
+
+void FGATacticalTest::GetScoreBounds(float& MinOut, float& MaxOut) const
+{
+	// The curve is piecewise linear, so over [0, 1] its extremes are at the ends or at one of its points
+	float CurveMin = 0.0f;
+	float CurveMax = 1.0f;
+	if (Curve.Points.Num() > 0)
+	{
+		CurveMin = FMath::Min(Curve.Evaluate(0.0f), Curve.Evaluate(1.0f));
+		CurveMax = FMath::Max(Curve.Evaluate(0.0f), Curve.Evaluate(1.0f));
+		for (const FVector2D& Point : Curve.Points)
+		{
+			if (Point.X > 0.0f && Point.X < 1.0f)
+			{
+				CurveMin = FMath::Min(CurveMin, float(Point.Y));
+				CurveMax = FMath::Max(CurveMax, float(Point.Y));
+			}
+		}
+	}
+
+	MinOut = Weight * (Weight >= 0.0f ? CurveMin : CurveMax);
+	MaxOut = Weight * (Weight >= 0.0f ? CurveMax : CurveMin);
+}
+
+
+TStatId UGATacticalQuerySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGATacticalQuerySubsystem, STATGROUP_Tickables);
+}
+
+bool UGATacticalQuerySubsystem::InitInstance(FGATacticalQueryInstance& Instance, const UGATacticalQuery* Query, UGAPathComponent* PathComponent, const FVector& TargetPoint) const
+{
+	const AGAGridActor* Grid = PathComponent ? PathComponent->GetGridActor() : nullptr;
+	if (!Query || !Grid || !PathComponent->GetOwnerPawn())
+	{
+		return false;
+	}
+
+	Instance.PathComponent = PathComponent;
+	Instance.Grid = Grid;
+	Instance.Generator = Query->Generator;
+	Instance.MaxResults = FMath::Max(Query->MaxResults, 1);
+	Instance.TargetPoint = TargetPoint;
+
+	// Filters first, so the scoring passes only see survivors. Within each group, cheapest first
+	Instance.Tests = Query->Tests;
+	Algo::StableSort(Instance.Tests, [](const FGATacticalTest& A, const FGATacticalTest& B)
+	{
+		if (A.IsFilter() != B.IsFilter())
+		{
+			return A.IsFilter();
+		}
+		return A.Type < B.Type;
+	});
+
+	int32 TestCount = Instance.Tests.Num();
+	Instance.RemainingMax.SetNumZeroed(TestCount + 1);
+	Instance.RemainingMin.SetNumZeroed(TestCount + 1);
+	for (int32 TestIndex = TestCount - 1; TestIndex >= 0; TestIndex--)
+	{
+		float Min = 0.0f;
+		float Max = 0.0f;
+		if (Instance.Tests[TestIndex].IsScore())
+		{
+			Instance.Tests[TestIndex].GetScoreBounds(Min, Max);
+		}
+		Instance.RemainingMin[TestIndex] = Instance.RemainingMin[TestIndex + 1] + Min;
+		Instance.RemainingMax[TestIndex] = Instance.RemainingMax[TestIndex + 1] + Max;
+	}
+
+	Instance.Step = FGATacticalQueryInstance::EStep::Generate;
+	return true;
+}
+
+int32 UGATacticalQuerySubsystem::RunQuery(const UGATacticalQuery* Query, UGAPathComponent* PathComponent, const FVector& TargetPoint, FGATacticalQueryCallback OnFinished)
+{
+	TUniquePtr<FGATacticalQueryInstance> Instance = MakeUnique<FGATacticalQueryInstance>();
+	if (!InitInstance(*Instance, Query, PathComponent, TargetPoint))
+	{
+		return INDEX_NONE;
+	}
+
+	Instance->QueryId = NextQueryId++;
+	Instance->OnFinished = MoveTemp(OnFinished);
+
+	// Only queries that span frames can see the grid change under them, so RunQueryImmediate doesn't bother
+	Instance->CellsChangedHandle = Instance->Grid->OnCellsChanged.AddUObject(this, &UGATacticalQuerySubsystem::OnGridCellsChanged, Instance->QueryId);
+
+	int32 QueryId = Instance->QueryId;
+	Queries.Add(MoveTemp(Instance));
+	return QueryId;
+}
+
+bool UGATacticalQuerySubsystem::RunQueryImmediate(const UGATacticalQuery* Query, UGAPathComponent* PathComponent, const FVector& TargetPoint, FGATacticalQueryResult& ResultOut)
+{
+	ResultOut = FGATacticalQueryResult();
+
+	FGATacticalQueryInstance Instance;
+	if (!InitInstance(Instance, Query, PathComponent, TargetPoint))
+	{
+		return false;
+	}
+
+	StepInstance(Instance, DBL_MAX);
+	ResultOut = MoveTemp(Instance.Result);
+	return ResultOut.bSuccess;
+}
+
+void UGATacticalQuerySubsystem::AbortQuery(int32 QueryId)
+{
+	Queries.RemoveAll([this, QueryId](const TUniquePtr<FGATacticalQueryInstance>& Instance)
+	{
+		if (Instance->QueryId != QueryId)
+		{
+			return false;
+		}
+		UnbindInstance(*Instance);
+		return true;
+	});
+}
+
+void UGATacticalQuerySubsystem::Deinitialize()
+{
+	for (const TUniquePtr<FGATacticalQueryInstance>& Instance : Queries)
+	{
+		UnbindInstance(*Instance);
+	}
+	Queries.Reset();
+
+	Super::Deinitialize();
+}
+
+void UGATacticalQuerySubsystem::UnbindInstance(FGATacticalQueryInstance& Instance) const
+{
+	if (const AGAGridActor* Grid = Instance.Grid.Get())
+	{
+		Grid->OnCellsChanged.Remove(Instance.CellsChangedHandle);
+	}
+	Instance.CellsChangedHandle.Reset();
+}
+
+void UGATacticalQuerySubsystem::OnGridCellsChanged(const FIntRect& DirtyRect, int32 QueryId)
+{
+	typedef FGATacticalQueryInstance::EStep EStep;
+
+	for (const TUniquePtr<FGATacticalQueryInstance>& Instance : Queries)
+	{
+		if (Instance->QueryId != QueryId)
+		{
+			continue;
+		}
+
+		// Before Generate there's nothing to throw away. Both rects are inclusive
+		const FIntRect& Window = Instance->Window;
+		if (Instance->Step != EStep::Generate && Instance->Step != EStep::Done
+			&& DirtyRect.Min.X <= Window.Max.X && DirtyRect.Max.X >= Window.Min.X
+			&& DirtyRect.Min.Y <= Window.Max.Y && DirtyRect.Max.Y >= Window.Min.Y)
+		{
+			Instance->bWindowChanged = true;
+		}
+		return;
+	}
+}
+
+void UGATacticalQuerySubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GameAI_TacticalQuery);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UGATacticalQuerySubsystem::Tick);
+
+	Super::Tick(DeltaTime);
+
+	double EndTime = FPlatformTime::Seconds() + TimeBudgetMs * 0.001;
+
+	// Oldest first, so nobody starves
+	while (Queries.Num() > 0)
+	{
+		if (!StepInstance(*Queries[0], EndTime))
+		{
+			break;
+		}
+
+		// Out of the list before the callback, which may well start another query
+		TUniquePtr<FGATacticalQueryInstance> Finished = MoveTemp(Queries[0]);
+		Queries.RemoveAt(0);
+		UnbindInstance(*Finished);
+
+		if (Finished->OnFinished)
+		{
+			Finished->OnFinished(Finished->Result);
+		}
+
+		if (FPlatformTime::Seconds() >= EndTime)
+		{
+			break;
+		}
+	}
+}
+
+bool UGATacticalQuerySubsystem::StepInstance(FGATacticalQueryInstance& Instance, double EndTime)
+{
+	typedef FGATacticalQueryInstance::EStep EStep;
+
+	const AGAGridActor* Grid = Instance.Grid.Get();
+	if (!Grid || !Instance.PathComponent.IsValid())
+	{
+		Instance.Result = FGATacticalQueryResult();
+		Instance.Step = EStep::Done;
+		return true;
+	}
+
+	// Candidates and layers from before a change over the query's window are no good. Start over, within reason
+	if (Instance.bWindowChanged)
+	{
+		Instance.bWindowChanged = false;
+		if (Instance.Step != EStep::Generate && Instance.Step != EStep::Done && Instance.Restarts < MaxRestarts)
+		{
+			Instance.Restarts++;
+			Instance.Step = EStep::Generate;
+		}
+	}
+
+	UGASpatialEvaluatorSubsystem* Evaluator = GetWorld() ? GetWorld()->GetSubsystem<UGASpatialEvaluatorSubsystem>() : nullptr;
+
+	while (Instance.Step != EStep::Done)
+	{
+		switch (Instance.Step)
+		{
+		case EStep::Generate:
+		{
+			Generate(Instance, Grid);
+			Instance.Step = EStep::FetchLayers;
+			Instance.TestIndex = 0;
+			break;
+		}
+
+		case EStep::FetchLayers:
+		{
+			// One layer per step; a layer that isn't cached is a whole-grid pass
+			if (Instance.TestIndex >= Instance.Tests.Num())
+			{
+				Instance.Step = EStep::RunTests;
+				Instance.TestIndex = 0;
+				Instance.Cursor = 0;
+				break;
+			}
+
+			const FGATacticalTest& Test = Instance.Tests[Instance.TestIndex];
+			if (Evaluator && Test.Type == GATT_TargetLOS)
+			{
+				Instance.TestLayers[Instance.TestIndex] = Evaluator->GetLayerHandle(Grid, GASL_TargetLOS, Instance.TargetCell);
+			}
+			else if (Evaluator && Test.Type == GATT_PathDistance && !Instance.bReachableFromAgent)
+			{
+				Instance.TestLayers[Instance.TestIndex] = Evaluator->GetLayerHandle(Grid, GASL_AgentPathDistance, Instance.AgentCell);
+			}
+			Instance.TestIndex++;
+			break;
+		}
+
+		case EStep::RunTests:
+		{
+			int32 Count = Instance.CellX.Num();
+			if (Instance.TestIndex >= Instance.Tests.Num() || Count == 0)
+			{
+				Finish(Instance, Grid);
+				Instance.Step = EStep::Done;
+				break;
+			}
+
+			const FGATacticalTest& Test = Instance.Tests[Instance.TestIndex];
+			int32 Begin = Instance.Cursor;
+			int32 End = FMath::Min(Begin + FMath::Max(ChunkSize, 1), Count);
+
+			// One batched pass over the chunk's values, then filter and score from them
+			EvaluateTest(Instance, Grid, Test, Begin, End, Instance.Values.GetData());
+
+			const float* Values = Instance.Values.GetData();
+			uint8* Keep = Instance.Keep.GetData();
+			float* Scores = Instance.Scores.GetData();
+
+			if (Test.IsFilter())
+			{
+				for (int32 Index = Begin; Index < End; Index++)
+				{
+					Keep[Index] = (Values[Index] >= Test.FilterMin && Values[Index] <= Test.FilterMax) ? 1 : 0;
+				}
+			}
+
+			if (Test.IsScore())
+			{
+				for (int32 Index = Begin; Index < End; Index++)
+				{
+					Scores[Index] += Test.GetScore(Values[Index]);
+				}
+			}
+
+			Instance.Cursor = End;
+			if (End == Count)
+			{
+				FinishTest(Instance);
+				Instance.TestIndex++;
+				Instance.Cursor = 0;
+			}
+			break;
+		}
+
+		default:
+			break;
+		}
+
+		if (Instance.Step != EStep::Done && FPlatformTime::Seconds() >= EndTime)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UGATacticalQuerySubsystem::Generate(FGATacticalQueryInstance& Instance, const AGAGridActor* Grid) const
+{
+	UGAPathComponent* PathComponent = Instance.PathComponent.Get();
+	APawn* Pawn = PathComponent->GetOwnerPawn();
+
+	Instance.AgentCell = Pawn ? Grid->GetCellRef(Pawn->GetActorLocation(), true) : FCellRef::Invalid;
+	Instance.TargetCell = Grid->GetCellRef(Instance.TargetPoint, true);
+	Instance.TestLayers.Reset();
+	Instance.TestLayers.SetNum(Instance.Tests.Num());
+	Instance.bReachableFromAgent = false;
+	Instance.Result = FGATacticalQueryResult();
+	Instance.CellX.Reset();
+	Instance.CellY.Reset();
+
+	const FGATacticalGeneratorSettings& Generator = Instance.Generator;
+	FCellRef Center = Generator.bAroundTarget ? Instance.TargetCell : Instance.AgentCell;
+	if (!Center.IsValid())
+	{
+		return;
+	}
+
+	switch (Generator.Type)
+	{
+	case GATG_Ring:
+	case GATG_Rect:
+	{
+		bool bRing = (Generator.Type == GATG_Ring);
+		int32 Extent = bRing ? FMath::CeilToInt(Generator.OuterRadius) : Generator.HalfExtent;
+		float InnerSquared = FMath::Square(Generator.InnerRadius);
+		float OuterSquared = FMath::Square(Generator.OuterRadius);
+
+		int32 MinX = FMath::Max(Center.X - Extent, 0);
+		int32 MaxX = FMath::Min(Center.X + Extent, Grid->XCount - 1);
+		int32 MinY = FMath::Max(Center.Y - Extent, 0);
+		int32 MaxY = FMath::Min(Center.Y + Extent, Grid->YCount - 1);
+
+		for (int32 Y = MinY; Y <= MaxY; Y++)
+		{
+			for (int32 X = MinX; X <= MaxX; X++)
+			{
+				if (bRing)
+				{
+					float DistanceSquared = float(FMath::Square(X - Center.X) + FMath::Square(Y - Center.Y));
+					if (DistanceSquared < InnerSquared || DistanceSquared > OuterSquared)
+					{
+						continue;
+					}
+				}
+
+				if (Grid->IsCellTraversable(FCellRef(X, Y)))
+				{
+					Instance.CellX.Add(X);
+					Instance.CellY.Add(Y);
+				}
+			}
+		}
+		break;
+	}
+
+	case GATG_Reachable:
+	{
+		// No limit floods everything reachable, which is all the cells left at less than INFINITY
+		const float MaxDistance = (Generator.MaxPathDistance > 0) ? float(Generator.MaxPathDistance) : BIG_NUMBER;
+		if (!PathComponent->DijkstraBounded(Center, Grid, Instance.Reachable, FMath::Max(Generator.MaxPathDistance, 0)))
+		{
+			break;
+		}
+
+		const FGAGridMap& DistanceMap = *Instance.Reachable.DistanceMap;
+		const float* Distances = DistanceMap.Data.GetData();
+		int32 Width = FGAGridMapOps::GetRowWidth(DistanceMap);
+		for (int32 Index = 0; Index < DistanceMap.Data.Num(); Index++)
+		{
+			if (Distances[Index] <= MaxDistance)
+			{
+				Instance.CellX.Add(DistanceMap.GridBounds.MinX + Index % Width);
+				Instance.CellY.Add(DistanceMap.GridBounds.MinY + Index / Width);
+			}
+		}
+
+		// Path distance tests can read straight out of this
+		Instance.bReachableFromAgent = !Generator.bAroundTarget;
+		break;
+	}
+	}
+
+	int32 Count = Instance.CellX.Num();
+	Instance.Scores.SetNumZeroed(Count);
+	Instance.Values.SetNumUninitialized(Count);
+	Instance.Keep.Init(1, Count);
+	Instance.Result.CandidatesGenerated = Count;
+
+	// Everything the tests read: the candidates, the agent and target (line of sight to the target stays within
+	// the box spanning both), plus the clearance rings around the candidates. Path distances could in principle
+	// take a detour outside it; a change that far out is left for the next query. A reachable flood covers every
+	// cell a path within its limit can use
+	FIntRect& Window = Instance.Window;
+	Window = FIntRect(Center.X, Center.Y, Center.X, Center.Y);
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		Window.Include(FIntPoint(Instance.CellX[Index], Instance.CellY[Index]));
+	}
+	for (const FCellRef& CellRef : { Instance.AgentCell, Instance.TargetCell })
+	{
+		if (CellRef.IsValid())
+		{
+			Window.Include(FIntPoint(CellRef.X, CellRef.Y));
+		}
+	}
+
+	int32 Clearance = 0;
+	for (const FGATacticalTest& Test : Instance.Tests)
+	{
+		Clearance = (Test.Type == GATT_Clearance) ? FMath::Max(Clearance, Test.ClearanceRadius) : Clearance;
+	}
+	Window.Min -= FIntPoint(Clearance, Clearance);
+	Window.Max += FIntPoint(Clearance, Clearance);
+
+	if (Generator.Type == GATG_Reachable && Instance.Reachable.DistanceMap.Get())
+	{
+		const FGridBox& Bounds = Instance.Reachable.DistanceMap->GridBounds;
+		Window.Include(FIntPoint(Bounds.MinX, Bounds.MinY));
+		Window.Include(FIntPoint(Bounds.MaxX, Bounds.MaxY));
+	}
+}
+
+// Rings of free cells around the cell, up to Radius. Off the grid counts as blocked
+static float GetClearance(const AGAGridActor* Grid, int32 X, int32 Y, int32 Radius)
+{
+	for (int32 Ring = 1; Ring <= Radius; Ring++)
+	{
+		for (int32 DY = -Ring; DY <= Ring; DY++)
+		{
+			// Only the ring's edge: every cell on the top and bottom rows, the two end cells on the others
+			int32 Step = (DY == -Ring || DY == Ring) ? 1 : 2 * Ring;
+			for (int32 DX = -Ring; DX <= Ring; DX += Step)
+			{
+				int32 CX = X + DX;
+				int32 CY = Y + DY;
+				if (CX < 0 || CY < 0 || CX >= Grid->XCount || CY >= Grid->YCount || !Grid->IsCellTraversable(FCellRef(CX, CY)))
+				{
+					return float(Ring - 1);
+				}
+			}
+		}
+	}
+
+	return float(Radius);
+}
+
+// Value of a full-grid layer at a cell, Default if the layer is missing or doesn't cover it
+static FORCEINLINE float GetLayerValue(const FGAGridMap* Layer, int32 X, int32 Y, float Default)
+{
+	FCellRef CellRef(X, Y);
+	return (Layer && FGAGridMapOps::IsInBounds(*Layer, CellRef)) ? Layer->Data[FGAGridMapOps::CellRefToIndex(*Layer, CellRef)] : Default;
+}
+
+void UGATacticalQuerySubsystem::EvaluateTest(const FGATacticalQueryInstance& Instance, const AGAGridActor* Grid, const FGATacticalTest& Test, int32 Begin, int32 End, float* ValuesOut) const
+{
+	const int32* CellX = Instance.CellX.GetData();
+	const int32* CellY = Instance.CellY.GetData();
+	const FGAGridMap* Layer = Instance.TestLayers[Instance.TestIndex].Get();
+
+	switch (Test.Type)
+	{
+	case GATT_TargetDistance:
+	{
+		float TargetX = float(Instance.TargetCell.X);
+		float TargetY = float(Instance.TargetCell.Y);
+		for (int32 Index = Begin; Index < End; Index++)
+		{
+			float DX = float(CellX[Index]) - TargetX;
+			float DY = float(CellY[Index]) - TargetY;
+			ValuesOut[Index] = FMath::Sqrt(DX * DX + DY * DY);
+		}
+		break;
+	}
+
+	case GATT_Clearance:
+	{
+		for (int32 Index = Begin; Index < End; Index++)
+		{
+			ValuesOut[Index] = GetClearance(Grid, CellX[Index], CellY[Index], Test.ClearanceRadius);
+		}
+		break;
+	}
+
+	case GATT_TargetLOS:
+	{
+		for (int32 Index = Begin; Index < End; Index++)
+		{
+			ValuesOut[Index] = GetLayerValue(Layer, CellX[Index], CellY[Index], 0.0f);
+		}
+		break;
+	}
+
+	case GATT_PathDistance:
+	{
+		if (Instance.bReachableFromAgent)
+		{
+			Layer = Instance.Reachable.DistanceMap.Get();
+		}
+
+		for (int32 Index = Begin; Index < End; Index++)
+		{
+			ValuesOut[Index] = GetLayerValue(Layer, CellX[Index], CellY[Index], INFINITY);
+		}
+		break;
+	}
+	}
+}
+
+void UGATacticalQuerySubsystem::FinishTest(FGATacticalQueryInstance& Instance) const
+{
+	const FGATacticalTest& Test = Instance.Tests[Instance.TestIndex];
+	int32 Count = Instance.CellX.Num();
+	uint8* Keep = Instance.Keep.GetData();
+	float* Scores = Instance.Scores.GetData();
+
+	// Drop candidates that can't make the top MaxResults whatever the remaining tests say. The MaxResults-th best
+	// guaranteed score (current score plus the least the remaining tests can add) is the bar to clear
+	if (Test.IsScore() && Instance.TestIndex + 1 < Instance.Tests.Num())
+	{
+		float RemainingMin = Instance.RemainingMin[Instance.TestIndex + 1];
+		float RemainingMax = Instance.RemainingMax[Instance.TestIndex + 1];
+
+		TArray<float> Guaranteed;
+		Guaranteed.Reserve(Count);
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			if (Keep[Index])
+			{
+				Guaranteed.Add(Scores[Index] + RemainingMin);
+			}
+		}
+
+		if (Guaranteed.Num() > Instance.MaxResults)
+		{
+			float Bar;
+			if (Instance.MaxResults == 1)
+			{
+				Bar = FMath::Max(Guaranteed);
+			}
+			else
+			{
+				Guaranteed.Sort(TGreater<float>());
+				Bar = Guaranteed[Instance.MaxResults - 1];
+			}
+
+			for (int32 Index = 0; Index < Count; Index++)
+			{
+				if (Keep[Index] && Scores[Index] + RemainingMax < Bar)
+				{
+					Keep[Index] = 0;
+					Instance.Result.CandidatesPruned++;
+				}
+			}
+		}
+	}
+
+	// Compact the survivors
+	int32 Write = 0;
+	for (int32 Read = 0; Read < Count; Read++)
+	{
+		if (Keep[Read])
+		{
+			Instance.CellX[Write] = Instance.CellX[Read];
+			Instance.CellY[Write] = Instance.CellY[Read];
+			Instance.Scores[Write] = Instance.Scores[Read];
+			Write++;
+		}
+	}
+
+	Instance.CellX.SetNum(Write, EAllowShrinking::No);
+	Instance.CellY.SetNum(Write, EAllowShrinking::No);
+	Instance.Scores.SetNum(Write, EAllowShrinking::No);
+	Instance.Values.SetNum(Write, EAllowShrinking::No);
+	Instance.Keep.Init(1, Write);
+}
+
+void UGATacticalQuerySubsystem::Finish(FGATacticalQueryInstance& Instance, const AGAGridActor* Grid) const
+{
+	int32 Count = Instance.CellX.Num();
+
+	// Ties go to the earlier candidate, so the result doesn't depend on anything but the grid
+	TArray<int32> Order;
+	Order.SetNumUninitialized(Count);
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		Order[Index] = Index;
+	}
+
+	const TArray<float>& Scores = Instance.Scores;
+	Order.Sort([&Scores](int32 A, int32 B)
+	{
+		return Scores[A] > Scores[B] || (Scores[A] == Scores[B] && A < B);
+	});
+
+	FGATacticalQueryResult& Result = Instance.Result;
+	int32 ResultCount = FMath::Min(Count, Instance.MaxResults);
+	for (int32 Rank = 0; Rank < ResultCount; Rank++)
+	{
+		Result.Cells.Add(FCellRef(Instance.CellX[Order[Rank]], Instance.CellY[Order[Rank]]));
+		Result.Scores.Add(Scores[Order[Rank]]);
+	}
+
+	Grid->GetCellPositions(Result.Cells, Result.Points);
+	Result.Restarts = Instance.Restarts;
+	Result.bSuccess = ResultCount > 0;
+}
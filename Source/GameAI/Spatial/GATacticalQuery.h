@@ -0,0 +1,288 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameAI/Grid/GAGridActor.h"
+#include "GameAI/Grid/GAGridMapOps.h"
+#include "GameAI/Grid/GAGridMapCache.h"
+#include "GameAI/Pathfinding/GAPathComponent.h"
+#include "GATacticalQuery.generated.h"
+
+
+// Where a tactical query's candidate cells come from
+UENUM(BlueprintType)
+enum EGATacticalGenerator
+{
+	GATG_Ring			UMETA(DisplayName = "Ring"),					// Cells between InnerRadius and OuterRadius of the center
+	GATG_Rect			UMETA(DisplayName = "Rect"),					// Cells within HalfExtent of the center on both axes
+	GATG_Reachable		UMETA(DisplayName = "Reachable Within"),		// Cells within MaxPathDistance of the center by path
+};
+
+
+// What a test measures. Listed cheapest first; tests of the same purpose run in this order
+UENUM(BlueprintType)
+enum EGATacticalTestType
+{
+	GATT_TargetDistance	UMETA(DisplayName = "Distance To Target"),		// Straight-line distance to the target, in cells
+	GATT_Clearance		UMETA(DisplayName = "Clearance"),				// Rings of free cells around the cell, up to ClearanceRadius
+	GATT_TargetLOS		UMETA(DisplayName = "Target LOS"),				// 1 if the target can see the cell, 0 if not
+	GATT_PathDistance	UMETA(DisplayName = "Agent Path Distance"),		// Path distance from the agent, in cells
+};
+
+
+UENUM(BlueprintType)
+enum class EGATacticalTestPurpose : uint8
+{
+	Filter,				// Drop candidates whose value is outside [FilterMin, FilterMax]
+	Score,				// Add Weight * Curve(normalized value) to the candidate's score
+	FilterAndScore,
+};
+
+
+USTRUCT(BlueprintType)
+struct FGATacticalGeneratorSettings
+{
+	GENERATED_BODY()
+
+	FGATacticalGeneratorSettings()
+		: Type(GATG_Ring), bAroundTarget(false), InnerRadius(0.0f), OuterRadius(10.0f), HalfExtent(10), MaxPathDistance(20) {}
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TEnumAsByte<EGATacticalGenerator> Type;
+
+	// Center the candidates on the target rather than the agent
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bAroundTarget;
+
+	// Ring radii, in cells
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float InnerRadius;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float OuterRadius;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 HalfExtent;
+
+	// In cells. <= 0 means no limit: every cell reachable from the center is a candidate
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MaxPathDistance;
+};
+
+
+USTRUCT(BlueprintType)
+struct FGATacticalTest
+{
+	GENERATED_BODY()
+
+	FGATacticalTest()
+		: Type(GATT_TargetDistance), Purpose(EGATacticalTestPurpose::Score), FilterMin(0.0f), FilterMax(BIG_NUMBER),
+		  ScoreMin(0.0f), ScoreMax(20.0f), Weight(1.0f), ClearanceRadius(3) {}
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TEnumAsByte<EGATacticalTestType> Type;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EGATacticalTestPurpose Purpose;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float FilterMin;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float FilterMax;
+
+	// The value is mapped from [ScoreMin, ScoreMax] to [0, 1] (and clamped) before the curve
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ScoreMin;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ScoreMax;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Weight;
+
+	// Optional, over [0, 1]. If empty, the normalized value is used
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FGAResponseCurve Curve;
+
+	// How far out the clearance test looks, in cells
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 ClearanceRadius;
+
+	bool IsFilter() const { return Purpose != EGATacticalTestPurpose::Score; }
+	bool IsScore() const { return Purpose != EGATacticalTestPurpose::Filter; }
+
+	float GetScore(float Value) const;
+
+	// The least and most GetScore can return
+	void GetScoreBounds(float& MinOut, float& MaxOut) const;
+};
+
+
+// A data-driven position query over the grid: generate candidate cells, filter them, score the survivors.
+// Authored as an asset, run through UGATacticalQuerySubsystem
+UCLASS(BlueprintType)
+class UGATacticalQuery : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FGATacticalGeneratorSettings Generator;
+
+	// Any order. They're run filters first, then cheapest first
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TArray<FGATacticalTest> Tests;
+
+	// How many of the best cells to return
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MaxResults = 1;
+};
+
+
+USTRUCT(BlueprintType)
+struct FGATacticalQueryResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bSuccess = false;
+
+	// Best first
+	UPROPERTY(BlueprintReadOnly)
+	TArray<FCellRef> Cells;
+
+	UPROPERTY(BlueprintReadOnly)
+	TArray<FVector> Points;
+
+	UPROPERTY(BlueprintReadOnly)
+	TArray<float> Scores;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 CandidatesGenerated = 0;
+
+	// Candidates dropped by the score bound before every test had run on them
+	UPROPERTY(BlueprintReadOnly)
+	int32 CandidatesPruned = 0;
+
+	// Times the query started over because the grid changed under it
+	UPROPERTY(BlueprintReadOnly)
+	int32 Restarts = 0;
+};
+
+typedef TFunction<void(const FGATacticalQueryResult&)> FGATacticalQueryCallback;
+
+
+// One query in flight. Candidates are kept as parallel arrays, compacted after every pass
+struct FGATacticalQueryInstance
+{
+	enum class EStep : uint8
+	{
+		Generate,
+		FetchLayers,
+		RunTests,
+		Done,
+	};
+
+	int32 QueryId = 0;
+	TWeakObjectPtr<UGAPathComponent> PathComponent;
+	TWeakObjectPtr<const AGAGridActor> Grid;
+	FDelegateHandle CellsChangedHandle;
+
+	// Cells (inclusive) the candidates and the tests read, worked out by Generate. A grid change over them sets
+	// bWindowChanged, and the query starts over at its next step, at most MaxRestarts times
+	FIntRect Window;
+	bool bWindowChanged = false;
+	int32 Restarts = 0;
+
+	FGATacticalGeneratorSettings Generator;
+	TArray<FGATacticalTest> Tests;
+	int32 MaxResults = 1;
+	FVector TargetPoint = FVector::ZeroVector;
+	FCellRef AgentCell;
+	FCellRef TargetCell;
+	FGATacticalQueryCallback OnFinished;
+
+	EStep Step = EStep::Generate;
+	int32 TestIndex = 0;
+	int32 Cursor = 0;
+
+	// One per test, for the tests that read a layer
+	TArray<FGAGridMapHandle> TestLayers;
+
+	// Kept from the reachable generator when it flooded from the agent, and used for path distance tests
+	FGADijkstraResult Reachable;
+	bool bReachableFromAgent = false;
+
+	// The most and least the tests after each index can still add to a score. RemainingMax[Tests.Num()] is 0
+	TArray<float> RemainingMax;
+	TArray<float> RemainingMin;
+
+	TArray<int32> CellX;
+	TArray<int32> CellY;
+	TArray<float> Scores;
+	TArray<float> Values;
+	TArray<uint8> Keep;
+
+	FGATacticalQueryResult Result;
+};
+
+
+// Runs tactical queries, time-sliced: each frame, queries advance (oldest first) until TimeBudgetMs is used up.
+// A query's tests each make one pass over all of its surviving candidates, a chunk at a time, so a query can
+// stop between chunks and carry on next frame. Filters run first, cheapest first, and compact the candidate
+// arrays as they go, so the expensive tests see as few candidates as possible. After each scoring pass,
+// candidates that couldn't reach the top MaxResults even with the best possible scores from the remaining
+// tests are dropped.
+// If the grid changes over the cells a query in flight reads, the query starts over. Changes elsewhere on the grid
+// leave it alone, and a query that keeps getting restarted finishes with what it has after MaxRestarts.
+UCLASS()
+class UGATacticalQuerySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Returns the query id, or INDEX_NONE if it couldn't start. OnFinished is called from a later Tick
+	int32 RunQuery(const UGATacticalQuery* Query, UGAPathComponent* PathComponent, const FVector& TargetPoint, FGATacticalQueryCallback OnFinished);
+
+	// Runs the whole query right now, ignoring the budget
+	UFUNCTION(BlueprintCallable)
+	bool RunQueryImmediate(const UGATacticalQuery* Query, UGAPathComponent* PathComponent, const FVector& TargetPoint, FGATacticalQueryResult& ResultOut);
+
+	// The callback won't be called
+	void AbortQuery(int32 QueryId);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float TimeBudgetMs = 1.0f;
+
+	// Candidates per test between budget checks
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 ChunkSize = 256;
+
+	// Times a query starts over because the grid changed under it. Past that it carries on with the candidates and
+	// layers it has, rather than chase a grid that never settles
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MaxRestarts = 2;
+
+protected:
+	bool InitInstance(FGATacticalQueryInstance& Instance, const UGATacticalQuery* Query, UGAPathComponent* PathComponent, const FVector& TargetPoint) const;
+
+	// Advances the query until it finishes or EndTime (FPlatformTime::Seconds) passes. Returns true once it's done
+	bool StepInstance(FGATacticalQueryInstance& Instance, double EndTime);
+
+	void Generate(FGATacticalQueryInstance& Instance, const AGAGridActor* Grid) const;
+	void EvaluateTest(const FGATacticalQueryInstance& Instance, const AGAGridActor* Grid, const FGATacticalTest& Test, int32 Begin, int32 End, float* ValuesOut) const;
+	void FinishTest(FGATacticalQueryInstance& Instance) const;
+	void Finish(FGATacticalQueryInstance& Instance, const AGAGridActor* Grid) const;
+
+	void OnGridCellsChanged(const FIntRect& DirtyRect, int32 QueryId);
+	void UnbindInstance(FGATacticalQueryInstance& Instance) const;
+
+	TArray<TUniquePtr<FGATacticalQueryInstance>> Queries;
+	int32 NextQueryId = 1;
+};
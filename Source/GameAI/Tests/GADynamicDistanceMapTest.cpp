@@ -0,0 +1,87 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GATestWorld.h"
+#include "GameAI/Pathfinding/GADynamicDistanceMap.h"
+#include "GameAI/Spatial/GASpatialEvaluator.h"
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGADynamicDistanceMapRepairTest, "GameAI.Pathfinding.DynamicDistanceMap.Repair",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGADynamicDistanceMapRepairTest::RunTest(const FString& Parameters)
+{
+	FGATestWorld TestWorld({
+		TEXT("........"),
+		TEXT(".######."),
+		TEXT("........"),
+		TEXT("........"),
+	});
+	AGAGridActor* Grid = TestWorld.Grid;
+
+	FGADynamicDistanceMap Map;
+	Map.Initialize(Grid, FCellRef(3, 0));
+	Map.BindToGrid();
+	TestTrue(TEXT("Initial flood matches Dijkstra"), Map.ValidateAgainstDijkstra());
+	TestEqual(TEXT("Around the wall"), Map.GetDistanceMap().Data[2 * 8 + 3], 8.0f);
+
+	// Hold on to the current distances: later repairs mustn't show through this handle
+	FGAGridMapHandle Snapshot = Map.GetDistanceMapHandle();
+
+	// Static change: open a gap in the wall
+	TestWorld.SetTraversable(3, 1, true);
+	Map.Update();
+	TestTrue(TEXT("Repair after a data change matches Dijkstra"), Map.ValidateAgainstDijkstra());
+	TestEqual(TEXT("Through the gap"), Map.GetDistanceMap().Data[2 * 8 + 3], 2.0f);
+	TestEqual(TEXT("Snapshot kept the old distance"), Snapshot->Data[2 * 8 + 3], 8.0f);
+
+	// Overlay change: block the gap again
+	AActor* Blocker = TestWorld.AddBlocker(3, 1);
+	Map.Update();
+	TestTrue(TEXT("Repair after an overlay change matches Dijkstra"), Map.ValidateAgainstDijkstra());
+
+	Grid->UnregisterOverlayActor(Blocker);
+	Map.SetSource(FCellRef(7, 3));
+	Map.Update();
+	TestTrue(TEXT("Repair after a source move matches Dijkstra"), Map.ValidateAgainstDijkstra());
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGATargetPathDistanceGridTest, "GameAI.Pathfinding.DynamicDistanceMap.GridIdentity",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGATargetPathDistanceGridTest::RunTest(const FString& Parameters)
+{
+	FGATestWorld TestWorld({
+		TEXT("...."),
+		TEXT("...."),
+	});
+	UGASpatialEvaluatorSubsystem* Evaluator = TestWorld.World->GetSubsystem<UGASpatialEvaluatorSubsystem>();
+	if (!TestNotNull(TEXT("Evaluator subsystem"), Evaluator))
+	{
+		return false;
+	}
+
+	// A second grid of the same size, with a wall the first one doesn't have
+	AGAGridActor* OtherGrid = TestWorld.World->SpawnActor<AGAGridActor>();
+	OtherGrid->ResizeGrid(4, 2, 100.0f);
+	for (int32 Index = 0; Index < 8; Index++)
+	{
+		OtherGrid->Data[Index] = (Index == 1) ? ECellData::CellDataNone : ECellData::CellDataTraversable;
+	}
+	OtherGrid->NotifyCellsChanged(FIntRect(0, 0, 3, 1));
+
+	const FCellRef Source(0, 0);
+	float OpenDistance = Evaluator->GetLayer(TestWorld.Grid, GASL_TargetPathDistance, Source).Data[2];
+	float WalledDistance = Evaluator->GetLayer(OtherGrid, GASL_TargetPathDistance, Source).Data[2];
+	TestEqual(TEXT("First grid"), OpenDistance, 2.0f);
+	TestEqual(TEXT("Second grid is flooded from scratch, not repaired from the first"), WalledDistance, 4.0f);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
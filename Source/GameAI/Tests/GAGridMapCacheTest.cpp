@@ -0,0 +1,58 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GATestWorld.h"
+#include "GameAI/Spatial/GASpatialEvaluator.h"
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGAGridMapCacheInvalidationTest, "GameAI.Grid.MapCache.Invalidation",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGAGridMapCacheInvalidationTest::RunTest(const FString& Parameters)
+{
+	// The wall keeps everything right of it out of reach from the left
+	FGATestWorld TestWorld({
+		TEXT("....#..."),
+		TEXT("....#..."),
+		TEXT("....#..."),
+		TEXT("....#..."),
+	});
+	AGAGridActor* Grid = TestWorld.Grid;
+	UGASpatialEvaluatorSubsystem* Evaluator = TestWorld.World->GetSubsystem<UGASpatialEvaluatorSubsystem>();
+	if (!TestNotNull(TEXT("Evaluator subsystem"), Evaluator))
+	{
+		return false;
+	}
+	FGAGridMapCache& Cache = Evaluator->GetLayerCache();
+
+	const FCellRef Source(0, 0);
+	const FGAGridMapCacheKey PathKey(Grid, int32(GASL_AgentPathDistance), Source);
+	const FGAGridMapCacheKey DistanceKey(Grid, int32(GASL_TargetDistance), Source);
+	Evaluator->GetLayerHandle(Grid, GASL_AgentPathDistance, Source);
+	Evaluator->GetLayerHandle(Grid, GASL_TargetDistance, Source);
+	TestEqual(TEXT("Both layers cached"), Cache.Num(), 2);
+
+	// Overlay change in space the flood never reached
+	TestWorld.AddBlocker(7, 2);
+	TestTrue(TEXT("Path layer survives an overlay change it can't see"), Cache.Find(PathKey).IsValid());
+
+	// Overlay change on the flooded side
+	TestWorld.AddBlocker(1, 1);
+	TestFalse(TEXT("Path layer is evicted by an overlay change it can see"), Cache.Find(PathKey).IsValid());
+	TestTrue(TEXT("Straight-line layer doesn't care about the overlay"), Cache.Find(DistanceKey).IsValid());
+
+	// A fresh map reflects the blocker
+	float Distance = Evaluator->GetLayerHandle(Grid, GASL_AgentPathDistance, Source)->Data[1 * 8 + 1];
+	TestTrue(TEXT("Recomputed with the blocker"), Distance >= BIG_NUMBER);
+
+	// Static change: everything for the grid goes
+	TestWorld.SetTraversable(4, 3, true);
+	TestEqual(TEXT("Data change empties the grid's entries"), Cache.Num(), 0);
+	TestNotEqual(TEXT("Keys move on with the data version"), FGAGridMapCacheKey(Grid, int32(GASL_TargetDistance), Source).DataVersion, DistanceKey.DataVersion);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,221 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GATestWorld.h"
+#include "GameAI/Grid/GAGridMapOps.h"
+#include "Math/RandomStream.h"
+
+
+namespace
+{
+	void FillRandom(FGAGridMap& Map, FRandomStream& Random, float MinValue, float MaxValue)
+	{
+		for (float& Value : Map.Data)
+		{
+			Value = Random.FRandRange(MinValue, MaxValue);
+		}
+	}
+
+	// How many of the values differ from the scalar version by more than Tolerance
+	int32 CountMismatches(const float* Actual, const TArray<float>& Expected, float Tolerance)
+	{
+		int32 Mismatches = 0;
+		for (int32 Index = 0; Index < Expected.Num(); Index++)
+		{
+			Mismatches += FMath::IsNearlyEqual(Actual[Index], Expected[Index], Tolerance) ? 0 : 1;
+		}
+		return Mismatches;
+	}
+
+	// First index of the max among the cells Mask lets through
+	int32 ScalarArgMax(const float* Data, const float* Mask, int32 Count, float& MaxValueOut)
+	{
+		int32 Best = INDEX_NONE;
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			if ((!Mask || Mask[Index] > 0.0f) && (Best == INDEX_NONE || Data[Index] > MaxValueOut))
+			{
+				MaxValueOut = Data[Index];
+				Best = Index;
+			}
+		}
+		return Best;
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGAGridMapOpsMatchesScalarTest, "GameAI.Grid.MapOps.MatchesScalar",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGAGridMapOpsMatchesScalarTest::RunTest(const FString& Parameters)
+{
+	FGATestWorld TestWorld({
+		TEXT("............."),
+		TEXT("............."),
+		TEXT("............."),
+		TEXT("............."),
+		TEXT("............."),
+		TEXT("............."),
+	});
+
+	// Odd widths, so every row (and the map as a whole) ends in a scalar tail. The last is all tail
+	const FGridBox Boxes[] = { FGridBox(1, 7, 0, 4), FGridBox(0, 12, 2, 4), FGridBox(3, 3, 0, 5) };
+
+	// A vertical step at 3, and inputs below and above the ends
+	FGAResponseCurve Curve;
+	Curve.Points = { FVector2D(0.0f, -2.0f), FVector2D(3.0f, 1.0f), FVector2D(3.0f, 4.0f), FVector2D(8.0f, 0.0f), FVector2D(10.0f, 0.5f) };
+
+	// The vector paths use fused multiply-adds where the platform has them, so allow for rounding
+	constexpr float Tolerance = 1.e-4f;
+
+	FRandomStream Random(4321);
+	for (const FGridBox& Box : Boxes)
+	{
+		FGAGridMap A(TestWorld.Grid, Box, 0.0f);
+		FGAGridMap B(TestWorld.Grid, Box, 0.0f);
+		FillRandom(A, Random, -10.0f, 10.0f);
+		FillRandom(B, Random, -10.0f, 10.0f);
+
+		const int32 Count = A.Data.Num();
+		const int32 Width = FGAGridMapOps::GetRowWidth(A);
+		const FString Name = FString::Printf(TEXT("%dx%d"), Width, Count / Width);
+		TArray<float> Expected;
+		Expected.SetNum(Count);
+		FGAGridMap Out;
+
+		auto Check = [&](const TCHAR* Op, const float* Actual)
+		{
+			TestEqual(FString::Printf(TEXT("%s %s mismatches"), *Name, Op), CountMismatches(Actual, Expected, Tolerance), 0);
+		};
+
+		TestTrue(TEXT("Add"), FGAGridMapOps::Add(Out, A, B));
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			Expected[Index] = A.Data[Index] + B.Data[Index];
+		}
+		Check(TEXT("Add"), Out.Data.GetData());
+
+		TestTrue(TEXT("AddScaled"), FGAGridMapOps::AddScaled(Out, A, B, -0.7f));
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			Expected[Index] = A.Data[Index] + B.Data[Index] * -0.7f;
+		}
+		Check(TEXT("AddScaled"), Out.Data.GetData());
+
+		TestTrue(TEXT("Multiply"), FGAGridMapOps::Multiply(Out, A, B));
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			Expected[Index] = A.Data[Index] * B.Data[Index];
+		}
+		Check(TEXT("Multiply"), Out.Data.GetData());
+
+		TestTrue(TEXT("Lerp"), FGAGridMapOps::Lerp(Out, A, B, 0.3f));
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			Expected[Index] = FMath::Lerp(A.Data[Index], B.Data[Index], 0.3f);
+		}
+		Check(TEXT("Lerp"), Out.Data.GetData());
+
+		Out = A;
+		FGAGridMapOps::Clamp(Out, -2.5f, 4.0f);
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			Expected[Index] = FMath::Clamp(A.Data[Index], -2.5f, 4.0f);
+		}
+		Check(TEXT("Clamp"), Out.Data.GetData());
+
+		// A few cells out of range, which should be left alone
+		Out = A;
+		Out.Data[0] = BIG_NUMBER;
+		Out.Data[Count - 1] = BIG_NUMBER;
+		float MinValue = BIG_NUMBER;
+		float MaxValue = -BIG_NUMBER;
+		for (float Value : Out.Data)
+		{
+			if (Value < BIG_NUMBER)
+			{
+				MinValue = FMath::Min(MinValue, Value);
+				MaxValue = FMath::Max(MaxValue, Value);
+			}
+		}
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			Expected[Index] = (Out.Data[Index] < BIG_NUMBER) ? (Out.Data[Index] - MinValue) / (MaxValue - MinValue) : BIG_NUMBER;
+		}
+		FGAGridMapOps::Normalize(Out);
+		Check(TEXT("Normalize"), Out.Data.GetData());
+
+		// Spread over the curve and past both ends, with some inputs right on its points
+		Out = A;
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			Out.Data[Index] = (Index % 5 == 0) ? Curve.Points[(Index / 5) % Curve.Points.Num()].X : Random.FRandRange(-5.0f, 15.0f);
+			Expected[Index] = Curve.Evaluate(Out.Data[Index]);
+		}
+		FGAGridMap Curved = Out;
+		FGAGridMapOps::ApplyResponseCurve(Curved, Curve);
+		Check(TEXT("ApplyResponseCurve"), Curved.Data.GetData());
+
+		// The same a row at a time, so the tails fall at the end of every row
+		TArray<float> Rows = Out.Data;
+		for (int32 RowStart = 0; RowStart < Count; RowStart += Width)
+		{
+			FGAGridMapOps::ApplyResponseCurve(Rows.GetData() + RowStart, Width, Curve);
+		}
+		Check(TEXT("ApplyResponseCurve by row"), Rows.GetData());
+
+		Rows = A.Data;
+		for (int32 RowStart = 0; RowStart < Count; RowStart += Width)
+		{
+			FGAGridMapOps::AddScaled(Rows.GetData() + RowStart, Rows.GetData() + RowStart, B.Data.GetData() + RowStart, 2.5f, Width);
+		}
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			Expected[Index] = A.Data[Index] + B.Data[Index] * 2.5f;
+		}
+		Check(TEXT("AddScaled by row"), Rows.GetData());
+
+		// Few distinct values, so there are plenty of ties for the lowest index to win
+		FGAGridMap Mask(TestWorld.Grid, Box, 0.0f);
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			Out.Data[Index] = float(Random.RandRange(0, 3));
+			Mask.Data[Index] = float(Random.RandRange(0, 1));
+		}
+
+		for (int32 Pass = 0; Pass < 2; Pass++)
+		{
+			const FGAGridMap* MaskToUse = (Pass == 0) ? &Mask : nullptr;
+			const TCHAR* MaskName = MaskToUse ? TEXT("masked") : TEXT("unmasked");
+			float ExpectedMax = 0.0f;
+			float ActualMax = 0.0f;
+			FCellRef ActualCell;
+			const int32 ExpectedIndex = ScalarArgMax(Out.Data.GetData(), MaskToUse ? Mask.Data.GetData() : nullptr, Count, ExpectedMax);
+			const bool bFound = FGAGridMapOps::MaskedMax(Out, MaskToUse, ActualMax, ActualCell);
+			TestEqual(FString::Printf(TEXT("%s MaskedMax %s found"), *Name, MaskName), bFound, ExpectedIndex != INDEX_NONE);
+			if (bFound && ExpectedIndex != INDEX_NONE)
+			{
+				TestEqual(FString::Printf(TEXT("%s MaskedMax %s value"), *Name, MaskName), ActualMax, ExpectedMax);
+				TestTrue(FString::Printf(TEXT("%s MaskedMax %s cell"), *Name, MaskName), ActualCell == FGAGridMapOps::IndexToCellRef(Out, ExpectedIndex));
+			}
+		}
+
+		for (int32 RowStart = 0; RowStart < Count; RowStart += Width)
+		{
+			float ExpectedMax = 0.0f;
+			float ActualMax = 0.0f;
+			const int32 ExpectedIndex = ScalarArgMax(Out.Data.GetData() + RowStart, nullptr, Width, ExpectedMax);
+			TestEqual(FString::Printf(TEXT("%s ArgMax row %d"), *Name, RowStart / Width), FGAGridMapOps::ArgMax(Out.Data.GetData() + RowStart, Width, ActualMax), ExpectedIndex);
+			TestEqual(FString::Printf(TEXT("%s ArgMax row %d value"), *Name, RowStart / Width), ActualMax, ExpectedMax);
+		}
+	}
+
+	float Unused = 0.0f;
+	TestEqual(TEXT("ArgMax of nothing"), FGAGridMapOps::ArgMax(nullptr, 0, Unused), int32(INDEX_NONE));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,160 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GATestWorld.h"
+#include "GameAI/Grid/GAGridMapPyramid.h"
+#include "Math/RandomStream.h"
+
+
+namespace
+{
+	// Brute-force best cell of the map among those Accept lets through, ignoring values >= IgnoreValue
+	bool FindMaxByScan(const FGAGridMap& Map, float IgnoreValue, TFunctionRef<bool(int32 X, int32 Y)> Accept, float& MaxValueOut, FCellRef& CellOut)
+	{
+		const int32 Width = Map.GridBounds.MaxX - Map.GridBounds.MinX + 1;
+		bool bFound = false;
+		for (int32 Index = 0; Index < Map.Data.Num(); Index++)
+		{
+			const int32 X = Map.GridBounds.MinX + Index % Width;
+			const int32 Y = Map.GridBounds.MinY + Index / Width;
+			const float Value = Map.Data[Index];
+			if (Value < IgnoreValue && Accept(X, Y) && (!bFound || Value > MaxValueOut))
+			{
+				MaxValueOut = Value;
+				CellOut = FCellRef(X, Y);
+				bFound = true;
+			}
+		}
+		return bFound;
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGAGridMapPyramidBruteForceTest, "GameAI.Grid.MapPyramid.MatchesBruteForce",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGAGridMapPyramidBruteForceTest::RunTest(const FString& Parameters)
+{
+	FGATestWorld TestWorld({
+		TEXT("........."),
+		TEXT("........."),
+		TEXT("........."),
+		TEXT("........."),
+		TEXT("........."),
+		TEXT("........."),
+		TEXT("........."),
+		TEXT("........."),
+	});
+
+	// Odd sizes, and not at the grid's origin, so the partial blocks on the right and bottom get exercised
+	FGAGridMap Map(TestWorld.Grid, FGridBox(1, 7, 2, 6), 0.0f);
+	const int32 CellCount = Map.Data.Num();
+
+	// Every value distinct, so there's only one right answer. About one cell in eight is missing
+	FRandomStream Random(1234);
+	for (int32 Index = 0; Index < CellCount; Index++)
+	{
+		Map.Data[Index] = float(Index);
+	}
+	for (int32 Index = CellCount - 1; Index > 0; Index--)
+	{
+		Map.Data.Swap(Index, Random.RandRange(0, Index));
+	}
+	for (int32 Index = 0; Index < CellCount; Index++)
+	{
+		if (Random.RandRange(0, 7) == 0)
+		{
+			Map.Data[Index] = BIG_NUMBER;
+		}
+	}
+
+	FGAGridMapPyramid Pyramid;
+	Pyramid.Build(Map);
+
+	auto CheckAgainstScan = [this, &Map, &Pyramid, &Random](const TCHAR* When)
+	{
+		float Expected = 0.0f;
+		float Actual = 0.0f;
+		FCellRef ExpectedCell;
+		FCellRef ActualCell;
+
+		FindMaxByScan(Map, BIG_NUMBER, [](int32 X, int32 Y) { return true; }, Expected, ExpectedCell);
+		TestTrue(FString::Printf(TEXT("%s: has a max"), When), Pyramid.GetMax(Actual, ActualCell));
+		TestEqual(FString::Printf(TEXT("%s: max"), When), Actual, Expected);
+		TestTrue(FString::Printf(TEXT("%s: max cell"), When), ActualCell == ExpectedCell);
+
+		for (int32 Attempt = 0; Attempt < 20; Attempt++)
+		{
+			// Some of these hang off the edge of the map
+			const int32 MinX = Random.RandRange(0, 7);
+			const int32 MinY = Random.RandRange(1, 6);
+			const FIntRect Rect(MinX, MinY, MinX + Random.RandRange(0, 4), MinY + Random.RandRange(0, 3));
+			const bool bExpected = FindMaxByScan(Map, BIG_NUMBER,
+				[&Rect](int32 X, int32 Y) { return X >= Rect.Min.X && X <= Rect.Max.X && Y >= Rect.Min.Y && Y <= Rect.Max.Y; },
+				Expected, ExpectedCell);
+			const bool bActual = Pyramid.GetMaxInRect(Rect, Actual, ActualCell);
+			TestEqual(FString::Printf(TEXT("%s: rect %d has a max"), When, Attempt), bActual, bExpected);
+			if (bExpected && bActual)
+			{
+				TestEqual(FString::Printf(TEXT("%s: rect %d max"), When, Attempt), Actual, Expected);
+				TestTrue(FString::Printf(TEXT("%s: rect %d max cell"), When, Attempt), ActualCell == ExpectedCell);
+			}
+
+			const FCellRef Center(Random.RandRange(1, 7), Random.RandRange(2, 6));
+			const float Radius = Random.FRandRange(0.5f, 3.0f);
+			const bool bExpectedInRadius = FindMaxByScan(Map, BIG_NUMBER,
+				[&Center, Radius](int32 X, int32 Y) { return float(FMath::Square(X - Center.X) + FMath::Square(Y - Center.Y)) <= Radius * Radius; },
+				Expected, ExpectedCell);
+			const bool bActualInRadius = Pyramid.GetMaxInRadius(Center, Radius, Actual, ActualCell);
+			TestEqual(FString::Printf(TEXT("%s: radius %d has a max"), When, Attempt), bActualInRadius, bExpectedInRadius);
+			if (bExpectedInRadius && bActualInRadius)
+			{
+				TestEqual(FString::Printf(TEXT("%s: radius %d max"), When, Attempt), Actual, Expected);
+				TestTrue(FString::Printf(TEXT("%s: radius %d max cell"), When, Attempt), ActualCell == ExpectedCell);
+			}
+		}
+
+		// Top K: the K highest values, best first
+		TArray<float> Sorted;
+		for (float Value : Map.Data)
+		{
+			if (Value < BIG_NUMBER)
+			{
+				Sorted.Add(Value);
+			}
+		}
+		Sorted.Sort(TGreater<float>());
+
+		TArray<TPair<FCellRef, float>> TopK;
+		Pyramid.GetTopK(5, TopK);
+		TestEqual(FString::Printf(TEXT("%s: top K count"), When), TopK.Num(), FMath::Min(5, Sorted.Num()));
+		for (int32 Rank = 0; Rank < TopK.Num(); Rank++)
+		{
+			TestEqual(FString::Printf(TEXT("%s: top K rank %d"), When, Rank), TopK[Rank].Value, Sorted[Rank]);
+		}
+	};
+
+	CheckAgainstScan(TEXT("Built"));
+
+	// Writes through the pyramid, including a new best, knocking out the best, and filling a missing cell
+	float Best = 0.0f;
+	FCellRef BestCell;
+	Pyramid.GetMax(Best, BestCell);
+	Pyramid.SetValue(FCellRef(7, 6), Best + 10.0f);
+	CheckAgainstScan(TEXT("New best in the corner"));
+
+	Pyramid.SetValue(FCellRef(7, 6), BIG_NUMBER);
+	CheckAgainstScan(TEXT("Best removed"));
+
+	for (int32 Write = 0; Write < 30; Write++)
+	{
+		Pyramid.SetValue(FCellRef(Random.RandRange(1, 7), Random.RandRange(2, 6)), 1000.0f + float(Write));
+	}
+	CheckAgainstScan(TEXT("Random writes"));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
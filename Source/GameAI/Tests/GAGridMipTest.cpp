@@ -0,0 +1,92 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GATestWorld.h"
+#include "GameAI/Grid/GAGridMip.h"
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGAGridMipKnownAnswerTest, "GameAI.Grid.Mip.KnownAnswer",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGAGridMipKnownAnswerTest::RunTest(const FString& Parameters)
+{
+	FGATestWorld TestWorld({
+		TEXT("..#."),
+		TEXT("...."),
+		TEXT("##.."),
+		TEXT("#..."),
+	});
+	AGAGridActor* Grid = TestWorld.Grid;
+	const FGAGridMipChain& MipChain = Grid->GetMipChain();
+	if (!TestTrue(TEXT("Mip chain built"), MipChain.Num() >= 2))
+	{
+		return false;
+	}
+
+	// 2x2 blocks. Representatives are the traversable cell nearest the block center, first in scan order on ties
+	const FGAGridMipLevel& Level = MipChain.GetLevel(0);
+	TestEqual(TEXT("Factor"), Level.Factor, 2);
+	TestEqual(TEXT("Width"), Level.Width, 2);
+	TestEqual(TEXT("Height"), Level.Height, 2);
+	TestTrue(TEXT("Fractions"), Level.TraversableFraction == TArray<float>({ 1.0f, 0.75f, 0.25f, 1.0f }));
+	TestTrue(TEXT("Representatives"), Level.RepresentativeCell == TArray<int32>({ 0, 3, 13, 10 }));
+
+	// One 4x4 block over the whole grid
+	const FGAGridMipLevel& Coarse = MipChain.GetLevel(1);
+	TestTrue(TEXT("Coarse fraction"), Coarse.TraversableFraction == TArray<float>({ 0.75f }));
+	TestTrue(TEXT("Coarse representative"), Coarse.RepresentativeCell == TArray<int32>({ 5 }));
+
+	// The right-hand column of blocks, then the bottom one of those out of the copy
+	const FGAGridMipLevel Right = Level.CopyBlocks(FGridBox(2, 3, 0, 3));
+	TestEqual(TEXT("Copy width"), Right.Width, 1);
+	TestEqual(TEXT("Copy height"), Right.Height, 2);
+	TestEqual(TEXT("Copy origin X"), Right.OriginX, 1);
+	TestEqual(TEXT("Copy origin Y"), Right.OriginY, 0);
+	TestTrue(TEXT("Copy fractions"), Right.TraversableFraction == TArray<float>({ 0.75f, 1.0f }));
+	TestTrue(TEXT("Copy representatives"), Right.RepresentativeCell == TArray<int32>({ 3, 10 }));
+
+	const FGAGridMipLevel BottomRight = Right.CopyBlocks(FGridBox(2, 3, 2, 3));
+	TestTrue(TEXT("Copy of a copy origin"), BottomRight.OriginX == 1 && BottomRight.OriginY == 1);
+	TestTrue(TEXT("Copy of a copy representatives"), BottomRight.RepresentativeCell == TArray<int32>({ 10 }));
+
+	const FGAGridMipLevel Outside = Right.CopyBlocks(FGridBox(0, 1, 0, 3));
+	TestEqual(TEXT("Copy outside what's held is empty"), Outside.Width * Outside.Height, 0);
+
+	// Scores grow to the bottom right, so (3, 3) is best. Representatives score 0, 3, 31 and 22: with one block to
+	// refine, the coarse pass picks the bottom-left block and only finds its one floor cell
+	auto IsTraversable = [Grid](const FCellRef& CellRef) { return Grid->IsCellTraversable(CellRef); };
+	auto Score = [](const FCellRef& CellRef) { return float(CellRef.X + 10 * CellRef.Y); };
+	const FGridBox FullBox(0, 3, 0, 3);
+	FCellRef Best;
+	int32 Evaluations = 0;
+
+	TestTrue(TEXT("Budget 1 finds a cell"), FGAGridMipChain::FindBestCellInLevel(Level, Grid->XCount, FullBox, 1, IsTraversable, Score, Best, &Evaluations));
+	TestTrue(TEXT("Budget 1 settles for the best refined block"), Best == FCellRef(1, 3));
+	TestEqual(TEXT("Budget 1 evaluations: 4 blocks, 1 cell"), Evaluations, 5);
+
+	TestTrue(TEXT("Budget 2 finds a cell"), FGAGridMipChain::FindBestCellInLevel(Level, Grid->XCount, FullBox, 2, IsTraversable, Score, Best, &Evaluations));
+	TestTrue(TEXT("Budget 2 finds the best cell"), Best == FCellRef(3, 3));
+	TestEqual(TEXT("Budget 2 evaluations: 4 blocks, 1 + 4 cells"), Evaluations, 9);
+
+	// Skipping mostly-blocked blocks leaves the bottom-right one on top
+	TestTrue(TEXT("Fraction filter finds a cell"), FGAGridMipChain::FindBestCellInLevel(Level, Grid->XCount, FullBox, 1, IsTraversable, Score, Best, &Evaluations, 0.5f));
+	TestTrue(TEXT("Fraction filter finds the best cell"), Best == FCellRef(3, 3));
+	TestEqual(TEXT("Fraction filter evaluations: 3 blocks, 4 cells"), Evaluations, 7);
+
+	// The same search over the copied blocks gives the same answer
+	TestTrue(TEXT("Copy finds a cell"), FGAGridMipChain::FindBestCellInLevel(Right, Grid->XCount, FullBox, 1, IsTraversable, Score, Best, &Evaluations));
+	TestTrue(TEXT("Copy finds the best cell"), Best == FCellRef(3, 3));
+	TestEqual(TEXT("Copy evaluations: 2 blocks, 4 cells"), Evaluations, 6);
+
+	// A static change refreshes the blocks over it
+	TestWorld.SetTraversable(3, 3, false);
+	TestEqual(TEXT("Updated fraction"), MipChain.GetLevel(0).TraversableFraction[3], 0.75f);
+	TestTrue(TEXT("Finds a cell after the change"), FGAGridMipChain::FindBestCellInLevel(MipChain.GetLevel(0), Grid->XCount, FullBox, 2, IsTraversable, Score, Best));
+	TestTrue(TEXT("Best moves with the data"), Best == FCellRef(2, 3));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
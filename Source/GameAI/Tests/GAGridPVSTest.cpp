@@ -0,0 +1,100 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GATestWorld.h"
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGAGridPVSInvalidationTest, "GameAI.Grid.PVS.Invalidation",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGAGridPVSInvalidationTest::RunTest(const FString& Parameters)
+{
+	FGATestWorld TestWorld({
+		TEXT("......"),
+		TEXT("......"),
+		TEXT("......"),
+	});
+	AGAGridActor* Grid = TestWorld.Grid;
+	const FCellRef Left(0, 1);
+	const FCellRef Right(5, 1);
+
+	Grid->PVS.ClusterSize = 1;
+	Grid->BakePVS();
+	TestTrue(TEXT("Freshly baked PVS is valid"), Grid->PVS.IsValidFor(Grid));
+	TestTrue(TEXT("Open row is visible"), Grid->IsVisible(Left, Right));
+
+	// A wall across the middle changes the static data, so the bake no longer applies
+	for (int32 Y = 0; Y < 3; Y++)
+	{
+		TestWorld.SetTraversable(3, Y, false);
+	}
+	TestFalse(TEXT("PVS is invalid after NotifyCellsChanged"), Grid->PVS.IsValidFor(Grid));
+	TestFalse(TEXT("Wall blocks sight through the fallback"), Grid->IsVisible(Left, Right));
+
+	// Putting the same data back makes the same bake valid again
+	for (int32 Y = 0; Y < 3; Y++)
+	{
+		TestWorld.SetTraversable(3, Y, true);
+	}
+	TestTrue(TEXT("PVS is valid again for the data it was baked from"), Grid->PVS.IsValidFor(Grid));
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGAGridPVSOverlayTest, "GameAI.Grid.PVS.Overlay",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGAGridPVSOverlayTest::RunTest(const FString& Parameters)
+{
+	FGATestWorld TestWorld({
+		TEXT("......"),
+	});
+	AGAGridActor* Grid = TestWorld.Grid;
+	const FCellRef Left(0, 0);
+	const FCellRef Right(5, 0);
+
+	// Baked with a blocker in the way: only the static data should end up in the PVS
+	AActor* Blocker = TestWorld.AddBlocker(3, 0);
+	Grid->PVS.ClusterSize = 1;
+	Grid->BakePVS();
+	TestTrue(TEXT("Overlay changes don't invalidate the PVS"), Grid->PVS.IsValidFor(Grid));
+	TestFalse(TEXT("Overlay blocker hides the pair"), Grid->IsVisible(Left, Right));
+
+	Grid->UnregisterOverlayActor(Blocker);
+	TestTrue(TEXT("PVS is still valid once the blocker is gone"), Grid->PVS.IsValidFor(Grid));
+	TestTrue(TEXT("Blocker wasn't baked into the PVS"), Grid->IsVisible(Left, Right));
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGAGridPVSOverlayOffLineTest, "GameAI.Grid.PVS.OverlayOffLine",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGAGridPVSOverlayOffLineTest::RunTest(const FString& Parameters)
+{
+	FGATestWorld TestWorld({
+		TEXT("......"),
+		TEXT("......"),
+		TEXT("...#.."),
+	});
+	AGAGridActor* Grid = TestWorld.Grid;
+	Grid->PVS.ClusterSize = 1;
+	Grid->BakePVS();
+
+	// A blocker nowhere near the line between two cells doesn't change whether they see each other
+	TestTrue(TEXT("Open row is visible"), Grid->IsVisible(FCellRef(0, 0), FCellRef(5, 0)));
+	TestFalse(TEXT("Wall hides the pair"), Grid->IsVisible(FCellRef(0, 2), FCellRef(5, 2)));
+
+	TestWorld.AddBlocker(2, 1);
+	TestTrue(TEXT("Blocker off the line leaves the pair visible"), Grid->IsVisible(FCellRef(0, 0), FCellRef(5, 0)));
+	TestFalse(TEXT("Still hidden by the static wall"), Grid->IsVisible(FCellRef(0, 2), FCellRef(5, 2)));
+	TestFalse(TEXT("Blocker on the line hides the pair"), Grid->IsVisible(FCellRef(0, 1), FCellRef(5, 1)));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,90 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GATestWorld.h"
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGAGridVisibilityOcclusionTest, "GameAI.Grid.Visibility.Occlusion",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGAGridVisibilityOcclusionTest::RunTest(const FString& Parameters)
+{
+	FGATestWorld TestWorld({
+		TEXT("....."),
+		TEXT("..#.."),
+		TEXT("....."),
+		TEXT("....."),
+	});
+	AGAGridActor* Grid = TestWorld.Grid;
+	auto IsSet = [Grid](const TBitArray<>& Visible, int32 X, int32 Y) { return bool(Visible[Grid->CellRefToIndex(FCellRef(X, Y))]); };
+
+	TBitArray<> Visible;
+	Grid->ComputeVisibility(FCellRef(0, 1), Visible);
+	TestTrue(TEXT("Origin sees itself"), IsSet(Visible, 0, 1));
+	TestTrue(TEXT("Wall facing the origin is visible"), IsSet(Visible, 2, 1));
+	TestFalse(TEXT("Straight behind the wall is hidden"), IsSet(Visible, 3, 1));
+	TestFalse(TEXT("Further behind the wall is hidden"), IsSet(Visible, 4, 1));
+	TestTrue(TEXT("Past the wall's shadow, above"), IsSet(Visible, 3, 0));
+	TestTrue(TEXT("Past the wall's shadow, below"), IsSet(Visible, 3, 2));
+	TestTrue(TEXT("Open ground"), IsSet(Visible, 1, 3));
+
+	// Radius is Euclidean, in cells
+	Grid->ComputeVisibility(FCellRef(0, 1), Visible, 2);
+	TestTrue(TEXT("Within the radius"), IsSet(Visible, 0, 3));
+	TestTrue(TEXT("Within the radius, diagonally"), IsSet(Visible, 1, 0));
+	TestFalse(TEXT("Past the radius"), IsSet(Visible, 1, 3));
+
+	// The overlay blocks sight unless it's left out
+	TestWorld.AddBlocker(2, 3);
+	Grid->ComputeVisibility(FCellRef(0, 3), Visible);
+	TestFalse(TEXT("Overlay blocker hides the cell behind it"), IsSet(Visible, 4, 3));
+	Grid->ComputeVisibility(FCellRef(0, 3), Visible, 0, false);
+	TestTrue(TEXT("Static data alone doesn't"), IsSet(Visible, 4, 3));
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGAGridVisibilitySymmetryTest, "GameAI.Grid.Visibility.Symmetry",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGAGridVisibilitySymmetryTest::RunTest(const FString& Parameters)
+{
+	// Pillars and a wall stub, so plenty of pairs sit on the edge of a shadow
+	FGATestWorld TestWorld({
+		TEXT("........."),
+		TEXT(".#...#..."),
+		TEXT("....##..."),
+		TEXT("..#......"),
+		TEXT("......#.."),
+		TEXT(".#......."),
+	});
+	AGAGridActor* Grid = TestWorld.Grid;
+	const int32 CellCount = Grid->XCount * Grid->YCount;
+
+	TArray<TBitArray<>> VisibleFrom;
+	VisibleFrom.SetNum(CellCount);
+	for (int32 Index = 0; Index < CellCount; Index++)
+	{
+		Grid->ComputeVisibility(FCellRef(Index % Grid->XCount, Index / Grid->XCount), VisibleFrom[Index]);
+	}
+
+	// A sees B exactly when B sees A, between floor cells
+	int32 Mismatches = 0;
+	for (int32 A = 0; A < CellCount; A++)
+	{
+		for (int32 B = A + 1; B < CellCount; B++)
+		{
+			const bool bFloors = Grid->IsCellTraversable(FCellRef(A % Grid->XCount, A / Grid->XCount))
+				&& Grid->IsCellTraversable(FCellRef(B % Grid->XCount, B / Grid->XCount));
+			Mismatches += (bFloors && VisibleFrom[A][B] != VisibleFrom[B][A]) ? 1 : 0;
+		}
+	}
+	TestEqual(TEXT("Asymmetric pairs"), Mismatches, 0);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
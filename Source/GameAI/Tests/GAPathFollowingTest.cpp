@@ -0,0 +1,99 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GATestWorld.h"
+#include "GameAI/Pathfinding/GAAILOD.h"
+#include "GameAI/Pathfinding/GAPathComponent.h"
+#include "GameAI/Pathfinding/GAPathFollowingSubsystem.h"
+#include "GameFramework/Pawn.h"
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGAPathFollowingStableIdTest, "GameAI.Pathfinding.PathFollowing.StableAgentIds",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGAPathFollowingStableIdTest::RunTest(const FString& Parameters)
+{
+	FGATestWorld TestWorld({
+		TEXT("...."),
+	});
+	UGAPathFollowingSubsystem* TickManager = TestWorld.World->GetSubsystem<UGAPathFollowingSubsystem>();
+	UGAAILODSubsystem* LOD = TestWorld.World->GetSubsystem<UGAAILODSubsystem>();
+	if (!TestNotNull(TEXT("Path following subsystem"), TickManager) || !TestNotNull(TEXT("LOD subsystem"), LOD))
+	{
+		return false;
+	}
+
+	TArray<UGAPathComponent*> Agents;
+	for (int32 Count = 0; Count < 3; Count++)
+	{
+		APawn* Pawn = TestWorld.World->SpawnActor<APawn>();
+		Agents.Add(NewObject<UGAPathComponent>(Pawn));
+		TickManager->RegisterComponent(Agents.Last());
+	}
+
+	TestNotEqual(TEXT("Ids are unique"), TickManager->GetAgentId(Agents[0]), TickManager->GetAgentId(Agents[2]));
+	TestNotEqual(TEXT("Ids are unique"), TickManager->GetAgentId(Agents[1]), TickManager->GetAgentId(Agents[2]));
+
+	// Removing the first agent swaps the last one into its slot. Its id (and so its stagger phase) mustn't move
+	const int32 LastId = TickManager->GetAgentId(Agents[2]);
+	const double LastStart = LOD->GetStaggeredStartTime(LastId, 0, 0.0);
+	TickManager->UnregisterComponent(Agents[0]);
+
+	TestEqual(TEXT("Unregistered agent has no id"), TickManager->GetAgentId(Agents[0]), int32(INDEX_NONE));
+	TestEqual(TEXT("Id survives the swap"), TickManager->GetAgentId(Agents[2]), LastId);
+	TestEqual(TEXT("Stagger phase survives the swap"), LOD->GetStaggeredStartTime(TickManager->GetAgentId(Agents[2]), 0, 0.0), LastStart);
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGAPathFollowingAdvanceTest, "GameAI.Pathfinding.PathFollowing.AdvanceWithoutReplan",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGAPathFollowingAdvanceTest::RunTest(const FString& Parameters)
+{
+	FGATestWorld TestWorld({
+		TEXT("........"),
+	});
+	AGAGridActor* Grid = TestWorld.Grid;
+
+	APawn* Pawn = TestWorld.World->SpawnActor<APawn>();
+	UGAPathComponent* Component = NewObject<UGAPathComponent>(Pawn);
+	Component->ArrivalDistance = 10.0f;
+
+	// What an agent that isn't due a full update this frame is left with: a path it has to keep walking
+	TArray<FPathStep> Steps;
+	for (int32 X : { 2, 4, 7 })
+	{
+		FPathStep& Step = Steps.AddDefaulted_GetRef();
+		Step.Set(Grid->GetCellPosition(FCellRef(X, 0)), FCellRef(X, 0));
+	}
+	Component->Destination = Steps.Last().Point;
+	Component->bDestinationValid = true;
+	Component->SetSteps(Steps);
+	Component->SetState();
+
+	const int32 Refreshes = Component->ReplanStats.Refreshes;
+
+	TestFalse(TEXT("Not there yet"), Component->AdvancePathFrom(Grid->GetCellPosition(FCellRef(2, 0))));
+	TestEqual(TEXT("Moved on past the reached waypoint"), Component->Steps.Num(), 2);
+	TestTrue(TEXT("Next waypoint"), Component->Steps[0].CellRef == FCellRef(4, 0));
+
+	TestTrue(TEXT("Arrived"), Component->AdvancePathFrom(Grid->GetCellPosition(FCellRef(7, 0))));
+	TestTrue(TEXT("Finished"), Component->State == GAPS_Finished);
+	TestEqual(TEXT("Never replanned"), Component->ReplanStats.Refreshes, Refreshes);
+
+	// No path at all drops the destination rather than leaving the old steps in place
+	Component->SetSteps(Steps);
+	Component->SetState();
+	TArray<FPathStep> NoSteps;
+	Component->SetSteps(NoSteps);
+	TestEqual(TEXT("Empty path clears the steps"), Component->Steps.Num(), 0);
+	TestFalse(TEXT("Empty path clears the destination"), Component->bDestinationValid);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
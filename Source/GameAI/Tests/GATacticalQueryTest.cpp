@@ -0,0 +1,119 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GATestWorld.h"
+#include "GameAI/Spatial/GATacticalQuery.h"
+
+
+namespace
+{
+	// The 5x5 box of cells around the agent, scored by distance to the target
+	UGATacticalQuery* MakeBoxQuery()
+	{
+		UGATacticalQuery* Query = NewObject<UGATacticalQuery>();
+		Query->Generator.Type = GATG_Rect;
+		Query->Generator.HalfExtent = 2;
+		Query->Tests.AddDefaulted();
+		return Query;
+	}
+
+	// Ticks the subsystem until the query calls back, running Between before every tick
+	bool RunToCompletion(UGATacticalQuerySubsystem* Subsystem, const UGATacticalQuery* Query, APawn* Agent, const FVector& TargetPoint,
+		TFunctionRef<void(int32 Tick)> Between, FGATacticalQueryResult& ResultOut)
+	{
+		bool bFinished = false;
+		int32 QueryId = Subsystem->RunQuery(Query, Agent->FindComponentByClass<UGAPathComponent>(), TargetPoint,
+			[&bFinished, &ResultOut](const FGATacticalQueryResult& Result)
+			{
+				ResultOut = Result;
+				bFinished = true;
+			});
+
+		for (int32 Tick = 0; Tick < 100 && QueryId != INDEX_NONE && !bFinished; Tick++)
+		{
+			Between(Tick);
+			Subsystem->Tick(0.0f);
+		}
+		return bFinished;
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGATacticalQueryRestartTest, "GameAI.Spatial.TacticalQuery.Restart",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGATacticalQueryRestartTest::RunTest(const FString& Parameters)
+{
+	FGATestWorld TestWorld({
+		TEXT("........................................"),
+		TEXT("........................................"),
+		TEXT("........................................"),
+		TEXT("........................................"),
+		TEXT("........................................"),
+		TEXT("........................................"),
+	});
+	UGATacticalQuerySubsystem* Subsystem = TestWorld.World->GetSubsystem<UGATacticalQuerySubsystem>();
+	if (!TestNotNull(TEXT("Tactical query subsystem"), Subsystem))
+	{
+		return false;
+	}
+
+	// No budget: one step per tick, so the grid can change between any two steps
+	Subsystem->TimeBudgetMs = 0.0f;
+	Subsystem->MaxRestarts = 2;
+
+	APawn* Agent = TestWorld.AddAgent(2, 2);
+	const FVector TargetPoint = TestWorld.Grid->GetCellPosition(FCellRef(2, 2));
+	UGATacticalQuery* Query = MakeBoxQuery();
+	FGATacticalQueryResult Result;
+
+	// Changes well away from the candidates don't concern the query
+	bool bFinished = RunToCompletion(Subsystem, Query, Agent, TargetPoint,
+		[&TestWorld](int32 Tick) { TestWorld.SetTraversable(30, Tick % 6, Tick % 2 == 0); }, Result);
+	TestTrue(TEXT("Finished despite far changes"), bFinished);
+	TestTrue(TEXT("Found a cell"), Result.bSuccess);
+	TestEqual(TEXT("Far changes don't restart"), Result.Restarts, 0);
+
+	// A change among the candidates before every step would restart it forever, but the restarts are capped
+	bFinished = RunToCompletion(Subsystem, Query, Agent, TargetPoint,
+		[&TestWorld](int32 Tick) { TestWorld.SetTraversable(4, 4, Tick % 2 == 0); }, Result);
+	TestTrue(TEXT("Finished despite constant nearby changes"), bFinished);
+	TestTrue(TEXT("Found a cell"), Result.bSuccess);
+	TestEqual(TEXT("Restarts stop at MaxRestarts"), Result.Restarts, Subsystem->MaxRestarts);
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGATacticalQueryUnlimitedReachTest, "GameAI.Spatial.TacticalQuery.UnlimitedReach",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGATacticalQueryUnlimitedReachTest::RunTest(const FString& Parameters)
+{
+	FGATestWorld TestWorld({
+		TEXT("......#...."),
+		TEXT("......#...."),
+		TEXT("......#...."),
+	});
+	UGATacticalQuerySubsystem* Subsystem = TestWorld.World->GetSubsystem<UGATacticalQuerySubsystem>();
+	if (!TestNotNull(TEXT("Tactical query subsystem"), Subsystem))
+	{
+		return false;
+	}
+
+	APawn* Agent = TestWorld.AddAgent(0, 0);
+	UGATacticalQuery* Query = NewObject<UGATacticalQuery>();
+	Query->Generator.Type = GATG_Reachable;
+	Query->Generator.MaxPathDistance = 0;
+	Query->Tests.AddDefaulted();
+
+	FGATacticalQueryResult Result;
+	TestTrue(TEXT("Query ran"), Subsystem->RunQueryImmediate(Query, Agent->FindComponentByClass<UGAPathComponent>(), Agent->GetActorLocation(), Result));
+	TestEqual(TEXT("No limit: every cell on the agent's side of the wall"), Result.CandidatesGenerated, 18);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "GameAI/Grid/GAGridActor.h"
+#include "GameAI/Pathfinding/GAPathComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+
+
+// A throwaway game world with one grid actor in it, for automation tests that need the real AGAGridActor (and the
+// world subsystems) rather than a GACore view.
+// Rows are given top to bottom as strings, '#' for a blocked cell and anything else for a traversable one.
+struct FGATestWorld
+{
+	explicit FGATestWorld(const TArray<FString>& Rows)
+	{
+		// Nothing but the actors and subsystems
+		UWorld::InitializationValues WorldValues = UWorld::InitializationValues()
+			.AllowAudioPlayback(false)
+			.RequiresHitProxies(false)
+			.CreatePhysicsScene(false)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(false)
+			.SetTransactional(false)
+			.CreateFXSystem(false);
+		World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("GATestWorld"), nullptr, true, ERHIFeatureLevel::Num, &WorldValues);
+		Grid = World->SpawnActor<AGAGridActor>();
+
+		const int32 YCount = Rows.Num();
+		const int32 XCount = (YCount > 0) ? Rows[0].Len() : 0;
+		Grid->ResizeGrid(XCount, YCount, 100.0f);
+		for (int32 Y = 0; Y < YCount; Y++)
+		{
+			for (int32 X = 0; X < XCount; X++)
+			{
+				Grid->Data[Y * XCount + X] = (Rows[Y][X] == TEXT('#')) ? ECellData::CellDataNone : ECellData::CellDataTraversable;
+			}
+		}
+		Grid->NotifyCellsChanged(FIntRect(0, 0, XCount - 1, YCount - 1));
+	}
+
+	~FGATestWorld()
+	{
+		World->DestroyWorld(false);
+		World->RemoveFromRoot();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	// Writes one cell of the static data and tells the grid about it
+	void SetTraversable(int32 X, int32 Y, bool bTraversable)
+	{
+		Grid->Data[Y * Grid->XCount + X] = bTraversable ? ECellData::CellDataTraversable : ECellData::CellDataNone;
+		Grid->NotifyCellsChanged(FIntRect(X, Y, X, Y));
+	}
+
+	// Spawns an actor over the center of the cell and stamps it into the overlay as a single blocking cell
+	AActor* AddBlocker(int32 X, int32 Y)
+	{
+		AActor* Blocker = World->SpawnActor<AActor>();
+		USceneComponent* Root = NewObject<USceneComponent>(Blocker);
+		Blocker->SetRootComponent(Root);
+		Root->RegisterComponent();
+		Blocker->SetActorLocation(Grid->GetCellPosition(FCellRef(X, Y)));
+
+		FGAOverlayFootprint Footprint;
+		Footprint.Radius = 0.25f * Grid->CellScale;
+		Grid->RegisterOverlayActor(Blocker, Footprint);
+		return Blocker;
+	}
+
+	// Spawns a pawn over the center of the cell, with a path component on it
+	APawn* AddAgent(int32 X, int32 Y)
+	{
+		APawn* Pawn = World->SpawnActor<APawn>();
+		USceneComponent* Root = NewObject<USceneComponent>(Pawn);
+		Pawn->SetRootComponent(Root);
+		Root->RegisterComponent();
+		Pawn->SetActorLocation(Grid->GetCellPosition(FCellRef(X, Y)));
+
+		UGAPathComponent* PathComponent = NewObject<UGAPathComponent>(Pawn);
+		PathComponent->RegisterComponent();
+		return Pawn;
+	}
+
+	FGATestWorld(const FGATestWorld&) = delete;
+	FGATestWorld& operator=(const FGATestWorld&) = delete;
+
+	UWorld* World = nullptr;
+	AGAGridActor* Grid = nullptr;
+};
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,15 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+// Engine-independent grid and search code. Only Core is needed, for the module boilerplate in GameAICoreModule.cpp;
+// everything else here is plain C++ so it also builds standalone (see Tools/GameAICore)
+public class GameAICore : ModuleRules
+{
+	public GameAICore(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(new string[] { "Core" });
+	}
+}
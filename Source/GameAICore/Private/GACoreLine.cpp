@@ -0,0 +1,86 @@
+#include "GACoreLine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+
+namespace GACore
+{
+	bool HasLineOfSight(const FGridView& Grid, int32_t FromX, int32_t FromY, int32_t ToX, int32_t ToY)
+	{
+		return WalkLine(FromX, FromY, ToX, ToY, [&Grid](int32_t X, int32_t Y) { return Grid.IsTraversable(X, Y); });
+	}
+
+	bool IsSegmentClear(const FGridView& Grid, float StartX, float StartY, float EndX, float EndY)
+	{
+		if (Grid.Width <= 0 || Grid.Height <= 0)
+		{
+			return false;
+		}
+
+		// Points right on the far edge of the grid belong to the last cell, like AGAGridActor::GetCellRef
+		auto ToCell = [](float Value, int32_t Count) { return std::min(std::max(int32_t(std::floor(Value)), int32_t(0)), Count - 1); };
+		int32_t X = ToCell(StartX, Grid.Width);
+		int32_t Y = ToCell(StartY, Grid.Height);
+		const int32_t EndCellX = ToCell(EndX, Grid.Width);
+		const int32_t EndCellY = ToCell(EndY, Grid.Height);
+
+		if (!Grid.IsTraversable(X, Y))
+		{
+			return false;
+		}
+
+		// Distance along the segment (0 at the start, 1 at the end) to the next vertical and horizontal cell edge,
+		// and between consecutive edges
+		const float Infinity = std::numeric_limits<float>::infinity();
+		const float DX = EndX - StartX;
+		const float DY = EndY - StartY;
+		const int32_t StepX = (EndCellX > X) ? 1 : -1;
+		const int32_t StepY = (EndCellY > Y) ? 1 : -1;
+		const float DeltaX = (EndCellX != X) ? std::abs(1.0f / DX) : Infinity;
+		const float DeltaY = (EndCellY != Y) ? std::abs(1.0f / DY) : Infinity;
+		float NextX = (EndCellX != X) ? ((StepX > 0) ? (float(X + 1) - StartX) : (StartX - float(X))) * DeltaX : Infinity;
+		float NextY = (EndCellY != Y) ? ((StepY > 0) ? (float(Y + 1) - StartY) : (StartY - float(Y))) * DeltaY : Infinity;
+
+		// Crossings this close together count as going through the corner. Lines between cell centers often do, and
+		// the accumulated distances are rarely exactly equal when they should be
+		const float CornerTolerance = 1e-5f;
+
+		// Every step moves towards the end cell, so this always finishes, whatever the float error
+		while (X != EndCellX || Y != EndCellY)
+		{
+			bool bStepX = (Y == EndCellY) || (X != EndCellX && NextX < NextY - CornerTolerance);
+			bool bStepY = (X == EndCellX) || (Y != EndCellY && NextY < NextX - CornerTolerance);
+			if (!bStepX && !bStepY)
+			{
+				// Exactly through a corner
+				if (!Grid.IsTraversable(X + StepX, Y) || !Grid.IsTraversable(X, Y + StepY))
+				{
+					return false;
+				}
+				bStepX = true;
+				bStepY = true;
+			}
+
+			if (bStepX)
+			{
+				X += StepX;
+				NextX += DeltaX;
+			}
+			if (bStepY)
+			{
+				Y += StepY;
+				NextY += DeltaY;
+			}
+
+			if (!Grid.IsTraversable(X, Y))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,269 @@
+#include "GACoreSearch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+namespace GACore
+{
+	// Smallest priority on top. Among equal priorities, prefer the cell that's further along (higher cost), which
+	// for A* means fewer expansions on open ground where lots of cells tie
+	static bool OpenEntryLess(const FSearchScratch::FOpenEntry& A, const FSearchScratch::FOpenEntry& B)
+	{
+		return A.Priority > B.Priority || (A.Priority == B.Priority && A.Cost < B.Cost);
+	}
+
+	void FSearchScratch::Begin(int32_t CellCount)
+	{
+		if (Stamps.size() != size_t(CellCount))
+		{
+			Costs.resize(CellCount);
+			Parents.resize(CellCount);
+			Stamps.assign(CellCount, 0);
+			Search = 0;
+		}
+
+		// Once every four billion searches, the stamps have to actually be cleared
+		if (++Search == 0)
+		{
+			std::fill(Stamps.begin(), Stamps.end(), 0);
+			Search = 1;
+		}
+
+		Open.clear();
+	}
+
+	void FSearchScratch::Push(float Priority, float Cost, int32_t Index)
+	{
+		Open.push_back({ Priority, Cost, Index });
+		std::push_heap(Open.begin(), Open.end(), OpenEntryLess);
+	}
+
+	FSearchScratch::FOpenEntry FSearchScratch::Pop()
+	{
+		std::pop_heap(Open.begin(), Open.end(), OpenEntryLess);
+		FOpenEntry Top = Open.back();
+		Open.pop_back();
+		return Top;
+	}
+
+
+	static float ManhattanDistance(int32_t AX, int32_t AY, int32_t BX, int32_t BY)
+	{
+		return float(std::abs(AX - BX) + std::abs(AY - BY));
+	}
+
+	bool FindPath(const FGridView& Grid, int32_t StartX, int32_t StartY, int32_t GoalX, int32_t GoalY,
+		FSearchScratch& Scratch, std::vector<int32_t>& PathOut, FSearchStats* StatsOut)
+	{
+		FSearchStats Stats;
+		PathOut.clear();
+
+		bool bFound = false;
+		if (Grid.IsInBounds(StartX, StartY) && Grid.IsTraversable(GoalX, GoalY))
+		{
+			const int32_t Start = Grid.ToIndex(StartX, StartY);
+			const int32_t Goal = Grid.ToIndex(GoalX, GoalY);
+
+			Scratch.Begin(Grid.GetCellCount());
+			Scratch.Visit(Start, 0.0f, -1);
+			Scratch.Push(ManhattanDistance(StartX, StartY, GoalX, GoalY), 0.0f, Start);
+			Stats.HeapPushes++;
+
+			while (!Scratch.Open.empty())
+			{
+				FSearchScratch::FOpenEntry Current = Scratch.Pop();
+				if (Current.Cost > Scratch.Costs[Current.Index])
+				{
+					// Stale -- this cell was reached more cheaply since it was pushed
+					continue;
+				}
+
+				Stats.NodesExpanded++;
+				if (Current.Index == Goal)
+				{
+					bFound = true;
+					break;
+				}
+
+				ForEachNeighbour(Grid, Current.Index % Grid.Width, Current.Index / Grid.Width,
+					[&Grid, &Scratch, &Stats, &Current, GoalX, GoalY](int32_t X, int32_t Y, int32_t Index)
+					{
+						float Cost = Current.Cost + Grid.GetCost(Index);
+						if (!Scratch.IsVisited(Index) || Cost < Scratch.Costs[Index])
+						{
+							Scratch.Visit(Index, Cost, Current.Index);
+							Scratch.Push(Cost + ManhattanDistance(X, Y, GoalX, GoalY), Cost, Index);
+							Stats.HeapPushes++;
+						}
+					});
+			}
+
+			if (bFound)
+			{
+				// Walk back to the start (which isn't included), then flip
+				for (int32_t Index = Goal; Index != Start; Index = Scratch.Parents[Index])
+				{
+					PathOut.push_back(Index);
+				}
+				std::reverse(PathOut.begin(), PathOut.end());
+			}
+		}
+
+		if (StatsOut)
+		{
+			*StatsOut = Stats;
+		}
+		return bFound;
+	}
+
+	bool FloodDistances(const FGridView& Grid, int32_t StartX, int32_t StartY, const FGridWindow& Window,
+		float* Distances, FSearchScratch& Scratch, FSearchStats* StatsOut)
+	{
+		FSearchStats Stats;
+
+		bool bStarted = Window.Contains(StartX, StartY) && Grid.IsInBounds(StartX, StartY);
+		if (bStarted)
+		{
+			// Distances doubles as the visited set, so only the heap is needed from the scratch
+			Scratch.Open.clear();
+
+			Distances[Window.ToIndex(StartX, StartY)] = 0.0f;
+			Scratch.Push(0.0f, 0.0f, Grid.ToIndex(StartX, StartY));
+			Stats.HeapPushes++;
+
+			while (!Scratch.Open.empty())
+			{
+				FSearchScratch::FOpenEntry Current = Scratch.Pop();
+				int32_t X = Current.Index % Grid.Width;
+				int32_t Y = Current.Index / Grid.Width;
+				if (Current.Cost > Distances[Window.ToIndex(X, Y)])
+				{
+					continue;
+				}
+
+				Stats.NodesExpanded++;
+				ForEachNeighbour(Grid, X, Y,
+					[&Grid, &Window, &Scratch, &Stats, &Current, Distances](int32_t NeighbourX, int32_t NeighbourY, int32_t Index)
+					{
+						if (!Window.Contains(NeighbourX, NeighbourY))
+						{
+							return;
+						}
+
+						float Cost = Current.Cost + Grid.GetCost(Index);
+						float& Distance = Distances[Window.ToIndex(NeighbourX, NeighbourY)];
+						if (Cost < Distance)
+						{
+							Distance = Cost;
+							Scratch.Push(Cost, Cost, Index);
+							Stats.HeapPushes++;
+						}
+					});
+			}
+		}
+
+		if (StatsOut)
+		{
+			*StatsOut = Stats;
+		}
+		return bStarted;
+	}
+
+	void FloodDistancesBounded(const FGridView& Grid, int32_t StartX, int32_t StartY, const FGridWindow& Window,
+		int32_t MaxDistance, int32_t MaxNodes, float* Distances, int32_t* Predecessors, FBucketQueue& Queue,
+		FBoundedFloodStats& StatsOut)
+	{
+		StatsOut = FBoundedFloodStats();
+		std::fill(Predecessors, Predecessors + Window.GetCellCount(), -1);
+
+		std::vector<std::vector<int32_t>>& Buckets = Queue.Buckets;
+		auto PushToBucket = [&Buckets, &StatsOut](int32_t Distance, int32_t WindowIndex)
+		{
+			StatsOut.BucketPushes++;
+			if (Buckets.size() <= size_t(Distance))
+			{
+				Buckets.resize(Distance + 1);
+			}
+			Buckets[Distance].push_back(WindowIndex);
+		};
+
+		int32_t StartIndex = Window.ToIndex(StartX, StartY);
+		Distances[StartIndex] = 0.0f;
+		PushToBucket(0, StartIndex);
+
+		int32_t HighestBucket = 0;
+		int32_t Distance = 0;
+		for (; Distance <= HighestBucket; Distance++)
+		{
+			// Costs are at least 1, so nothing below can push into the bucket we're iterating.
+			// Buckets can grow (and move) while we push, though, so don't hold a reference to this one.
+			for (size_t EntryIndex = 0; EntryIndex < Buckets[Distance].size() && !StatsOut.bHitNodeLimit; EntryIndex++)
+			{
+				int32_t WindowIndex = Buckets[Distance][EntryIndex];
+				if (Distances[WindowIndex] != float(Distance))
+				{
+					// Stale -- this cell was settled from a cheaper bucket
+					continue;
+				}
+
+				StatsOut.NodesSettled++;
+				if (MaxNodes > 0 && StatsOut.NodesSettled >= MaxNodes)
+				{
+					StatsOut.bHitNodeLimit = true;
+				}
+
+				int32_t X = Window.MinX + WindowIndex % Window.Width;
+				int32_t Y = Window.MinY + WindowIndex / Window.Width;
+				ForEachNeighbour(Grid, X, Y,
+					[&](int32_t NeighbourX, int32_t NeighbourY, int32_t Index)
+					{
+						if (!Window.Contains(NeighbourX, NeighbourY))
+						{
+							return;
+						}
+
+						int32_t NewDistance = Distance + std::max(int32_t(std::floor(Grid.GetCost(Index) + 0.5f)), int32_t(1));
+						int32_t NeighbourWindowIndex = Window.ToIndex(NeighbourX, NeighbourY);
+						if ((MaxDistance > 0 && NewDistance > MaxDistance) || float(NewDistance) >= Distances[NeighbourWindowIndex])
+						{
+							return;
+						}
+
+						Distances[NeighbourWindowIndex] = float(NewDistance);
+						Predecessors[NeighbourWindowIndex] = WindowIndex;
+						PushToBucket(NewDistance, NeighbourWindowIndex);
+						HighestBucket = std::max(HighestBucket, NewDistance);
+					});
+			}
+
+			if (StatsOut.bHitNodeLimit)
+			{
+				break;
+			}
+
+			Buckets[Distance].clear();
+		}
+
+		// If we stopped early, anything queued in a later bucket only has a tentative distance. Put those back to
+		// unreached so every distance in the map is final. (Cells left in the bucket we stopped in are fine -- with
+		// costs of at least 1, nothing could have beaten that distance.)
+		if (StatsOut.bHitNodeLimit)
+		{
+			Buckets[Distance].clear();
+			for (Distance++; Distance <= HighestBucket; Distance++)
+			{
+				for (int32_t WindowIndex : Buckets[Distance])
+				{
+					if (Distances[WindowIndex] == float(Distance))
+					{
+						Distances[WindowIndex] = std::numeric_limits<float>::infinity();
+						Predecessors[WindowIndex] = -1;
+					}
+				}
+				Buckets[Distance].clear();
+			}
+		}
+	}
+}
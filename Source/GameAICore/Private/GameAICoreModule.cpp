@@ -0,0 +1,6 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Modules/ModuleManager.h"
+
+// The only file in this module that knows about Unreal. The standalone build leaves it out
+IMPLEMENT_MODULE(FDefaultModuleImpl, GameAICore);
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+// Engine-independent grid and search code. Nothing under GACore touches UObjects (or Unreal at all), so it can be
+// built, profiled and sanitized on its own -- see Tools/GameAICore. AGAGridActor and UGAPathComponent hand it
+// views of their data.
+namespace GACore
+{
+	// Same bits as ECellData
+	enum ECellFlags : uint8_t
+	{
+		CellFlagsNone = 0,
+		CellFlagsTraversable = 1 << 0,
+	};
+
+
+	// Read-only view of a grid's cells, X-major (index = Y * Width + X), like AGAGridActor::Data
+	struct FGridView
+	{
+		int32_t Width = 0;
+		int32_t Height = 0;
+
+		// Width * Height cell flags. If null, nothing is traversable
+		const uint8_t* Flags = nullptr;
+
+		// Optional dynamic overlay, Width * Height each (see FGAGridOverlay). Cells with a block count above zero
+		// aren't traversable, and the extra cost is added to the cost of stepping into the cell
+		const int32_t* BlockCounts = nullptr;
+		const float* ExtraCosts = nullptr;
+
+		bool IsInBounds(int32_t X, int32_t Y) const { return X >= 0 && X < Width && Y >= 0 && Y < Height; }
+		int32_t ToIndex(int32_t X, int32_t Y) const { return Y * Width + X; }
+		int32_t GetCellCount() const { return Width * Height; }
+
+		// Index must be in bounds
+		bool IsTraversableIndex(int32_t Index) const
+		{
+			return Flags && (Flags[Index] & CellFlagsTraversable) && !(BlockCounts && BlockCounts[Index] > 0);
+		}
+
+		bool IsTraversable(int32_t X, int32_t Y) const { return IsInBounds(X, Y) && IsTraversableIndex(ToIndex(X, Y)); }
+
+		// Cost of stepping into the cell: 1 plus any overlay cost. Index must be in bounds
+		float GetCost(int32_t Index) const { return 1.0f + (ExtraCosts ? ExtraCosts[Index] : 0.0f); }
+	};
+
+
+	// Owning cell storage, for grids that don't live in an actor (tools and benchmarks)
+	struct FGridStorage
+	{
+		int32_t Width = 0;
+		int32_t Height = 0;
+		std::vector<uint8_t> Flags;
+
+		// Left empty unless something is stamped
+		std::vector<int32_t> BlockCounts;
+		std::vector<float> ExtraCosts;
+
+		// Every cell blocked, no overlay
+		void Reset(int32_t InWidth, int32_t InHeight)
+		{
+			Width = InWidth;
+			Height = InHeight;
+			Flags.assign(size_t(Width) * size_t(Height), CellFlagsNone);
+			BlockCounts.clear();
+			ExtraCosts.clear();
+		}
+
+		void SetTraversable(int32_t X, int32_t Y, bool bTraversable)
+		{
+			Flags[size_t(Y) * size_t(Width) + size_t(X)] = bTraversable ? CellFlagsTraversable : CellFlagsNone;
+		}
+
+		FGridView GetView() const
+		{
+			FGridView View;
+			View.Width = Width;
+			View.Height = Height;
+			View.Flags = Flags.empty() ? nullptr : Flags.data();
+			View.BlockCounts = BlockCounts.empty() ? nullptr : BlockCounts.data();
+			View.ExtraCosts = ExtraCosts.empty() ? nullptr : ExtraCosts.data();
+			return View;
+		}
+	};
+
+
+	// Calls Visit(NeighbourX, NeighbourY, NeighbourIndex) for each traversable 4-neighbour of an in-bounds cell,
+	// in +X, -X, +Y, -Y order
+	template <typename VisitorType>
+	inline void ForEachNeighbour(const FGridView& Grid, int32_t X, int32_t Y, VisitorType&& Visit)
+	{
+		const int32_t Index = Grid.ToIndex(X, Y);
+		if (X + 1 < Grid.Width && Grid.IsTraversableIndex(Index + 1))
+		{
+			Visit(X + 1, Y, Index + 1);
+		}
+		if (X > 0 && Grid.IsTraversableIndex(Index - 1))
+		{
+			Visit(X - 1, Y, Index - 1);
+		}
+		if (Y + 1 < Grid.Height && Grid.IsTraversableIndex(Index + Grid.Width))
+		{
+			Visit(X, Y + 1, Index + Grid.Width);
+		}
+		if (Y > 0 && Grid.IsTraversableIndex(Index - Grid.Width))
+		{
+			Visit(X, Y - 1, Index - Grid.Width);
+		}
+	}
+}
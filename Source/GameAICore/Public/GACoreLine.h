@@ -0,0 +1,76 @@
+#pragma once
+
+#include "GACoreGrid.h"
+
+#include <cstdint>
+#include <cstdlib>
+
+
+namespace GACore
+{
+	// Supercover walk from cell center to cell center. True if both ends and every cell the line touches are
+	// traversable. Where the line passes exactly through a corner, both cells beside the corner have to be clear
+	bool HasLineOfSight(const FGridView& Grid, int32_t FromX, int32_t FromY, int32_t ToX, int32_t ToY);
+
+	// The walk HasLineOfSight makes, with the test left to the caller: IsClear(X, Y) is called for both ends and
+	// every cell the line touches (both cells beside a corner it passes through), and the walk stops at the first
+	// false. Every cell it asks about is inside the box spanned by the two ends
+	template <typename PredicateType>
+	bool WalkLine(int32_t FromX, int32_t FromY, int32_t ToX, int32_t ToY, PredicateType&& IsClear)
+	{
+		if (!IsClear(FromX, FromY) || !IsClear(ToX, ToY))
+		{
+			return false;
+		}
+
+		// Bresenham-style error term, from center to center
+		int32_t DX = std::abs(ToX - FromX);
+		int32_t DY = std::abs(ToY - FromY);
+		int32_t StepX = (ToX > FromX) ? 1 : -1;
+		int32_t StepY = (ToY > FromY) ? 1 : -1;
+		int32_t X = FromX;
+		int32_t Y = FromY;
+		int32_t Error = DX - DY;
+		DX *= 2;
+		DY *= 2;
+
+		for (int32_t Remaining = (DX + DY) / 2; Remaining > 0; Remaining--)
+		{
+			if (Error > 0)
+			{
+				X += StepX;
+				Error -= DY;
+			}
+			else if (Error < 0)
+			{
+				Y += StepY;
+				Error += DX;
+			}
+			else
+			{
+				// Exactly through a corner
+				if (!IsClear(X + StepX, Y) || !IsClear(X, Y + StepY))
+				{
+					return false;
+				}
+				X += StepX;
+				Y += StepY;
+				Error += DX - DY;
+				Remaining--;
+			}
+
+			if (!IsClear(X, Y))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Walks the segment between two points in cell space, where (0, 0) is the min corner of cell (0, 0) and one unit
+	// is one cell, visiting every cell it passes through exactly (Amanatides & Woo). True if all of them are
+	// traversable. As above, a segment through a corner needs both cells beside it clear. Both ends have to be
+	// inside the grid
+	bool IsSegmentClear(const FGridView& Grid, float StartX, float StartY, float EndX, float EndY);
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "GACoreGrid.h"
+
+#include <cstdint>
+#include <vector>
+
+
+namespace GACore
+{
+	// What one search did
+	struct FSearchStats
+	{
+		int32_t NodesExpanded = 0;
+		int32_t HeapPushes = 0;
+	};
+
+
+	// The rectangle of the grid a distance buffer covers, row-major like the grid
+	struct FGridWindow
+	{
+		FGridWindow() = default;
+		FGridWindow(int32_t InMinX, int32_t InMinY, int32_t InWidth, int32_t InHeight)
+			: MinX(InMinX), MinY(InMinY), Width(InWidth), Height(InHeight) {}
+
+		static FGridWindow Full(const FGridView& Grid) { return FGridWindow(0, 0, Grid.Width, Grid.Height); }
+
+		int32_t MinX = 0;
+		int32_t MinY = 0;
+		int32_t Width = 0;
+		int32_t Height = 0;
+
+		bool Contains(int32_t X, int32_t Y) const { return X >= MinX && X < MinX + Width && Y >= MinY && Y < MinY + Height; }
+		int32_t ToIndex(int32_t X, int32_t Y) const { return (Y - MinY) * Width + (X - MinX); }
+		int32_t GetCellCount() const { return Width * Height; }
+	};
+
+
+	// Buffers for FindPath and FloodDistances, kept between searches so they don't allocate once warmed up.
+	// Not thread-safe: use one per thread
+	class FSearchScratch
+	{
+	public:
+		struct FOpenEntry
+		{
+			float Priority;
+			float Cost;
+			int32_t Index;
+		};
+
+		// Best known cost and parent per cell. Only meaningful where Stamps matches the current search
+		std::vector<float> Costs;
+		std::vector<int32_t> Parents;
+		std::vector<uint32_t> Stamps;
+		uint32_t Search = 0;
+
+		// Binary min-heap on Priority
+		std::vector<FOpenEntry> Open;
+
+		// Starts a new search over CellCount cells. Doesn't clear anything: bumping Search invalidates the old costs
+		void Begin(int32_t CellCount);
+
+		bool IsVisited(int32_t Index) const { return Stamps[Index] == Search; }
+		void Visit(int32_t Index, float Cost, int32_t Parent)
+		{
+			Stamps[Index] = Search;
+			Costs[Index] = Cost;
+			Parents[Index] = Parent;
+		}
+
+		void Push(float Priority, float Cost, int32_t Index);
+		FOpenEntry Pop();
+	};
+
+
+	// A* over the 4-neighbourhood, with the Manhattan distance as the heuristic (every step costs at least 1).
+	// PathOut gets the cell indices after the start, up to and including the goal -- empty if the start is the goal.
+	// The start doesn't have to be traversable (an agent can be standing in an overlay footprint), the goal does.
+	// Returns false, with PathOut empty, if the goal can't be reached
+	bool FindPath(const FGridView& Grid, int32_t StartX, int32_t StartY, int32_t GoalX, int32_t GoalY,
+		FSearchScratch& Scratch, std::vector<int32_t>& PathOut, FSearchStats* StatsOut = nullptr);
+
+	// Dijkstra from the start cell, over the part of the grid Window covers. Distances (one per window cell) has to
+	// come in filled with infinity; every cell reached gets its path cost. The start cell doesn't have to be
+	// traversable. Returns false if the start is outside the window
+	bool FloodDistances(const FGridView& Grid, int32_t StartX, int32_t StartY, const FGridWindow& Window,
+		float* Distances, FSearchScratch& Scratch, FSearchStats* StatsOut = nullptr);
+
+
+	// Open list for FloodDistancesBounded: one bucket per integer distance. Reused between searches
+	struct FBucketQueue
+	{
+		std::vector<std::vector<int32_t>> Buckets;
+	};
+
+	struct FBoundedFloodStats
+	{
+		// How many cells had their final distance fixed
+		int32_t NodesSettled = 0;
+		int32_t BucketPushes = 0;
+
+		// True if the search stopped because of MaxNodes rather than running out of cells
+		bool bHitNodeLimit = false;
+	};
+
+	// Dijkstra with a Dial bucket queue, for when step costs can be rounded to integers. Each step's cost is rounded
+	// to the nearest integer and raised to at least 1, so with fractional overlay costs the distances (and the routes
+	// behind them) can differ from FloodDistances'. With whole-number costs the two agree.
+	// Stops expanding past MaxDistance and after MaxNodes cells have been settled (<= 0 means no limit).
+	// Distances has to come in filled with infinity; Predecessors (one per window cell) is filled in with the window
+	// index each cell was reached from, -1 for the start and unreached cells. Every distance left in the map is
+	// final, even when the node limit is hit. The start cell has to be inside the window
+	void FloodDistancesBounded(const FGridView& Grid, int32_t StartX, int32_t StartY, const FGridWindow& Window,
+		int32_t MaxDistance, int32_t MaxNodes, float* Distances, int32_t* Predecessors, FBucketQueue& Queue,
+		FBoundedFloodStats& StatsOut);
+}
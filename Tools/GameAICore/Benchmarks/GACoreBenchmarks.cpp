@@ -0,0 +1,314 @@
+// Microbenchmarks for the engine-independent grid/search core. Grids and queries are seeded, so runs are comparable
+// between builds. Arguments are grid size (cells per side) and layout.
+
+#include "GACoreGrid.h"
+#include "GACoreLine.h"
+#include "GACoreSearch.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+	enum class ELayout : int64_t
+	{
+		Open,
+		Random,		// 25% of cells blocked
+		Maze,		// One-cell corridors, one route between any two cells
+		Rooms,		// 12x12 rooms with a doorway through each wall
+	};
+
+	const char* GetLayoutName(ELayout Layout)
+	{
+		switch (Layout)
+		{
+		case ELayout::Open: return "Open";
+		case ELayout::Random: return "Random";
+		case ELayout::Maze: return "Maze";
+		case ELayout::Rooms: return "Rooms";
+		}
+		return "";
+	}
+
+	constexpr uint32_t Seed = 1234;
+	constexpr int32_t QueryCount = 64;
+
+	void BuildMaze(GACore::FGridStorage& Grid, std::mt19937& Random)
+	{
+		const int32_t MazeCount = (Grid.Width - 1) / 2;
+		std::vector<uint8_t> Visited(size_t(MazeCount) * MazeCount, 0);
+		std::vector<std::pair<int32_t, int32_t>> Stack = { { 0, 0 } };
+		Visited[0] = 1;
+		Grid.SetTraversable(1, 1, true);
+
+		const int32_t DirectionX[4] = { 1, -1, 0, 0 };
+		const int32_t DirectionY[4] = { 0, 0, 1, -1 };
+		while (!Stack.empty())
+		{
+			auto [X, Y] = Stack.back();
+
+			std::pair<int32_t, int32_t> Candidates[4];
+			int32_t CandidateCount = 0;
+			for (int32_t Direction = 0; Direction < 4; Direction++)
+			{
+				int32_t NextX = X + DirectionX[Direction];
+				int32_t NextY = Y + DirectionY[Direction];
+				if (NextX >= 0 && NextY >= 0 && NextX < MazeCount && NextY < MazeCount && !Visited[NextY * MazeCount + NextX])
+				{
+					Candidates[CandidateCount++] = { NextX, NextY };
+				}
+			}
+
+			if (CandidateCount == 0)
+			{
+				Stack.pop_back();
+				continue;
+			}
+
+			auto [NextX, NextY] = Candidates[std::uniform_int_distribution<int32_t>(0, CandidateCount - 1)(Random)];
+			Visited[NextY * MazeCount + NextX] = 1;
+			Grid.SetTraversable(2 * NextX + 1, 2 * NextY + 1, true);
+			Grid.SetTraversable(X + NextX + 1, Y + NextY + 1, true);
+			Stack.push_back({ NextX, NextY });
+		}
+	}
+
+	void BuildRooms(GACore::FGridStorage& Grid, std::mt19937& Random)
+	{
+		const int32_t RoomSize = 12;
+		for (int32_t Y = 0; Y < Grid.Height; Y++)
+		{
+			for (int32_t X = 0; X < Grid.Width; X++)
+			{
+				Grid.SetTraversable(X, Y, X % RoomSize != 0 && Y % RoomSize != 0);
+			}
+		}
+
+		std::uniform_int_distribution<int32_t> DoorOffset(1, RoomSize - 3);
+		for (int32_t RoomY = 0; RoomY * RoomSize < Grid.Height; RoomY++)
+		{
+			for (int32_t RoomX = 0; RoomX * RoomSize < Grid.Width; RoomX++)
+			{
+				int32_t WallX = (RoomX + 1) * RoomSize;
+				int32_t WallY = (RoomY + 1) * RoomSize;
+				int32_t DoorY = RoomY * RoomSize + DoorOffset(Random);
+				int32_t DoorX = RoomX * RoomSize + DoorOffset(Random);
+				for (int32_t Offset = 0; Offset < 2; Offset++)
+				{
+					if (WallX < Grid.Width - 1 && DoorY + Offset < Grid.Height)
+					{
+						Grid.SetTraversable(WallX, DoorY + Offset, true);
+					}
+					if (WallY < Grid.Height - 1 && DoorX + Offset < Grid.Width)
+					{
+						Grid.SetTraversable(DoorX + Offset, WallY, true);
+					}
+				}
+			}
+		}
+	}
+
+	GACore::FGridStorage BuildGrid(int32_t Size, ELayout Layout)
+	{
+		GACore::FGridStorage Grid;
+		Grid.Reset(Size, Size);
+		std::mt19937 Random(Seed);
+
+		switch (Layout)
+		{
+		case ELayout::Open:
+		case ELayout::Random:
+		{
+			std::bernoulli_distribution Blocked(Layout == ELayout::Random ? 0.25 : 0.0);
+			for (int32_t Y = 0; Y < Size; Y++)
+			{
+				for (int32_t X = 0; X < Size; X++)
+				{
+					Grid.SetTraversable(X, Y, !Blocked(Random));
+				}
+			}
+			break;
+		}
+		case ELayout::Maze:
+			BuildMaze(Grid, Random);
+			break;
+		case ELayout::Rooms:
+			BuildRooms(Grid, Random);
+			break;
+		}
+
+		return Grid;
+	}
+
+	struct FQuery
+	{
+		int32_t StartX, StartY;
+		int32_t GoalX, GoalY;
+	};
+
+	// Pairs of cells that are connected to each other, so every path query has an answer
+	std::vector<FQuery> BuildQueries(const GACore::FGridView& Grid)
+	{
+		// Everything reachable from the traversable cell nearest the middle
+		int32_t Origin = -1;
+		for (int32_t Index = Grid.ToIndex(Grid.Width / 2, Grid.Height / 2); Index < Grid.GetCellCount() && Origin < 0; Index++)
+		{
+			Origin = Grid.IsTraversableIndex(Index) ? Index : -1;
+		}
+		if (Origin < 0)
+		{
+			return {};
+		}
+
+		std::vector<float> Distances(Grid.GetCellCount(), std::numeric_limits<float>::infinity());
+		GACore::FSearchScratch Scratch;
+		GACore::FloodDistances(Grid, Origin % Grid.Width, Origin / Grid.Width, GACore::FGridWindow::Full(Grid), Distances.data(), Scratch);
+
+		std::vector<int32_t> Connected;
+		for (int32_t Index = 0; Index < Grid.GetCellCount(); Index++)
+		{
+			if (Distances[Index] < std::numeric_limits<float>::infinity() && Grid.IsTraversableIndex(Index))
+			{
+				Connected.push_back(Index);
+			}
+		}
+
+		std::mt19937 Random(Seed);
+		std::uniform_int_distribution<size_t> Pick(0, Connected.size() - 1);
+		std::vector<FQuery> Queries;
+		for (int32_t Query = 0; Query < QueryCount; Query++)
+		{
+			int32_t Start = Connected[Pick(Random)];
+			int32_t Goal = Connected[Pick(Random)];
+			Queries.push_back({ Start % Grid.Width, Start / Grid.Width, Goal % Grid.Width, Goal / Grid.Width });
+		}
+		return Queries;
+	}
+
+	// Shared setup: one grid and query set per benchmark, built outside the timed loop
+	struct FFixture
+	{
+		GACore::FGridStorage Storage;
+		GACore::FGridView Grid;
+		std::vector<FQuery> Queries;
+
+		explicit FFixture(benchmark::State& State)
+			: Storage(BuildGrid(int32_t(State.range(0)), ELayout(State.range(1))))
+			, Grid(Storage.GetView())
+			, Queries(BuildQueries(Grid))
+		{
+			State.SetLabel(GetLayoutName(ELayout(State.range(1))));
+		}
+	};
+
+	void GridArguments(benchmark::internal::Benchmark* Benchmark)
+	{
+		Benchmark->ArgNames({ "Size", "Layout" });
+		Benchmark->ArgsProduct({ { 64, 256, 1024 }, { int64_t(ELayout::Open), int64_t(ELayout::Random), int64_t(ELayout::Maze), int64_t(ELayout::Rooms) } });
+	}
+}
+
+
+static void BM_FindPath(benchmark::State& State)
+{
+	FFixture Fixture(State);
+	GACore::FSearchScratch Scratch;
+	std::vector<int32_t> Path;
+	int64_t Nodes = 0;
+	size_t Next = 0;
+
+	for (auto _ : State)
+	{
+		const FQuery& Query = Fixture.Queries[Next++ % Fixture.Queries.size()];
+		GACore::FSearchStats Stats;
+		bool bFound = GACore::FindPath(Fixture.Grid, Query.StartX, Query.StartY, Query.GoalX, Query.GoalY, Scratch, Path, &Stats);
+		benchmark::DoNotOptimize(bFound);
+		Nodes += Stats.NodesExpanded;
+	}
+
+	State.counters["NodesPerQuery"] = benchmark::Counter(double(Nodes), benchmark::Counter::kAvgIterations);
+	State.counters["Nodes"] = benchmark::Counter(double(Nodes), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_FindPath)->Apply(GridArguments);
+
+static void BM_FloodDistances(benchmark::State& State)
+{
+	FFixture Fixture(State);
+	GACore::FSearchScratch Scratch;
+	std::vector<float> Distances(Fixture.Grid.GetCellCount());
+	size_t Next = 0;
+
+	for (auto _ : State)
+	{
+		State.PauseTiming();
+		std::fill(Distances.begin(), Distances.end(), std::numeric_limits<float>::infinity());
+		State.ResumeTiming();
+
+		const FQuery& Query = Fixture.Queries[Next++ % Fixture.Queries.size()];
+		GACore::FloodDistances(Fixture.Grid, Query.StartX, Query.StartY, GACore::FGridWindow::Full(Fixture.Grid), Distances.data(), Scratch);
+		benchmark::DoNotOptimize(Distances.data());
+	}
+}
+BENCHMARK(BM_FloodDistances)->Apply(GridArguments);
+
+// The tactical queries' usual case: a flood limited to 32 cells around the agent
+static void BM_FloodDistancesBounded(benchmark::State& State)
+{
+	FFixture Fixture(State);
+	GACore::FBucketQueue Queue;
+	const int32_t MaxDistance = 32;
+	std::vector<float> Distances;
+	std::vector<int32_t> Predecessors;
+	size_t Next = 0;
+
+	for (auto _ : State)
+	{
+		const FQuery& Query = Fixture.Queries[Next++ % Fixture.Queries.size()];
+		int32_t MinX = std::max(Query.StartX - MaxDistance, 0);
+		int32_t MinY = std::max(Query.StartY - MaxDistance, 0);
+		GACore::FGridWindow Window(MinX, MinY,
+			std::min(Query.StartX + MaxDistance, Fixture.Grid.Width - 1) - MinX + 1,
+			std::min(Query.StartY + MaxDistance, Fixture.Grid.Height - 1) - MinY + 1);
+
+		Distances.assign(Window.GetCellCount(), std::numeric_limits<float>::infinity());
+		Predecessors.resize(Window.GetCellCount());
+
+		GACore::FBoundedFloodStats Stats;
+		GACore::FloodDistancesBounded(Fixture.Grid, Query.StartX, Query.StartY, Window, MaxDistance, 0, Distances.data(), Predecessors.data(), Queue, Stats);
+		benchmark::DoNotOptimize(Stats.NodesSettled);
+	}
+}
+BENCHMARK(BM_FloodDistancesBounded)->Apply(GridArguments);
+
+static void BM_HasLineOfSight(benchmark::State& State)
+{
+	FFixture Fixture(State);
+	size_t Next = 0;
+
+	for (auto _ : State)
+	{
+		const FQuery& Query = Fixture.Queries[Next++ % Fixture.Queries.size()];
+		benchmark::DoNotOptimize(GACore::HasLineOfSight(Fixture.Grid, Query.StartX, Query.StartY, Query.GoalX, Query.GoalY));
+	}
+}
+BENCHMARK(BM_HasLineOfSight)->Apply(GridArguments);
+
+static void BM_IsSegmentClear(benchmark::State& State)
+{
+	FFixture Fixture(State);
+	size_t Next = 0;
+
+	for (auto _ : State)
+	{
+		const FQuery& Query = Fixture.Queries[Next++ % Fixture.Queries.size()];
+		benchmark::DoNotOptimize(GACore::IsSegmentClear(Fixture.Grid, Query.StartX + 0.5f, Query.StartY + 0.5f, Query.GoalX + 0.5f, Query.GoalY + 0.5f));
+	}
+}
+BENCHMARK(BM_IsSegmentClear)->Apply(GridArguments);
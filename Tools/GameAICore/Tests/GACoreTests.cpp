@@ -0,0 +1,418 @@
+// Known-answer tests for the engine-independent grid/search core. Small hand-built grids, each with the one right
+// answer worked out by hand. Run through ctest; exits non-zero if any check fails.
+
+#include "GACoreGrid.h"
+#include "GACoreLine.h"
+#include "GACoreSearch.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+
+namespace
+{
+	int32_t FailureCount = 0;
+
+	// Not assert: the default build is Release, where NDEBUG would compile the checks out
+	#define GA_CHECK(Condition) \
+		do \
+		{ \
+			if (!(Condition)) \
+			{ \
+				std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition); \
+				FailureCount++; \
+			} \
+		} while (0)
+
+	constexpr float Infinity = std::numeric_limits<float>::infinity();
+
+	// Rows top to bottom, '.' traversable and '#' blocked
+	GACore::FGridStorage MakeGrid(const std::vector<const char*>& Rows)
+	{
+		GACore::FGridStorage Grid;
+		Grid.Reset(int32_t(std::strlen(Rows[0])), int32_t(Rows.size()));
+		for (int32_t Y = 0; Y < Grid.Height; Y++)
+		{
+			for (int32_t X = 0; X < Grid.Width; X++)
+			{
+				Grid.SetTraversable(X, Y, Rows[Y][X] == '.');
+			}
+		}
+		return Grid;
+	}
+
+	void TestBlockedGoal()
+	{
+		const GACore::FGridStorage Grid = MakeGrid({
+			"...#.",
+			"...#.",
+			"...#.",
+		});
+		GACore::FSearchScratch Scratch;
+		std::vector<int32_t> Path = { 42 };
+
+		// Walled off
+		GA_CHECK(!GACore::FindPath(Grid.GetView(), 0, 0, 4, 1, Scratch, Path));
+		GA_CHECK(Path.empty());
+
+		// The goal itself blocked
+		Path = { 42 };
+		GA_CHECK(!GACore::FindPath(Grid.GetView(), 0, 0, 3, 1, Scratch, Path));
+		GA_CHECK(Path.empty());
+
+		// Out of bounds
+		GA_CHECK(!GACore::FindPath(Grid.GetView(), 0, 0, 5, 0, Scratch, Path));
+		GA_CHECK(Path.empty());
+
+		// Start is goal: found, nothing to walk
+		GA_CHECK(GACore::FindPath(Grid.GetView(), 1, 1, 1, 1, Scratch, Path));
+		GA_CHECK(Path.empty());
+	}
+
+	void TestAroundWall()
+	{
+		const GACore::FGridStorage Grid = MakeGrid({
+			"..#..",
+			"..#..",
+			".....",
+		});
+		const GACore::FGridView View = Grid.GetView();
+		GACore::FSearchScratch Scratch;
+		std::vector<int32_t> Path;
+
+		// The only shortest route is down the left side, along the bottom row and up: 8 steps
+		GA_CHECK(GACore::FindPath(View, 1, 0, 3, 0, Scratch, Path));
+		const std::vector<int32_t> Expected = {
+			View.ToIndex(1, 1), View.ToIndex(1, 2), View.ToIndex(2, 2), View.ToIndex(3, 2), View.ToIndex(3, 1), View.ToIndex(3, 0),
+		};
+		GA_CHECK(Path == Expected);
+	}
+
+	void TestEqualCostTies()
+	{
+		const GACore::FGridStorage Grid = MakeGrid({
+			"...",
+			"...",
+			"...",
+		});
+		const GACore::FGridView View = Grid.GetView();
+		GACore::FSearchScratch Scratch;
+
+		// Six shortest paths of four steps. Neighbours go +X first and ties prefer the cell further along, so the
+		// search runs along the row and then down the column, every time
+		const std::vector<int32_t> Expected = {
+			View.ToIndex(1, 0), View.ToIndex(2, 0), View.ToIndex(2, 1), View.ToIndex(2, 2),
+		};
+		for (int32_t Run = 0; Run < 3; Run++)
+		{
+			std::vector<int32_t> Path;
+			GACore::FSearchStats Stats;
+			GA_CHECK(GACore::FindPath(View, 0, 0, 2, 2, Scratch, Path, &Stats));
+			GA_CHECK(Path == Expected);
+
+			// Straight to the goal: the start, then each cell on the path
+			GA_CHECK(Stats.NodesExpanded == 5);
+		}
+	}
+
+	void TestFloodDistances()
+	{
+		const GACore::FGridStorage Grid = MakeGrid({
+			".#..",
+			".#..",
+			"....",
+		});
+		const GACore::FGridView View = Grid.GetView();
+		GACore::FSearchScratch Scratch;
+
+		const GACore::FGridWindow Window = GACore::FGridWindow::Full(View);
+		std::vector<float> Distances(Window.GetCellCount(), Infinity);
+		GA_CHECK(GACore::FloodDistances(View, 0, 0, Window, Distances.data(), Scratch));
+
+		const std::vector<float> Expected = {
+			0.0f, Infinity, 6.0f, 7.0f,
+			1.0f, Infinity, 5.0f, 6.0f,
+			2.0f, 3.0f, 4.0f, 5.0f,
+		};
+		GA_CHECK(Distances == Expected);
+
+		// A window that doesn't cover the start: nothing touched
+		const GACore::FGridWindow RightHalf(2, 0, 2, 3);
+		std::vector<float> Untouched(RightHalf.GetCellCount(), Infinity);
+		GA_CHECK(!GACore::FloodDistances(View, 0, 0, RightHalf, Untouched.data(), Scratch));
+		GA_CHECK(Untouched == std::vector<float>(RightHalf.GetCellCount(), Infinity));
+
+		// Nor one off the grid
+		GA_CHECK(!GACore::FloodDistances(View, -1, 0, Window, Untouched.data(), Scratch));
+
+		// A window is a hard edge: from inside the right half, the left column can't be reached even around the wall
+		std::vector<float> Clipped(RightHalf.GetCellCount(), Infinity);
+		GA_CHECK(GACore::FloodDistances(View, 3, 0, RightHalf, Clipped.data(), Scratch));
+		const std::vector<float> ExpectedClipped = {
+			1.0f, 0.0f,
+			2.0f, 1.0f,
+			3.0f, 2.0f,
+		};
+		GA_CHECK(Clipped == ExpectedClipped);
+	}
+
+	void TestScratchReuse()
+	{
+		// One scratch through many searches over grids of different sizes, each giving the same answer as a fresh one
+		const GACore::FGridStorage Small = MakeGrid({
+			"..#..",
+			"..#..",
+			".....",
+		});
+		const GACore::FGridStorage Large = MakeGrid({
+			"........",
+			".######.",
+			"........",
+			"........",
+		});
+
+		GACore::FSearchScratch Shared;
+		for (int32_t Run = 0; Run < 100; Run++)
+		{
+			const GACore::FGridView View = (Run % 3 == 0) ? Large.GetView() : Small.GetView();
+			const int32_t GoalX = View.Width - 1;
+
+			GACore::FSearchScratch Fresh;
+			std::vector<int32_t> Path;
+			std::vector<int32_t> FreshPath;
+			const bool bFound = GACore::FindPath(View, 0, 0, GoalX, 0, Shared, Path);
+			GA_CHECK(bFound == GACore::FindPath(View, 0, 0, GoalX, 0, Fresh, FreshPath));
+			GA_CHECK(bFound);
+			GA_CHECK(Path == FreshPath);
+
+			// Blocked goals in between mustn't leave anything behind either
+			GA_CHECK(!GACore::FindPath(View, 0, 0, 2, 1, Shared, Path));
+		}
+
+		// The search counter wrapping: stamps left over from before the wrap mustn't look like this search's visits.
+		// A search at Search == 1 stamps the whole open grid, then the counter is pushed to the last value before the wrap
+		const GACore::FGridStorage Open = MakeGrid({
+			"....",
+			"....",
+			"....",
+		});
+		const GACore::FGridView OpenView = Open.GetView();
+		GACore::FSearchScratch Wrapping;
+		std::vector<int32_t> Path;
+		std::vector<float> Distances(OpenView.GetCellCount(), Infinity);
+		GA_CHECK(GACore::FindPath(OpenView, 0, 0, 3, 2, Wrapping, Path));
+		GA_CHECK(Wrapping.Search == 1);
+
+		Wrapping.Search = std::numeric_limits<uint32_t>::max();
+		for (int32_t Run = 0; Run < 6; Run++)
+		{
+			// After the wrap, a search through the middle has to go the long way, not trust the old costs
+			GACore::FGridStorage Walled = Open;
+			Walled.SetTraversable(1, 1, false);
+			Walled.SetTraversable(2, 1, false);
+			const GACore::FGridView WalledView = Walled.GetView();
+
+			GA_CHECK(GACore::FindPath(WalledView, 1, 0, 1, 2, Wrapping, Path));
+			GA_CHECK(Path.size() == 4);
+			GA_CHECK(Path.back() == WalledView.ToIndex(1, 2));
+			GA_CHECK(Wrapping.Search != 0);
+
+			GA_CHECK(!GACore::FindPath(WalledView, 1, 0, 1, 1, Wrapping, Path));
+			GA_CHECK(Path.empty());
+		}
+		GA_CHECK(Wrapping.Search > 0 && Wrapping.Search < 16);
+
+		// And the flood, which shares the heap
+		GA_CHECK(GACore::FloodDistances(OpenView, 0, 0, GACore::FGridWindow::Full(OpenView), Distances.data(), Wrapping));
+		GA_CHECK(Distances[OpenView.ToIndex(3, 2)] == 5.0f);
+	}
+
+	// Runs FloodDistancesBounded over the whole grid into fresh buffers
+	struct FBoundedFlood
+	{
+		std::vector<float> Distances;
+		std::vector<int32_t> Predecessors;
+		GACore::FBoundedFloodStats Stats;
+	};
+
+	FBoundedFlood RunBoundedFlood(const GACore::FGridView& View, int32_t StartX, int32_t StartY, int32_t MaxDistance, int32_t MaxNodes,
+		GACore::FBucketQueue& Queue)
+	{
+		const GACore::FGridWindow Window = GACore::FGridWindow::Full(View);
+		FBoundedFlood Flood;
+		Flood.Distances.assign(Window.GetCellCount(), Infinity);
+		Flood.Predecessors.assign(Window.GetCellCount(), 42);
+		GACore::FloodDistancesBounded(View, StartX, StartY, Window, MaxDistance, MaxNodes, Flood.Distances.data(),
+			Flood.Predecessors.data(), Queue, Flood.Stats);
+		return Flood;
+	}
+
+	void TestBoundedFloodNodeLimit()
+	{
+		const GACore::FGridStorage Grid = MakeGrid({
+			"...",
+			"...",
+			"...",
+		});
+		GACore::FBucketQueue Queue;
+
+		// The center settles, then its first neighbour (+X) hits the limit. The other three neighbours were never
+		// settled, but nothing can beat 1, so they keep it. The corners the +X neighbour queued at 2 are put back
+		const FBoundedFlood Flood = RunBoundedFlood(Grid.GetView(), 1, 1, 0, 2, Queue);
+		const std::vector<float> Expected = {
+			Infinity, 1.0f, Infinity,
+			1.0f, 0.0f, 1.0f,
+			Infinity, 1.0f, Infinity,
+		};
+		GA_CHECK(Flood.Distances == Expected);
+		GA_CHECK(Flood.Stats.bHitNodeLimit);
+		GA_CHECK(Flood.Stats.NodesSettled == 2);
+
+		const std::vector<int32_t> ExpectedPredecessors = {
+			-1, 4, -1,
+			4, -1, 4,
+			-1, 4, -1,
+		};
+		GA_CHECK(Flood.Predecessors == ExpectedPredecessors);
+
+		// Same queue again, with room to finish
+		const FBoundedFlood Full = RunBoundedFlood(Grid.GetView(), 1, 1, 0, 100, Queue);
+		GA_CHECK(!Full.Stats.bHitNodeLimit);
+		GA_CHECK(Full.Stats.NodesSettled == 9);
+		GA_CHECK(Full.Distances[0] == 2.0f);
+	}
+
+	void TestBoundedFloodMaxDistance()
+	{
+		const GACore::FGridStorage Grid = MakeGrid({
+			".....",
+			".....",
+			".....",
+			".....",
+		});
+		GACore::FBucketQueue Queue;
+
+		// Nothing past two steps from the corner
+		const FBoundedFlood Flood = RunBoundedFlood(Grid.GetView(), 0, 0, 2, 0, Queue);
+		const std::vector<float> Expected = {
+			0.0f, 1.0f, 2.0f, Infinity, Infinity,
+			1.0f, 2.0f, Infinity, Infinity, Infinity,
+			2.0f, Infinity, Infinity, Infinity, Infinity,
+			Infinity, Infinity, Infinity, Infinity, Infinity,
+		};
+		GA_CHECK(Flood.Distances == Expected);
+		GA_CHECK(!Flood.Stats.bHitNodeLimit);
+		GA_CHECK(Flood.Stats.NodesSettled == 6);
+	}
+
+	void TestBoundedFloodPredecessors()
+	{
+		const GACore::FGridStorage Grid = MakeGrid({
+			".#...",
+			".#.#.",
+			"...#.",
+			"##...",
+		});
+		const GACore::FGridView View = Grid.GetView();
+		const GACore::FGridWindow Window = GACore::FGridWindow::Full(View);
+		GACore::FBucketQueue Queue;
+		GACore::FSearchScratch Scratch;
+
+		// With whole-number costs and no limits, the same distances as FloodDistances
+		std::vector<float> Reference(Window.GetCellCount(), Infinity);
+		GA_CHECK(GACore::FloodDistances(View, 0, 0, Window, Reference.data(), Scratch));
+		const FBoundedFlood Flood = RunBoundedFlood(View, 0, 0, 0, 0, Queue);
+		GA_CHECK(Flood.Distances == Reference);
+
+		// And following the predecessors back from any reached cell is a shortest path: one step per unit of distance
+		for (int32_t Index = 0; Index < Window.GetCellCount(); Index++)
+		{
+			if (Reference[Index] == Infinity)
+			{
+				GA_CHECK(Flood.Predecessors[Index] == -1);
+				continue;
+			}
+
+			int32_t Steps = 0;
+			for (int32_t Cell = Index; Flood.Predecessors[Cell] != -1 && Steps <= Window.GetCellCount(); Cell = Flood.Predecessors[Cell])
+			{
+				const int32_t Previous = Flood.Predecessors[Cell];
+				const int32_t Separation = std::abs(Cell % Window.Width - Previous % Window.Width) + std::abs(Cell / Window.Width - Previous / Window.Width);
+				GA_CHECK(Separation == 1);
+				GA_CHECK(Reference[Previous] == Reference[Cell] - 1.0f);
+				Steps++;
+			}
+			GA_CHECK(float(Steps) == Reference[Index]);
+		}
+
+		// By hand: down the left column, right along row 2, up column 2 to the top right; or round the bottom
+		GA_CHECK(Flood.Distances[View.ToIndex(4, 0)] == 8.0f);
+		GA_CHECK(Flood.Distances[View.ToIndex(4, 2)] == 8.0f);
+		GA_CHECK(Flood.Distances[View.ToIndex(4, 1)] == 9.0f);
+	}
+
+	void TestBoundedFloodRounding()
+	{
+		// Overlay costs of 0.4 and 2.4: steps of 1.4 and 3.4 for Dijkstra, rounded to 1 and 3 for the buckets
+		GACore::FGridStorage Grid = MakeGrid({
+			"....",
+		});
+		Grid.ExtraCosts.assign(4, 0.0f);
+		Grid.ExtraCosts[1] = 0.4f;
+		Grid.ExtraCosts[2] = 2.4f;
+		const GACore::FGridView View = Grid.GetView();
+		GACore::FBucketQueue Queue;
+		GACore::FSearchScratch Scratch;
+
+		const FBoundedFlood Flood = RunBoundedFlood(View, 0, 0, 0, 0, Queue);
+		const std::vector<float> Expected = { 0.0f, 1.0f, 4.0f, 5.0f };
+		GA_CHECK(Flood.Distances == Expected);
+
+		std::vector<float> Reference(4, Infinity);
+		GA_CHECK(GACore::FloodDistances(View, 0, 0, GACore::FGridWindow::Full(View), Reference.data(), Scratch));
+		GA_CHECK(std::abs(Reference[1] - 1.4f) < 1e-4f);
+		GA_CHECK(std::abs(Reference[3] - 5.8f) < 1e-4f);
+	}
+
+	void TestLineOfSight()
+	{
+		const GACore::FGridStorage Grid = MakeGrid({
+			".....",
+			"..#..",
+			".....",
+		});
+		const GACore::FGridView View = Grid.GetView();
+
+		GA_CHECK(GACore::HasLineOfSight(View, 0, 0, 4, 0));
+		GA_CHECK(!GACore::HasLineOfSight(View, 0, 1, 4, 1));
+		GA_CHECK(!GACore::HasLineOfSight(View, 2, 0, 2, 2));
+		GA_CHECK(GACore::HasLineOfSight(View, 0, 2, 4, 2));
+	}
+}
+
+
+int main()
+{
+	TestBlockedGoal();
+	TestAroundWall();
+	TestEqualCostTies();
+	TestFloodDistances();
+	TestScratchReuse();
+	TestBoundedFloodNodeLimit();
+	TestBoundedFloodMaxDistance();
+	TestBoundedFloodPredecessors();
+	TestBoundedFloodRounding();
+	TestLineOfSight();
+
+	if (FailureCount > 0)
+	{
+		std::fprintf(stderr, "%d check(s) failed\n", int(FailureCount));
+		return 1;
+	}
+	std::printf("All checks passed\n");
+	return 0;
+}